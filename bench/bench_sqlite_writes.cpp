@@ -0,0 +1,186 @@
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <QByteArray>
+#include <QFileInfo>
+#include <QString>
+#include <QTemporaryDir>
+
+#include "model_common.h"
+#include "sqlite_wrapper.h"
+#include "util_enum.h"
+
+// Writes a synthetic download through SqliteDatastoreWrapper with the settings that earlier versions used and the current ones, with and without value compression
+// Usage: bench_sqlite_writes [entry_count] [per_row_commit_entry_count]
+
+static constexpr size_t DEFAULT_ENTRY_COUNT = 1000000;
+// Committing every row waits for the disk each time, so the slow configurations only write part of the dump
+static constexpr size_t DEFAULT_PER_ROW_COMMIT_ENTRY_COUNT = 20000;
+// Entries are enumerated and downloaded in pages of this size, so the pending table stays as small as during a pipelined download
+static constexpr size_t PAGE_SIZE = 2048;
+
+static constexpr long long UNIVERSE_ID = 1234567;
+
+class BenchConfig
+{
+public:
+	const char* name;
+	SqliteDurability durability;
+	SqliteValueCodec value_codec;
+	bool group_commit;
+	bool statement_cache;
+};
+
+class BenchResult
+{
+public:
+	size_t entry_count = 0;
+	double seconds = 0.0;
+	long long file_bytes = 0;
+};
+
+static QString make_key_name(const size_t index)
+{
+	return QString{ "Player_%1" }.arg(index);
+}
+
+// Player save data of a few hundred bytes, structured like most real datastores so compression ratios are representative
+static QByteArray make_value(const size_t index)
+{
+	std::string value = "{\"coins\":" + std::to_string((index * 7919) % 100000);
+	value += ",\"level\":" + std::to_string(index % 97);
+	value += ",\"xp\":" + std::to_string((index * 104729) % 1000000);
+	value += ",\"inventory\":[";
+	for (size_t i = 0; i < 8; i++)
+	{
+		if (i > 0)
+		{
+			value += ",";
+		}
+		value += "{\"id\":\"item_" + std::to_string((index + i * 31) % 500) + "\",\"count\":" + std::to_string((index + i) % 20) + "}";
+	}
+	value += "],\"settings\":{\"music\":true,\"sfx\":false,\"quality\":\"high\"}}";
+	return QByteArray::fromStdString(value);
+}
+
+static std::optional<BenchResult> run_config(const BenchConfig& config, const size_t entry_count)
+{
+	QTemporaryDir temp_dir;
+	if (temp_dir.isValid() == false)
+	{
+		return std::nullopt;
+	}
+	const QString file_path = temp_dir.filePath("bench.sqlite3");
+
+	std::unique_ptr<SqliteDatastoreWrapper> db_wrapper = SqliteDatastoreWrapper::new_from_path(file_path.toStdString(), config.durability, config.value_codec);
+	if (db_wrapper == nullptr)
+	{
+		return std::nullopt;
+	}
+	if (config.group_commit == false)
+	{
+		db_wrapper->set_group_commit_limits(1, std::chrono::milliseconds{ 0 });
+	}
+	db_wrapper->set_statement_cache_enabled(config.statement_cache);
+
+	const QString datastore_name = "PlayerData";
+	const QString scope = "global";
+
+	const auto started = std::chrono::steady_clock::now();
+	for (size_t page_start = 0; page_start < entry_count; page_start += PAGE_SIZE)
+	{
+		const size_t page_end = std::min(entry_count, page_start + PAGE_SIZE);
+		for (size_t i = page_start; i < page_end; i++)
+		{
+			db_wrapper->write_pending(StandardDatastoreEntryName{ UNIVERSE_ID, datastore_name, make_key_name(i), scope });
+			db_wrapper->resume_point();
+		}
+		for (size_t i = page_start; i < page_end; i++)
+		{
+			const StandardDatastoreEntryFull details{ UNIVERSE_ID, datastore_name, scope, make_key_name(i), "08DA0000000000000.0000000001.08DA0000000000000.01", std::nullopt, std::nullopt, make_value(i) };
+			db_wrapper->write_details(details);
+			db_wrapper->delete_pending(details);
+			db_wrapper->resume_point();
+		}
+	}
+	db_wrapper->checkpoint();
+	db_wrapper.reset();
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - started;
+
+	BenchResult result;
+	result.entry_count = entry_count;
+	result.seconds = elapsed.count();
+	result.file_bytes = QFileInfo{ file_path }.size();
+	return result;
+}
+
+int main(int argc, char** argv)
+{
+	const size_t entry_count = argc > 1 ? static_cast<size_t>(std::strtoull(argv[1], nullptr, 10)) : DEFAULT_ENTRY_COUNT;
+	const size_t per_row_commit_entry_count = std::min(entry_count, argc > 2 ? static_cast<size_t>(std::strtoull(argv[2], nullptr, 10)) : DEFAULT_PER_ROW_COMMIT_ENTRY_COUNT);
+
+	const std::vector<BenchConfig> configs{
+		// Before grouped commits and cached statements
+		BenchConfig{ "commit per row, no statement cache, safe", SqliteDurability::Safe, SqliteValueCodec::None, false, false },
+		BenchConfig{ "commit per row, statement cache, safe", SqliteDurability::Safe, SqliteValueCodec::None, false, true },
+		BenchConfig{ "grouped commits, no statement cache, safe", SqliteDurability::Safe, SqliteValueCodec::None, true, false },
+		BenchConfig{ "grouped commits, statement cache, safe", SqliteDurability::Safe, SqliteValueCodec::None, true, true },
+		BenchConfig{ "grouped commits, statement cache, fast", SqliteDurability::Fast, SqliteValueCodec::None, true, true },
+		BenchConfig{ "grouped commits, statement cache, bulk", SqliteDurability::Bulk, SqliteValueCodec::None, true, true },
+		// Value compression, compared against the uncompressed run with the same settings
+		BenchConfig{ "grouped commits, statement cache, safe, qcompress", SqliteDurability::Safe, SqliteValueCodec::QCompress, true, true },
+		BenchConfig{ "grouped commits, statement cache, bulk, qcompress", SqliteDurability::Bulk, SqliteValueCodec::QCompress, true, true },
+	};
+
+	std::printf("%-52s %10s %10s %12s %12s\n", "configuration", "entries", "seconds", "entries/s", "file MiB");
+	std::vector<std::pair<BenchConfig, BenchResult>> results;
+	for (const BenchConfig& this_config : configs)
+	{
+		const size_t this_entry_count = this_config.group_commit ? entry_count : per_row_commit_entry_count;
+		const std::optional<BenchResult> result = run_config(this_config, this_entry_count);
+		if (result.has_value() == false)
+		{
+			std::printf("%-52s failed to create database\n", this_config.name);
+			return 1;
+		}
+		const double entries_per_second = result->seconds > 0.0 ? static_cast<double>(result->entry_count) / result->seconds : 0.0;
+		const double file_mib = static_cast<double>(result->file_bytes) / (1024.0 * 1024.0);
+		std::printf("%-52s %10zu %10.2f %12.0f %12.1f\n", this_config.name, result->entry_count, result->seconds, entries_per_second, file_mib);
+		std::fflush(stdout);
+		results.emplace_back(this_config, *result);
+	}
+
+	std::printf("\n");
+	for (const std::pair<BenchConfig, BenchResult>& this_pair : results)
+	{
+		const BenchConfig& this_config = this_pair.first;
+		const BenchResult& this_result = this_pair.second;
+		if (this_config.value_codec == SqliteValueCodec::None)
+		{
+			continue;
+		}
+		const auto is_uncompressed_match = [&this_config](const std::pair<BenchConfig, BenchResult>& other) {
+			return other.first.value_codec == SqliteValueCodec::None &&
+				other.first.durability == this_config.durability &&
+				other.first.group_commit == this_config.group_commit &&
+				other.first.statement_cache == this_config.statement_cache;
+		};
+		const auto uncompressed_it = std::find_if(results.begin(), results.end(), is_uncompressed_match);
+		if (uncompressed_it != results.end() && uncompressed_it->second.file_bytes > 0 && this_result.seconds > 0.0)
+		{
+			const double size_ratio = static_cast<double>(this_result.file_bytes) / static_cast<double>(uncompressed_it->second.file_bytes);
+			const double rate_ratio = uncompressed_it->second.seconds / this_result.seconds;
+			std::printf("%-52s file size %.2fx, write rate %.2fx of %s\n", this_config.name, size_ratio, rate_ratio, uncompressed_it->first.name);
+		}
+	}
+	return 0;
+}
@@ -13,14 +13,23 @@
 #include <QUuid>
 #include <QVariant>
 
+#include <algorithm>
+#include <chrono>
 #include <memory>
+#include <random>
 
 #include "http_req_builder.h"
+#include "http_response.h"
 #include "http_wrangler.h"
 #include "model_api_opencloud.h"
-#include "roblox_time.h"
 #include "util_enum.h"
 
+static constexpr size_t MAX_SERVER_ERROR_RETRIES = 10;
+static constexpr int SERVER_ERROR_DELAY_BASE = 500;
+static constexpr int SERVER_ERROR_DELAY_CAP = 30000;
+
+static std::default_random_engine backoff_engine{ std::random_device{}() };
+
 DataRequestBody::DataRequestBody()
 {
 	md5 = QCryptographicHash::hash("", QCryptographicHash::Algorithm::Md5).toBase64();
@@ -44,10 +53,10 @@ void DataRequest::send_request(const std::optional<QString>& cursor)
 		return;
 	}
 
-	if (pending_reply)
+	if (pending_ticket)
 	{
-		pending_reply->deleteLater();
-		pending_reply = nullptr;
+		HttpWrangler::get()->cancel(*pending_ticket, false);
+		pending_ticket = std::nullopt;
 	}
 	if (pending_request)
 	{
@@ -56,11 +65,8 @@ void DataRequest::send_request(const std::optional<QString>& cursor)
 
 	pending_request_cursor = cursor;
 	pending_request = build_request(cursor);
-	pending_reply = HttpWrangler::get()->send(request_type, *pending_request, req_body.get_data());
-
-	connect(pending_reply, &QNetworkReply::finished, this, &DataRequest::handle_reply_ready);
-
-	timeout_begin();
+	send_count = 0;
+	dispatch_pending_request();
 
 	status = DataRequestStatus::Waiting;
 
@@ -71,6 +77,8 @@ void DataRequest::force_retry()
 {
 	if (status == DataRequestStatus::Error && pending_request)
 	{
+		server_error_count = 0;
+		server_error_delay = 0;
 		status = DataRequestStatus::Waiting;
 		send_request(pending_request_cursor);
 	}
@@ -81,10 +89,18 @@ DataRequest::DataRequest(const QString& api_key) : QObject{ nullptr }, status{ D
 
 }
 
-void DataRequest::handle_http_404(const QString& body, const QList<QNetworkReply::RawHeaderPair>&)
+DataRequest::~DataRequest()
+{
+	if (pending_ticket)
+	{
+		HttpWrangler::get()->cancel(*pending_ticket, false);
+	}
+}
+
+void DataRequest::handle_http_404(const QByteArray& body, const QList<QNetworkReply::RawHeaderPair>&)
 {
 	do_error("Received HTTP 404, aborting");
-	emit status_info(body);
+	emit status_info(QString::fromUtf8(body));
 }
 
 QString DataRequest::get_send_message() const
@@ -92,9 +108,10 @@ QString DataRequest::get_send_message() const
 	return QString{ "Sending request..." };
 }
 
-void DataRequest::handle_reply_ready()
+void DataRequest::handle_response(const HttpResponse& response)
 {
 	timeout_end();
+	pending_ticket = std::nullopt;
 
 	if (status != DataRequestStatus::Waiting)
 	{
@@ -102,17 +119,30 @@ void DataRequest::handle_reply_ready()
 		return;
 	}
 
-	QNetworkReply::NetworkError error = pending_reply->error();
-	QString http_status = pending_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toString();
-	QString reply_body = pending_reply->readAll();
-	QList<QNetworkReply::RawHeaderPair> headers = pending_reply->rawHeaderPairs();
-	RobloxTime::update_time_from_headers(headers);
+	if (response.http2_failed)
+	{
+		emit status_info("HTTP/2 protocol error, falling back to HTTP/1.1");
+		resend();
+		return;
+	}
+
+	const QString& http_status = response.http_status;
+	// Kept as utf-8 bytes, entry data can be several megabytes and is only decoded if something needs it as text
+	const QByteArray& reply_body = response.body;
+	const QList<QNetworkReply::RawHeaderPair>& headers = response.headers;
 
-	// Prevent timeout from firing
-	pending_reply->disconnect(this);
+	const bool server_failure = http_status == "" || http_status == "500" || http_status == "502" || http_status == "504";
+	if (server_failure == false)
+	{
+		server_error_count = 0;
+		server_error_delay = 0;
+	}
 
-	pending_reply->deleteLater();
-	pending_reply = nullptr;
+	if (http_status != "" && http_status != "429")
+	{
+		const auto latency = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - pending_reply_sent);
+		emit received_reply(static_cast<qint64>(latency.count()));
+	}
 
 	if (http_status == "200") // OK -- NOLINTNEXTLINE(bugprone-branch-clone)
 	{
@@ -128,40 +158,50 @@ void DataRequest::handle_reply_ready()
 	}
 	else if (http_status == "429") // Too many requests
 	{
-		emit status_info(QString{ "Received HTTP 429, briefly pausing..." });
 		emit received_http_429();
 
-		QTimer* timer = new QTimer(this);
-		timer->setSingleShot(true);
-		connect(timer, &QTimer::timeout, this, &DataRequest::resend);
-		timer->start(get_next_429_delay());
+		if (response.rate_limit_wait)
+		{
+			// The wrangler has already paused the shared budget, the resend goes out as soon as the server allows
+			emit status_info(QString{ "Received HTTP 429, waiting %1s as requested by server..." }.arg(static_cast<double>(response.rate_limit_wait->count()) / 1000.0, 0, 'f', 1));
+			resend();
+		}
+		else
+		{
+			emit status_info(QString{ "Received HTTP 429, briefly pausing..." });
+
+			QTimer* timer = new QTimer(this);
+			timer->setSingleShot(true);
+			connect(timer, &QTimer::timeout, this, &DataRequest::resend);
+			timer->start(get_next_429_delay());
+		}
 	}
 	else if (http_status == "500") // Internal server error
 	{
-		emit status_info(QString{ "Received HTTP 500 Internal Server Error, retrying..." });
-		resend();
+		emit status_info(QString{ "Received HTTP 500 Internal Server Error" });
+		resend_after_backoff();
 	}
 	else if (http_status == "502") // Bad gateway
 	{
-		emit status_info(QString{ "Received HTTP 502 Bad Gateway, retrying..." });
-		resend();
+		emit status_info(QString{ "Received HTTP 502 Bad Gateway" });
+		resend_after_backoff();
 	}
 	else if (http_status == "504") // Gateway timeout
 	{
-		emit status_info(QString{ "Received HTTP 504 Gateway Timeout, retrying..." });
-		resend();
+		emit status_info(QString{ "Received HTTP 504 Gateway Timeout" });
+		resend_after_backoff();
 	}
 	else if (http_status == "")
 	{
 		QMetaEnum meta_enum = QMetaEnum::fromType<QNetworkReply::NetworkError>();
-		do_error( QString{ "Network error %1, aborting" }.arg( meta_enum.valueToKey( static_cast<int>(error) ) ) );
+		do_error( QString{ "Network error %1, aborting" }.arg( meta_enum.valueToKey( static_cast<int>(response.error) ) ) );
 	}
 	else
 	{
 		do_error(QString{ "Received HTTP %1, aborting" }.arg(http_status));
-		if (reply_body != "")
+		if (reply_body.isEmpty() == false)
 		{
-			emit status_info(reply_body);
+			emit status_info(QString::fromUtf8(reply_body));
 		}
 	}
 }
@@ -170,12 +210,14 @@ void DataRequest::handle_timeout()
 {
 	timeout_end();
 
-	pending_reply->disconnect(this);
-	pending_reply->deleteLater();
-	pending_reply = nullptr;
+	if (pending_ticket)
+	{
+		HttpWrangler::get()->cancel(*pending_ticket, true);
+		pending_ticket = std::nullopt;
+	}
 
-	emit status_info(QString{ "Request timed out, retrying..." });
-	resend();
+	emit status_info(QString{ "Request timed out" });
+	resend_after_backoff();
 }
 
 void DataRequest::resend()
@@ -183,12 +225,57 @@ void DataRequest::resend()
 	if (pending_request)
 	{
 		emit status_info("Resending...");
-		pending_reply = HttpWrangler::get()->send(request_type, *pending_request, req_body.get_data());
-		connect(pending_reply, &QNetworkReply::finished, this, &DataRequest::handle_reply_ready);
-		timeout_begin();
+		dispatch_pending_request();
 	}
 }
 
+void DataRequest::resend_after_backoff()
+{
+	server_error_count++;
+	if (server_error_count > MAX_SERVER_ERROR_RETRIES)
+	{
+		do_error(QString{ "Request failed %1 times in a row, aborting" }.arg(server_error_count));
+		return;
+	}
+
+	const int delay = get_next_server_error_delay();
+	emit status_info(QString{ "Retrying in %1s..." }.arg(static_cast<double>(delay) / 1000.0, 0, 'f', 1));
+
+	QTimer* timer = new QTimer(this);
+	timer->setSingleShot(true);
+	connect(timer, &QTimer::timeout, this, &DataRequest::resend);
+	connect(timer, &QTimer::timeout, timer, &QTimer::deleteLater);
+	timer->start(delay);
+}
+
+void DataRequest::dispatch_pending_request()
+{
+	HttpSendOptions options;
+	options.allow_http2 = allow_http2;
+	options.use_cache = use_response_cache;
+	options.operation = operation;
+	if (options.operation.isEmpty())
+	{
+		options.operation = get_title_string();
+		if (options.operation.endsWith("..."))
+		{
+			options.operation.chop(3);
+		}
+	}
+	options.retry_count = send_count;
+	send_count++;
+
+	const auto on_sent = [this]() {
+		pending_reply_sent = std::chrono::steady_clock::now();
+		// The timeout only covers time on the wire, not time spent waiting for a rate limit token
+		timeout_begin();
+	};
+	const auto on_finished = [this](const HttpResponse& response) {
+		handle_response(response);
+	};
+	pending_ticket = HttpWrangler::get()->submit(request_type, *pending_request, req_body.get_data(), options, this, on_sent, on_finished);
+}
+
 void DataRequest::timeout_begin()
 {
 	timeout_end();
@@ -227,6 +314,16 @@ int DataRequest::get_next_429_delay()
 	}
 }
 
+int DataRequest::get_next_server_error_delay()
+{
+	// Decorrelated jitter, each delay is random between the base and three times the previous delay
+	const int previous_delay = std::max(server_error_delay, SERVER_ERROR_DELAY_BASE);
+	const int upper_bound = std::min(SERVER_ERROR_DELAY_CAP, previous_delay * 3);
+	std::uniform_int_distribution<int> dist{ SERVER_ERROR_DELAY_BASE, std::max(upper_bound, SERVER_ERROR_DELAY_BASE) };
+	server_error_delay = dist(backoff_engine);
+	return server_error_delay;
+}
+
 void DataRequest::do_error(const QString& message)
 {
 	status = DataRequestStatus::Error;
@@ -261,7 +358,7 @@ QNetworkRequest MemoryStoreSortedMapGetListRequest::build_request(std::optional<
 	return HttpRequestBuilder::memory_store_v2_sorted_map_get_list(api_key, universe_id, map_name, ascending, cursor);
 }
 
-void MemoryStoreSortedMapGetListRequest::handle_http_200(const QString& body, const QList<QNetworkReply::RawHeaderPair>&)
+void MemoryStoreSortedMapGetListRequest::handle_http_200(const QByteArray& body, const QList<QNetworkReply::RawHeaderPair>&)
 {
 	if (const std::optional<GetMemoryStoreSortedMapItemListResponse> response = GetMemoryStoreSortedMapItemListResponse::from_json(universe_id, map_name, body))
 	{
@@ -315,7 +412,7 @@ QNetworkRequest MessagingServicePostMessageV2Request::build_request(std::optiona
 	return HttpRequestBuilder::messaging_service_v2_post_message(api_key, universe_id);
 }
 
-void MessagingServicePostMessageV2Request::handle_http_200(const QString&, const QList<QNetworkReply::RawHeaderPair>&)
+void MessagingServicePostMessageV2Request::handle_http_200(const QByteArray&, const QList<QNetworkReply::RawHeaderPair>&)
 {
 	do_success("Message sent");
 }
@@ -341,7 +438,7 @@ QNetworkRequest OrderedDatastoreEntryDeleteV2Request::build_request(std::optiona
 	return HttpRequestBuilder::ordered_datastore_v2_entry_delete(api_key, universe_id, datastore_name, scope, entry_id);
 }
 
-void OrderedDatastoreEntryDeleteV2Request::handle_http_200(const QString&, const QList<QNetworkReply::RawHeaderPair>&)
+void OrderedDatastoreEntryDeleteV2Request::handle_http_200(const QByteArray&, const QList<QNetworkReply::RawHeaderPair>&)
 {
 	do_success();
 }
@@ -379,7 +476,7 @@ QNetworkRequest OrderedDatastoreEntryGetDetailsV2Request::build_request(std::opt
 	return HttpRequestBuilder::ordered_datastore_v2_entry_get_details(api_key, universe_id, datastore_name, scope, entry_id);
 }
 
-void OrderedDatastoreEntryGetDetailsV2Request::handle_http_200(const QString& body, const QList<QNetworkReply::RawHeaderPair>&)
+void OrderedDatastoreEntryGetDetailsV2Request::handle_http_200(const QByteArray& body, const QList<QNetworkReply::RawHeaderPair>&)
 {
 	std::optional<GetOrderedDatastoreEntryDetailsV2Response> response = GetOrderedDatastoreEntryDetailsV2Response::from_json(universe_id, datastore_name, scope, entry_id, body);
 	if (response)
@@ -421,7 +518,7 @@ QNetworkRequest OrderedDatastoreEntryGetListV2Request::build_request(std::option
 	return HttpRequestBuilder::ordered_datastore_v2_entry_get_list(api_key, universe_id, datastore_name, scope, ascending, cursor);
 }
 
-void OrderedDatastoreEntryGetListV2Request::handle_http_200(const QString& body, const QList<QNetworkReply::RawHeaderPair>&)
+void OrderedDatastoreEntryGetListV2Request::handle_http_200(const QByteArray& body, const QList<QNetworkReply::RawHeaderPair>&)
 {
 	if (const std::optional<GetOrderedDatastoreEntryListV2Response> response = GetOrderedDatastoreEntryListV2Response::from_json(universe_id, datastore_name, scope, body))
 	{
@@ -472,7 +569,7 @@ QNetworkRequest OrderedDatastoreEntryPostCreateV2Request::build_request(std::opt
 	return HttpRequestBuilder::ordered_datastore_v2_entry_post_create(api_key, universe_id, datastore_name, scope, entry_id, req_body.get_md5());
 }
 
-void OrderedDatastoreEntryPostCreateV2Request::handle_http_200(const QString&, const QList<QNetworkReply::RawHeaderPair>&)
+void OrderedDatastoreEntryPostCreateV2Request::handle_http_200(const QByteArray&, const QList<QNetworkReply::RawHeaderPair>&)
 {
 	do_success();
 }
@@ -502,7 +599,7 @@ QNetworkRequest OrderedDatastoreEntryPatchUpdateV2Request::build_request(std::op
 	return HttpRequestBuilder::ordered_datastore_v2_entry_patch_update(api_key, universe_id, datastore_name, scope, entry_id, req_body.get_md5());
 }
 
-void OrderedDatastoreEntryPatchUpdateV2Request::handle_http_200(const QString&, const QList<QNetworkReply::RawHeaderPair>&)
+void OrderedDatastoreEntryPatchUpdateV2Request::handle_http_200(const QByteArray&, const QList<QNetworkReply::RawHeaderPair>&)
 {
 	do_success();
 }
@@ -532,7 +629,7 @@ QNetworkRequest OrderedDatastorePostIncrementV2Request::build_request(std::optio
 	return HttpRequestBuilder::ordered_datastore_v2_entry_post_increment(api_key, universe_id, datastore_name, scope, entry_id, req_body.get_md5());
 }
 
-void OrderedDatastorePostIncrementV2Request::handle_http_200(const QString&, const QList<QNetworkReply::RawHeaderPair>&)
+void OrderedDatastorePostIncrementV2Request::handle_http_200(const QByteArray&, const QList<QNetworkReply::RawHeaderPair>&)
 {
 	do_success();
 }
@@ -570,13 +667,13 @@ QNetworkRequest StandardDatastoreEntryDeleteRequest::build_request(std::optional
 	return HttpRequestBuilder::standard_datastore_entry_delete(api_key, universe_id, datastore_name, scope, key_name);
 }
 
-void StandardDatastoreEntryDeleteRequest::handle_http_200(const QString&, const QList<QNetworkReply::RawHeaderPair>&)
+void StandardDatastoreEntryDeleteRequest::handle_http_200(const QByteArray&, const QList<QNetworkReply::RawHeaderPair>&)
 {
 	delete_success = true;
 	do_success();
 }
 
-void StandardDatastoreEntryDeleteRequest::handle_http_404(const QString&, const QList<QNetworkReply::RawHeaderPair>&)
+void StandardDatastoreEntryDeleteRequest::handle_http_404(const QByteArray&, const QList<QNetworkReply::RawHeaderPair>&)
 {
 	delete_success = false;
 	do_success("Entry already deleted");
@@ -615,7 +712,7 @@ QNetworkRequest StandardDatastoreEntryGetDetailsRequest::build_request(std::opti
 	return HttpRequestBuilder::standard_datastore_entry_get_details(api_key, universe_id, datastore_name, scope, key_name);
 }
 
-void StandardDatastoreEntryGetDetailsRequest::handle_http_200(const QString& body, const QList<QNetworkReply::RawHeaderPair>& headers)
+void StandardDatastoreEntryGetDetailsRequest::handle_http_200(const QByteArray& body, const QList<QNetworkReply::RawHeaderPair>& headers)
 {
 	std::optional<QString> version;
 	std::optional<QString> userids;
@@ -657,7 +754,7 @@ void StandardDatastoreEntryGetDetailsRequest::handle_http_200(const QString& bod
 	do_success();
 }
 
-void StandardDatastoreEntryGetDetailsRequest::handle_http_404(const QString&, const QList<QNetworkReply::RawHeaderPair>&)
+void StandardDatastoreEntryGetDetailsRequest::handle_http_404(const QByteArray&, const QList<QNetworkReply::RawHeaderPair>&)
 {
 	details = std::nullopt;
 
@@ -697,6 +794,11 @@ void StandardDatastoreEntryGetListRequest::set_result_limit(const size_t limit)
 	result_limit = limit;
 }
 
+void StandardDatastoreEntryGetListRequest::set_keep_entries(const bool keep)
+{
+	keep_entries = keep;
+}
+
 QNetworkRequest StandardDatastoreEntryGetListRequest::build_request(std::optional<QString> cursor) const
 {
 	QNetworkRequest request;
@@ -711,25 +813,29 @@ QNetworkRequest StandardDatastoreEntryGetListRequest::build_request(std::optiona
 	return request;
 }
 
-void StandardDatastoreEntryGetListRequest::handle_http_200(const QString& body, const QList<QNetworkReply::RawHeaderPair>&)
+void StandardDatastoreEntryGetListRequest::handle_http_200(const QByteArray& body, const QList<QNetworkReply::RawHeaderPair>&)
 {
 	std::optional<GetStandardDatastoreEntryListResponse> response = GetStandardDatastoreEntryListResponse::from_json(body, universe_id, datastore_name);
 	if (response)
 	{
 		for (const StandardDatastoreEntryName& this_entry : response->get_entries())
 		{
-			if (result_limit && datastore_entries.size() >= *result_limit)
+			if (result_limit && entry_count >= *result_limit)
 			{
 				// Limit has been hit
 				break;
 			}
-			datastore_entries.push_back(this_entry);
+			entry_count++;
+			if (keep_entries)
+			{
+				datastore_entries.push_back(this_entry);
+			}
 			emit entry_found(this_entry);
 		}
 
-		emit status_info(QString{ "Received %1 entries, %2 total" }.arg(QString::number(response->get_entries().size()), QString::number(datastore_entries.size())));
+		emit status_info(QString{ "Received %1 entries, %2 total" }.arg(QString::number(response->get_entries().size()), QString::number(entry_count)));
 
-		const bool limit_reached = result_limit && datastore_entries.size() >= *result_limit;
+		const bool limit_reached = result_limit && entry_count >= *result_limit;
 
 		std::optional<QString> cursor{ response->get_cursor() };
 		if (cursor && cursor->size() > 0 && !limit_reached)
@@ -772,12 +878,17 @@ QString StandardDatastoreEntryGetVersionListRequest::get_title_string() const
 	return "Fetching datastore entry versions...";
 }
 
+void StandardDatastoreEntryGetVersionListRequest::set_stop_at_live_version(const bool stop)
+{
+	stop_at_live_version = stop;
+}
+
 QNetworkRequest StandardDatastoreEntryGetVersionListRequest::build_request(std::optional<QString> cursor) const
 {
 	return HttpRequestBuilder::standard_datastore_entry_version_get_list(api_key, universe_id, datastore_name, scope, key_name, cursor);
 }
 
-void StandardDatastoreEntryGetVersionListRequest::handle_http_200(const QString& body, const QList<QNetworkReply::RawHeaderPair>&)
+void StandardDatastoreEntryGetVersionListRequest::handle_http_200(const QByteArray& body, const QList<QNetworkReply::RawHeaderPair>&)
 {
 	std::optional<GetStandardDatastoreEntryVersionListResponse> response = GetStandardDatastoreEntryVersionListResponse::from(body);
 	if (response)
@@ -785,12 +896,18 @@ void StandardDatastoreEntryGetVersionListRequest::handle_http_200(const QString&
 		for (const StandardDatastoreEntryVersion& this_version : response->get_versions())
 		{
 			versions.push_back(this_version);
+			if (this_version.get_deleted() == false)
+			{
+				live_version_found = true;
+			}
 		}
 
 		emit status_info(QString{ "Received %1 entries, %2 total" }.arg(QString::number(response->get_versions().size()), QString::number(versions.size())));
 
+		const bool limit_reached = stop_at_live_version && live_version_found;
+
 		std::optional<QString> cursor{ response->get_cursor() };
-		if (cursor && cursor->size() > 0)
+		if (cursor && cursor->size() > 0 && !limit_reached)
 		{
 			send_request(cursor);
 		}
@@ -842,7 +959,7 @@ QNetworkRequest StandardDatastoreEntryPostSetRequest::build_request(std::optiona
 	return HttpRequestBuilder::standard_datastore_entry_post(api_key, universe_id, datastore_name, scope, key_name, req_body.get_md5(), userids, attributes);
 }
 
-void StandardDatastoreEntryPostSetRequest::handle_http_200(const QString&, const QList<QNetworkReply::RawHeaderPair>&)
+void StandardDatastoreEntryPostSetRequest::handle_http_200(const QByteArray&, const QList<QNetworkReply::RawHeaderPair>&)
 {
 	do_success();
 }
@@ -867,7 +984,7 @@ QNetworkRequest StandardDatastoreGetListRequest::build_request(std::optional<QSt
 	return HttpRequestBuilder::standard_datastore_get_list(api_key, universe_id, cursor);
 }
 
-void StandardDatastoreGetListRequest::handle_http_200(const QString& body, const QList<QNetworkReply::RawHeaderPair>&)
+void StandardDatastoreGetListRequest::handle_http_200(const QByteArray& body, const QList<QNetworkReply::RawHeaderPair>&)
 {
 	std::optional<GetStandardDatastoreListResponse> response = GetStandardDatastoreListResponse::from_json(body);
 	if (response)
@@ -912,7 +1029,7 @@ QNetworkRequest StandardDatastorePostSnapshotRequest::build_request(std::optiona
 	return HttpRequestBuilder::standard_datastore_v2_snapshot(api_key, universe_id);
 }
 
-void StandardDatastorePostSnapshotRequest::handle_http_200(const QString& body, const QList<QNetworkReply::RawHeaderPair>&)
+void StandardDatastorePostSnapshotRequest::handle_http_200(const QByteArray& body, const QList<QNetworkReply::RawHeaderPair>&)
 {
 	const std::optional<PostStandardDatastoreSnapshotResponseV2> response = PostStandardDatastoreSnapshotResponseV2::from(body);
 	if (response)
@@ -939,7 +1056,7 @@ QNetworkRequest UniverseGetDetailsRequest::build_request(std::optional<QString>)
 	return HttpRequestBuilder::universe_v2_get_details(api_key, universe_id);
 }
 
-void UniverseGetDetailsRequest::handle_http_200(const QString& body, const QList<QNetworkReply::RawHeaderPair>&)
+void UniverseGetDetailsRequest::handle_http_200(const QByteArray& body, const QList<QNetworkReply::RawHeaderPair>&)
 {
 	const std::optional<GetUniverseDetailsResponse> response = GetUniverseDetailsResponse::from(body);
 	if (response)
@@ -965,7 +1082,7 @@ QNetworkRequest UserRestrictionGetListV2Request::build_request(const std::option
 	return HttpRequestBuilder::user_restrictions_v2_list(api_key, universe_id, active_only, cursor);
 }
 
-void UserRestrictionGetListV2Request::handle_http_200(const QString& body, const QList<QNetworkReply::RawHeaderPair>&)
+void UserRestrictionGetListV2Request::handle_http_200(const QByteArray& body, const QList<QNetworkReply::RawHeaderPair>&)
 {
 	const std::optional<GetUserRestrictionListV2Response> response = GetUserRestrictionListV2Response::from(body);
 	if (!response)
@@ -1026,7 +1143,7 @@ QNetworkRequest UserRestrictionPatchUpdateV2Request::build_request(const std::op
 	return HttpRequestBuilder::resource_v2(api_key, path_with_params);
 }
 
-void UserRestrictionPatchUpdateV2Request::handle_http_200(const QString&, const QList<QNetworkReply::RawHeaderPair>&)
+void UserRestrictionPatchUpdateV2Request::handle_http_200(const QByteArray&, const QList<QNetworkReply::RawHeaderPair>&)
 {
 	do_success();
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <optional>
@@ -7,6 +8,7 @@
 #include <utility>
 #include <vector>
 
+#include <QByteArray>
 #include <QList>
 #include <QNetworkReply>
 #include <QNetworkRequest>
@@ -16,6 +18,7 @@
 #include "model_common.h"
 #include "util_enum.h"
 
+class HttpResponse;
 class QTimer;
 
 enum class DataRequestStatus : std::uint8_t
@@ -47,6 +50,9 @@ class DataRequest : public QObject
 	Q_OBJECT
 
 public:
+	// Cancels a request that is still queued or on the wire, so the wrangler does not keep its ticket around
+	virtual ~DataRequest() override;
+
 	DataRequestStatus req_status() const { return status; }
 	bool req_success() const { return status == DataRequestStatus::Success; }
 
@@ -56,31 +62,40 @@ public:
 	virtual QString get_title_string() const = 0;
 
 	void set_http_429_count(size_t new_count) { http_429_count = new_count; }
+	void set_allow_http2(bool allow) { allow_http2 = allow; }
+	void set_use_response_cache(bool use_cache) { use_response_cache = use_cache; }
+	// Shown in the HTTP log, defaults to the request's title
+	void set_operation(const QString& name) { operation = name; }
 
 signals:
 	void success();
 	void status_error(QString message);
 	void status_info(QString message);
 	void received_http_429();
+	// Emitted for every reply other than HTTP 429, with the time between sending the request and receiving the reply
+	void received_reply(qint64 latency_msecs);
 
 protected:
 	DataRequest(const QString& api_key);
 
 	virtual QNetworkRequest build_request(std::optional<QString> cursor = std::nullopt) const = 0;
-	virtual void handle_http_200(const QString& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) = 0;
+	virtual void handle_http_200(const QByteArray& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) = 0;
 
-	virtual void handle_http_404(const QString& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{});
+	virtual void handle_http_404(const QByteArray& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{});
 
 	virtual QString get_send_message() const;
 
-	void handle_reply_ready();
+	void handle_response(const HttpResponse& response);
 	void handle_timeout();
 	void resend();
+	void resend_after_backoff();
+	void dispatch_pending_request();
 
 	void timeout_begin();
 	void timeout_end();
 
 	int get_next_429_delay();
+	int get_next_server_error_delay();
 
 	void do_error(const QString& message);
 	void do_success(const QString& message = "Success");
@@ -91,14 +106,26 @@ protected:
 
 	std::optional<QString> pending_request_cursor;
 	std::optional<QNetworkRequest> pending_request;
-	QNetworkReply* pending_reply = nullptr;
+	// Ticket from HttpWrangler::submit while a request is queued or on the wire
+	std::optional<std::uint64_t> pending_ticket;
+	std::chrono::steady_clock::time_point pending_reply_sent;
 
 	QTimer* request_timeout = nullptr;
 
 	HttpRequestType request_type = HttpRequestType::Get;
+	bool allow_http2 = false;
+	bool use_response_cache = true;
+	QString operation;
 	DataRequestBody req_body;
 
+	// Number of times the current request has been dispatched, including resends after errors
+	size_t send_count = 0;
+
 	size_t http_429_count = 0;
+
+	// Consecutive server errors and timeouts, the delay before each retry grows with decorrelated jitter
+	size_t server_error_count = 0;
+	int server_error_delay = 0;
 };
 
 class MemoryStoreSortedMapGetListRequest : public DataRequest
@@ -114,7 +141,7 @@ public:
 
 private:
 	virtual QNetworkRequest build_request(std::optional<QString> cursor = std::nullopt) const override;
-	virtual void handle_http_200(const QString& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
+	virtual void handle_http_200(const QByteArray& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
 
 	long long universe_id;
 	QString map_name;
@@ -134,7 +161,7 @@ public:
 
 private:
 	virtual QNetworkRequest build_request(std::optional<QString> cursor = std::nullopt) const override;
-	virtual void handle_http_200(const QString& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
+	virtual void handle_http_200(const QByteArray& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
 	virtual QString get_send_message() const override;
 
 	long long universe_id;
@@ -150,7 +177,7 @@ public:
 
 private:
 	virtual QNetworkRequest build_request(std::optional<QString> cursor = std::nullopt) const override;
-	virtual void handle_http_200(const QString& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
+	virtual void handle_http_200(const QByteArray& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
 	virtual QString get_send_message() const override;
 
 	long long universe_id;
@@ -170,7 +197,7 @@ public:
 
 private:
 	virtual QNetworkRequest build_request(std::optional<QString> cursor = std::nullopt) const override;
-	virtual void handle_http_200(const QString& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
+	virtual void handle_http_200(const QByteArray& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
 	virtual QString get_send_message() const override;
 
 	long long universe_id;
@@ -194,7 +221,7 @@ public:
 
 private:
 	virtual QNetworkRequest build_request(std::optional<QString> cursor = std::nullopt) const override;
-	virtual void handle_http_200(const QString& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
+	virtual void handle_http_200(const QByteArray& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
 
 	long long universe_id;
 	QString datastore_name;
@@ -215,7 +242,7 @@ public:
 
 private:
 	virtual QNetworkRequest build_request(std::optional<QString> cursor = std::nullopt) const override;
-	virtual void handle_http_200(const QString& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
+	virtual void handle_http_200(const QByteArray& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
 	virtual QString get_send_message() const override;
 
 	long long universe_id;
@@ -234,7 +261,7 @@ public:
 
 private:
 	virtual QNetworkRequest build_request(std::optional<QString> cursor = std::nullopt) const override;
-	virtual void handle_http_200(const QString& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
+	virtual void handle_http_200(const QByteArray& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
 	virtual QString get_send_message() const override;
 
 	long long universe_id;
@@ -253,7 +280,7 @@ public:
 
 private:
 	virtual QNetworkRequest build_request(std::optional<QString> cursor = std::nullopt) const override;
-	virtual void handle_http_200(const QString& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
+	virtual void handle_http_200(const QByteArray& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
 	virtual QString get_send_message() const override;
 
 	long long universe_id;
@@ -270,12 +297,16 @@ public:
 
 	virtual QString get_title_string() const override;
 
+	const QString& get_datastore_name() const { return datastore_name; }
+	const QString& get_scope() const { return scope; }
+	const QString& get_key_name() const { return key_name; }
+
 	std::optional<bool> is_delete_success() const;
 
 private:
 	virtual QNetworkRequest build_request(std::optional<QString> cursor = std::nullopt) const override;
-	virtual void handle_http_200(const QString& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
-	virtual void handle_http_404(const QString& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
+	virtual void handle_http_200(const QByteArray& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
+	virtual void handle_http_404(const QByteArray& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
 	virtual QString get_send_message() const override;
 
 	long long universe_id;
@@ -302,8 +333,8 @@ public:
 
 protected:
 	virtual QNetworkRequest build_request(std::optional<QString> cursor = std::nullopt) const override;
-	virtual void handle_http_200(const QString& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
-	virtual void handle_http_404(const QString& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
+	virtual void handle_http_200(const QByteArray& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
+	virtual void handle_http_404(const QByteArray& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
 	virtual QString get_send_message() const override;
 
 	long long universe_id;
@@ -324,9 +355,11 @@ public:
 	virtual QString get_title_string() const override;
 
 	void set_result_limit(size_t limit);
+	// When false, entries are only reported through entry_found() and are not collected
+	void set_keep_entries(bool keep);
 
-	const std::vector<StandardDatastoreEntryName>& get_datastore_entries() const { return datastore_entries; }
-	std::vector<StandardDatastoreEntryName>&& get_datastore_entries_rvalue() { return std::move(datastore_entries); }
+	const StandardDatastoreEntryNameList& get_datastore_entries() const { return datastore_entries; }
+	StandardDatastoreEntryNameList&& get_datastore_entries_rvalue() { return std::move(datastore_entries); }
 
 signals:
 	void entry_found(const StandardDatastoreEntryName& name);
@@ -335,7 +368,7 @@ signals:
 
 private:
 	virtual QNetworkRequest build_request(std::optional<QString> cursor = std::nullopt) const override;
-	virtual void handle_http_200(const QString& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
+	virtual void handle_http_200(const QByteArray& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
 
 	long long universe_id;
 	QString datastore_name;
@@ -345,8 +378,10 @@ private:
 	std::optional<QString> initial_cursor;
 
 	std::optional<size_t> result_limit;
+	bool keep_entries = true;
 
-	std::vector<StandardDatastoreEntryName> datastore_entries;
+	size_t entry_count = 0;
+	StandardDatastoreEntryNameList datastore_entries;
 };
 
 class StandardDatastoreEntryGetVersionListRequest : public DataRequest
@@ -356,6 +391,9 @@ public:
 
 	virtual QString get_title_string() const override;
 
+	// Relies on versions being listed newest first, paging stops once a version that is not deleted has been received
+	void set_stop_at_live_version(bool stop);
+
 	const QString& get_datastore_name() const { return datastore_name; }
 	const QString& get_scope() const { return scope; }
 	const QString& get_key_name() const { return key_name; }
@@ -364,7 +402,7 @@ public:
 
 private:
 	virtual QNetworkRequest build_request(std::optional<QString> cursor = std::nullopt) const override;
-	virtual void handle_http_200(const QString& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
+	virtual void handle_http_200(const QByteArray& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
 	virtual QString get_send_message() const override;
 
 	long long universe_id;
@@ -372,6 +410,9 @@ private:
 	QString scope;
 	QString key_name;
 
+	bool stop_at_live_version = false;
+	bool live_version_found = false;
+
 	std::vector<StandardDatastoreEntryVersion> versions;
 };
 
@@ -407,7 +448,7 @@ public:
 
 private:
 	virtual QNetworkRequest build_request(std::optional<QString> cursor = std::nullopt) const override;
-	virtual void handle_http_200(const QString& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
+	virtual void handle_http_200(const QByteArray& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
 	virtual QString get_send_message() const override;
 
 	long long universe_id;
@@ -429,7 +470,7 @@ public:
 
 private:
 	virtual QNetworkRequest build_request(std::optional<QString> cursor = std::nullopt) const override;
-	virtual void handle_http_200(const QString& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
+	virtual void handle_http_200(const QByteArray& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
 
 	long long universe_id;
 
@@ -448,7 +489,7 @@ public:
 
 private:
 	virtual QNetworkRequest build_request(std::optional<QString> cursor = std::nullopt) const override;
-	virtual void handle_http_200(const QString& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
+	virtual void handle_http_200(const QByteArray& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
 
 	long long universe_id;
 
@@ -467,7 +508,7 @@ public:
 
 private:
 	virtual QNetworkRequest build_request(std::optional<QString> cursor = std::nullopt) const override;
-	virtual void handle_http_200(const QString& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
+	virtual void handle_http_200(const QByteArray& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
 
 	long long universe_id;
 
@@ -487,7 +528,7 @@ public:
 
 private:
 	virtual QNetworkRequest build_request(std::optional<QString> cursor = std::nullopt) const override;
-	virtual void handle_http_200(const QString& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
+	virtual void handle_http_200(const QByteArray& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
 
 	long long universe_id = 0;
 	bool active_only = false;
@@ -506,7 +547,7 @@ public:
 
 private:
 	virtual QNetworkRequest build_request(std::optional<QString> cursor = std::nullopt) const override;
-	virtual void handle_http_200(const QString& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
+	virtual void handle_http_200(const QByteArray& body, const QList<QNetworkReply::RawHeaderPair>& headers = QList<QNetworkReply::RawHeaderPair>{}) override;
 	virtual QString get_send_message() const override;
 
 	QString path;
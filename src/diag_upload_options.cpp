@@ -0,0 +1,96 @@
+#include "diag_upload_options.h"
+
+#include <QtGlobal>
+#include <QCheckBox>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLayout>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QVBoxLayout>
+#include <QWidget>
+
+UploadOptionsDialog::UploadOptionsDialog(QWidget* const parent) : QDialog{ parent }
+{
+	setWindowTitle("Upload Options");
+
+	skip_unchanged_check = new QCheckBox{ "Skip entries that match a previous dump", this };
+	skip_unchanged_check->setToolTip("Download the live datastores first and select that dump here, only entries whose value, user IDs or attributes differ are written");
+#if QT_VERSION >= QT_VERSION_CHECK(6, 7, 0)
+	connect(skip_unchanged_check, &QCheckBox::checkStateChanged, this, &UploadOptionsDialog::handle_skip_unchanged_changed);
+#else
+	connect(skip_unchanged_check, &QCheckBox::stateChanged, this, &UploadOptionsDialog::handle_skip_unchanged_changed);
+#endif
+
+	QWidget* const baseline_line = new QWidget{ this };
+	{
+		baseline_edit = new QLineEdit{ baseline_line };
+		baseline_edit->setPlaceholderText("Dump to compare against");
+		connect(baseline_edit, &QLineEdit::textChanged, this, &UploadOptionsDialog::handle_skip_unchanged_changed);
+
+		browse_button = new QPushButton{ "Browse...", baseline_line };
+		connect(browse_button, &QPushButton::clicked, this, &UploadOptionsDialog::pressed_browse);
+
+		QHBoxLayout* const baseline_layout = new QHBoxLayout{ baseline_line };
+		baseline_layout->setContentsMargins(0, 0, 0, 0);
+		baseline_layout->addWidget(baseline_edit);
+		baseline_layout->addWidget(browse_button);
+	}
+
+	dry_run_check = new QCheckBox{ "Dry run, only count the entries that would be written", this };
+
+	QWidget* const button_line = new QWidget{ this };
+	{
+		ok_button = new QPushButton{ "&Upload", button_line };
+		connect(ok_button, &QPushButton::clicked, this, &QDialog::accept);
+
+		QPushButton* const cancel_button = new QPushButton{ "&Cancel", button_line };
+		connect(cancel_button, &QPushButton::clicked, this, &QDialog::reject);
+
+		QHBoxLayout* const button_layout = new QHBoxLayout{ button_line };
+		button_layout->setContentsMargins(0, 0, 0, 0);
+		button_layout->addWidget(ok_button);
+		button_layout->addWidget(cancel_button);
+	}
+
+	QVBoxLayout* const layout = new QVBoxLayout{ this };
+	layout->setSizeConstraint(QLayout::SizeConstraint::SetFixedSize);
+	layout->addWidget(skip_unchanged_check);
+	layout->addWidget(baseline_line);
+	layout->addWidget(dry_run_check);
+	layout->addWidget(button_line);
+
+	handle_skip_unchanged_changed();
+}
+
+std::optional<QString> UploadOptionsDialog::get_baseline_path() const
+{
+	if (skip_unchanged_check->isChecked() && baseline_edit->text().trimmed().size() > 0)
+	{
+		return baseline_edit->text().trimmed();
+	}
+	return std::nullopt;
+}
+
+bool UploadOptionsDialog::get_dry_run() const
+{
+	return dry_run_check->isChecked();
+}
+
+void UploadOptionsDialog::handle_skip_unchanged_changed()
+{
+	const bool skip_unchanged = skip_unchanged_check->isChecked();
+	baseline_edit->setEnabled(skip_unchanged);
+	browse_button->setEnabled(skip_unchanged);
+	ok_button->setEnabled(skip_unchanged == false || baseline_edit->text().trimmed().size() > 0);
+}
+
+void UploadOptionsDialog::pressed_browse()
+{
+	const QString file_path = QFileDialog::getOpenFileName(this, "Select dump to compare against...", "", "sqlite3 databases (*.sqlite3)");
+	if (file_path.trimmed().size() > 0)
+	{
+		baseline_edit->setText(file_path);
+	}
+}
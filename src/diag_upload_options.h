@@ -0,0 +1,34 @@
+#pragma once
+
+#include <optional>
+
+#include <QDialog>
+#include <QObject>
+#include <QString>
+
+class QCheckBox;
+class QLineEdit;
+class QPushButton;
+class QWidget;
+
+class UploadOptionsDialog : public QDialog
+{
+	Q_OBJECT
+
+public:
+	UploadOptionsDialog(QWidget* parent = nullptr);
+
+	// Set when entries that match this dump should be skipped
+	std::optional<QString> get_baseline_path() const;
+	bool get_dry_run() const;
+
+private:
+	void handle_skip_unchanged_changed();
+	void pressed_browse();
+
+	QCheckBox* skip_unchanged_check = nullptr;
+	QLineEdit* baseline_edit = nullptr;
+	QPushButton* browse_button = nullptr;
+	QCheckBox* dry_run_check = nullptr;
+	QPushButton* ok_button = nullptr;
+};
@@ -0,0 +1,153 @@
+#include "http_adaptive_concurrency.h"
+
+#include <cstddef>
+
+#include <algorithm>
+#include <vector>
+
+static constexpr std::chrono::seconds RATE_INTERVAL{ 5 };
+static constexpr std::chrono::milliseconds DECREASE_COOLDOWN{ 1000 };
+static constexpr size_t LATENCY_SAMPLE_COUNT = 64;
+static constexpr size_t LATENCY_SAMPLE_MINIMUM = 16;
+// Latency is considered to be rising once p95 reaches this multiple of the baseline
+static constexpr double LATENCY_RISE_FACTOR = 2.0;
+// Fraction of the gap to the current p95 the baseline closes with each sample while p95 is above it
+static constexpr double LATENCY_BASELINE_DRIFT = 0.05;
+
+AdaptiveConcurrencyController::AdaptiveConcurrencyController(const size_t initial_window, const size_t max_window) :
+	window{ static_cast<double>(std::clamp<size_t>(initial_window, 1, std::max<size_t>(max_window, 1))) },
+	max_window{ std::max<size_t>(max_window, 1) },
+	last_decrease{ std::chrono::steady_clock::now() - DECREASE_COOLDOWN }
+{
+
+}
+
+void AdaptiveConcurrencyController::record_reply(const std::chrono::milliseconds latency)
+{
+	const auto now = std::chrono::steady_clock::now();
+	record_reply_event(now);
+
+	recent_latencies.push_back(latency);
+	while (recent_latencies.size() > LATENCY_SAMPLE_COUNT)
+	{
+		recent_latencies.pop_front();
+	}
+
+	const std::optional<std::chrono::milliseconds> latency_p95 = get_latency_p95();
+	if (latency_p95)
+	{
+		const double p95_msecs = static_cast<double>(latency_p95->count());
+		if (baseline_latency_p95_msecs.has_value() == false || p95_msecs < *baseline_latency_p95_msecs)
+		{
+			baseline_latency_p95_msecs = p95_msecs;
+		}
+		else
+		{
+			// Without this a single quiet period early on would make every later sample look like a spike
+			const bool rising = p95_msecs > *baseline_latency_p95_msecs * LATENCY_RISE_FACTOR;
+			*baseline_latency_p95_msecs += (p95_msecs - *baseline_latency_p95_msecs) * LATENCY_BASELINE_DRIFT;
+			if (rising)
+			{
+				decrease(now);
+				return;
+			}
+		}
+	}
+
+	increase();
+}
+
+void AdaptiveConcurrencyController::record_reply()
+{
+	record_reply_event(std::chrono::steady_clock::now());
+	increase();
+}
+
+void AdaptiveConcurrencyController::record_http_429()
+{
+	const auto now = std::chrono::steady_clock::now();
+	trim_events(now);
+	recent_events.push_back(ReplyEvent{ now, true });
+	decrease(now);
+}
+
+size_t AdaptiveConcurrencyController::get_window() const
+{
+	return std::max<size_t>(1, static_cast<size_t>(window));
+}
+
+double AdaptiveConcurrencyController::get_http_429_rate() const
+{
+	const auto cutoff = std::chrono::steady_clock::now() - RATE_INTERVAL;
+	size_t total = 0;
+	size_t throttled = 0;
+	for (const ReplyEvent& this_event : recent_events)
+	{
+		if (this_event.time >= cutoff)
+		{
+			total++;
+			if (this_event.throttled)
+			{
+				throttled++;
+			}
+		}
+	}
+	if (total == 0)
+	{
+		return 0.0;
+	}
+	return static_cast<double>(throttled) / static_cast<double>(total);
+}
+
+double AdaptiveConcurrencyController::get_requests_per_second() const
+{
+	const auto cutoff = std::chrono::steady_clock::now() - RATE_INTERVAL;
+	const auto count = std::count_if(recent_events.begin(), recent_events.end(), [cutoff](const ReplyEvent& this_event) { return this_event.time >= cutoff; });
+	const std::chrono::duration<double> interval = RATE_INTERVAL;
+	return static_cast<double>(count) / interval.count();
+}
+
+void AdaptiveConcurrencyController::record_reply_event(const std::chrono::steady_clock::time_point now)
+{
+	trim_events(now);
+	recent_events.push_back(ReplyEvent{ now, false });
+}
+
+void AdaptiveConcurrencyController::decrease(const std::chrono::steady_clock::time_point now)
+{
+	// Replies that were already in flight when the first 429 arrived will often also be throttled, only back off once for all of them
+	if (now - last_decrease < DECREASE_COOLDOWN)
+	{
+		return;
+	}
+	last_decrease = now;
+	window = std::max(1.0, window / 2.0);
+	// Latencies measured at the old window size no longer describe the new one
+	recent_latencies.clear();
+}
+
+void AdaptiveConcurrencyController::increase()
+{
+	window = std::min(static_cast<double>(max_window), window + 1.0 / window);
+}
+
+void AdaptiveConcurrencyController::trim_events(const std::chrono::steady_clock::time_point now)
+{
+	const auto cutoff = now - RATE_INTERVAL;
+	while (recent_events.size() > 0 && recent_events.front().time < cutoff)
+	{
+		recent_events.pop_front();
+	}
+}
+
+std::optional<std::chrono::milliseconds> AdaptiveConcurrencyController::get_latency_p95() const
+{
+	if (recent_latencies.size() < LATENCY_SAMPLE_MINIMUM)
+	{
+		return std::nullopt;
+	}
+	std::vector<std::chrono::milliseconds> sorted_latencies{ recent_latencies.begin(), recent_latencies.end() };
+	const size_t p95_index = (sorted_latencies.size() * 95) / 100;
+	std::nth_element(sorted_latencies.begin(), sorted_latencies.begin() + static_cast<std::ptrdiff_t>(p95_index), sorted_latencies.end());
+	return sorted_latencies[p95_index];
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+
+#include <chrono>
+#include <deque>
+#include <optional>
+
+// Additive increase, multiplicative decrease controller for the number of requests a bulk operation keeps in flight
+// The window grows by roughly one slot per window of successful replies and is halved on HTTP 429 or a latency spike
+class AdaptiveConcurrencyController
+{
+public:
+	AdaptiveConcurrencyController(size_t initial_window, size_t max_window);
+
+	void record_reply(std::chrono::milliseconds latency);
+	// Counts a reply without taking a latency sample, for requests that are much slower or faster than the ones the window is tuned for
+	void record_reply();
+	void record_http_429();
+
+	size_t get_window() const;
+	size_t get_max_window() const { return max_window; }
+
+	// Both of these are measured over a trailing interval of a few seconds
+	double get_http_429_rate() const;
+	double get_requests_per_second() const;
+
+private:
+	class ReplyEvent
+	{
+	public:
+		std::chrono::steady_clock::time_point time;
+		bool throttled;
+	};
+
+	void record_reply_event(std::chrono::steady_clock::time_point now);
+	void decrease(std::chrono::steady_clock::time_point now);
+	void increase();
+	void trim_events(std::chrono::steady_clock::time_point now);
+	std::optional<std::chrono::milliseconds> get_latency_p95() const;
+
+	double window;
+	size_t max_window;
+
+	std::chrono::steady_clock::time_point last_decrease;
+
+	std::deque<std::chrono::milliseconds> recent_latencies;
+	// Follows the lowest p95 seen, but drifts up towards the current p95 so a lasting shift in latency becomes the new normal
+	std::optional<double> baseline_latency_p95_msecs;
+
+	std::deque<ReplyEvent> recent_events;
+};
@@ -0,0 +1,78 @@
+#include "http_circuit_breaker.h"
+
+#include <algorithm>
+
+static constexpr size_t FAILURE_THRESHOLD = 5;
+static constexpr std::chrono::milliseconds OPEN_DURATION_BASE{ 5000 };
+static constexpr std::chrono::milliseconds OPEN_DURATION_MAX{ 60000 };
+// Longer than the request timeout, if no result has arrived by then the probe was abandoned and another may be sent
+static constexpr std::chrono::milliseconds PROBE_TIMEOUT{ 30000 };
+static constexpr std::chrono::milliseconds PROBE_POLL_INTERVAL{ 500 };
+
+std::optional<std::chrono::milliseconds> HttpCircuitBreaker::try_acquire(const std::chrono::steady_clock::time_point now)
+{
+	switch (state)
+	{
+	case HttpCircuitState::Closed:
+		return std::nullopt;
+	case HttpCircuitState::Open:
+		if (now < open_until)
+		{
+			return get_time_until_probe(now);
+		}
+		state = HttpCircuitState::HalfOpen;
+		probe_sent = now;
+		return std::nullopt;
+	case HttpCircuitState::HalfOpen:
+		if (now - probe_sent > PROBE_TIMEOUT)
+		{
+			probe_sent = now;
+			return std::nullopt;
+		}
+		return PROBE_POLL_INTERVAL;
+	}
+	return std::nullopt;
+}
+
+bool HttpCircuitBreaker::record_success()
+{
+	consecutive_failures = 0;
+	if (state != HttpCircuitState::Closed)
+	{
+		state = HttpCircuitState::Closed;
+		consecutive_opens = 0;
+		return true;
+	}
+	return false;
+}
+
+bool HttpCircuitBreaker::record_failure(const std::chrono::steady_clock::time_point now)
+{
+	consecutive_failures++;
+	if (state == HttpCircuitState::HalfOpen || (state == HttpCircuitState::Closed && consecutive_failures >= FAILURE_THRESHOLD))
+	{
+		open(now);
+		return true;
+	}
+	return false;
+}
+
+std::chrono::milliseconds HttpCircuitBreaker::get_time_until_probe(const std::chrono::steady_clock::time_point now) const
+{
+	if (state != HttpCircuitState::Open || now >= open_until)
+	{
+		return std::chrono::milliseconds{ 0 };
+	}
+	return std::chrono::duration_cast<std::chrono::milliseconds>(open_until - now) + std::chrono::milliseconds{ 1 };
+}
+
+void HttpCircuitBreaker::open(const std::chrono::steady_clock::time_point now)
+{
+	// Each failed probe doubles the time until the next one
+	const size_t doublings = std::min<size_t>(consecutive_opens, 4);
+	const std::chrono::milliseconds open_duration = std::min(OPEN_DURATION_MAX, OPEN_DURATION_BASE * (1 << doublings));
+	consecutive_opens++;
+
+	state = HttpCircuitState::Open;
+	open_until = now + open_duration;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+
+#include <chrono>
+#include <optional>
+
+#include "util_enum.h"
+
+// Stops sending requests to an endpoint family after repeated server errors
+// Once open, a single probe request is allowed through after a delay and the breaker closes again if that probe succeeds
+class HttpCircuitBreaker
+{
+public:
+	// Returns nullopt if a request may be sent now, otherwise how long to wait before asking again
+	std::optional<std::chrono::milliseconds> try_acquire(std::chrono::steady_clock::time_point now);
+
+	// Both return true if this changed the state of the breaker
+	bool record_success();
+	bool record_failure(std::chrono::steady_clock::time_point now);
+
+	HttpCircuitState get_state() const { return state; }
+	size_t get_consecutive_failures() const { return consecutive_failures; }
+	std::chrono::milliseconds get_time_until_probe(std::chrono::steady_clock::time_point now) const;
+
+private:
+	void open(std::chrono::steady_clock::time_point now);
+
+	HttpCircuitState state = HttpCircuitState::Closed;
+	size_t consecutive_failures = 0;
+	size_t consecutive_opens = 0;
+
+	std::chrono::steady_clock::time_point open_until;
+	std::chrono::steady_clock::time_point probe_sent;
+};
@@ -0,0 +1,135 @@
+#include "http_rate_limit_headers.h"
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QString>
+#include <QtGlobal>
+#include <QTimeZone>
+
+// Anything larger than this is treated as a unix timestamp rather than a number of seconds
+static constexpr long long RESET_EPOCH_THRESHOLD = 1000000000;
+
+// Headers such as 'x-ratelimit-limit: 300, 300;w=60' may list several policies, the first value is the one that applies now
+static std::optional<double> parse_first_number(const QByteArray& value)
+{
+	const QString value_string = QString::fromUtf8(value);
+	const QString first_value = value_string.section(',', 0, 0).section(';', 0, 0).trimmed();
+	bool ok = false;
+	const double result = first_value.toDouble(&ok);
+	if (ok && result >= 0.0)
+	{
+		return result;
+	}
+	return std::nullopt;
+}
+
+// Format: "Fri, 01 Jul 2022 21:34:54 GMT"
+static std::optional<QDateTime> parse_http_date(const QByteArray& value)
+{
+	QString date_string = QString::fromUtf8(value).trimmed();
+	if (date_string.endsWith(" GMT"))
+	{
+		date_string.chop(4);
+	}
+	QDateTime result = QDateTime::fromString(date_string, "ddd, dd MMM yyyy HH:mm:ss");
+	if (result.isValid() == false)
+	{
+		return std::nullopt;
+	}
+#if QT_VERSION >= QT_VERSION_CHECK(6, 5, 0)
+	result.setTimeZone(QTimeZone::UTC);
+#else
+	result.setTimeSpec(Qt::UTC);
+#endif
+	return result;
+}
+
+static std::chrono::milliseconds seconds_to_milliseconds(const double seconds)
+{
+	return std::chrono::milliseconds{ static_cast<long long>(seconds * 1000.0) };
+}
+
+HttpRateLimitHeaders HttpRateLimitHeaders::parse(const QList<QNetworkReply::RawHeaderPair>& headers)
+{
+	HttpRateLimitHeaders result;
+
+	std::optional<QByteArray> retry_after_value;
+	std::optional<QDateTime> date;
+	std::optional<double> reset_value;
+	for (const auto& this_pair : headers)
+	{
+		const QByteArray name = this_pair.first.toLower();
+		if (name == "retry-after")
+		{
+			retry_after_value = this_pair.second;
+		}
+		else if (name == "date")
+		{
+			date = parse_http_date(this_pair.second);
+		}
+		else if (name == "x-ratelimit-remaining")
+		{
+			const std::optional<double> remaining_value = parse_first_number(this_pair.second);
+			if (remaining_value)
+			{
+				result.remaining = static_cast<long long>(*remaining_value);
+			}
+		}
+		else if (name == "x-ratelimit-reset")
+		{
+			reset_value = parse_first_number(this_pair.second);
+		}
+	}
+
+	if (retry_after_value)
+	{
+		// Either a number of seconds or an http date
+		const std::optional<double> retry_seconds = parse_first_number(*retry_after_value);
+		if (retry_seconds)
+		{
+			result.retry_after = seconds_to_milliseconds(*retry_seconds);
+		}
+		else
+		{
+			const std::optional<QDateTime> retry_date = parse_http_date(*retry_after_value);
+			if (retry_date && date)
+			{
+				// Compare against the server's own clock rather than ours
+				const qint64 retry_msecs = date->msecsTo(*retry_date);
+				result.retry_after = std::chrono::milliseconds{ retry_msecs > 0 ? retry_msecs : 0 };
+			}
+		}
+	}
+
+	if (reset_value)
+	{
+		if (*reset_value > RESET_EPOCH_THRESHOLD)
+		{
+			if (date)
+			{
+				const qint64 reset_msecs = static_cast<qint64>(*reset_value * 1000.0) - date->toMSecsSinceEpoch();
+				result.reset_after = std::chrono::milliseconds{ reset_msecs > 0 ? reset_msecs : 0 };
+			}
+		}
+		else
+		{
+			result.reset_after = seconds_to_milliseconds(*reset_value);
+		}
+	}
+
+	return result;
+}
+
+std::optional<std::chrono::milliseconds> HttpRateLimitHeaders::get_wait_time(const bool received_http_429) const
+{
+	if (retry_after)
+	{
+		return retry_after;
+	}
+	const bool exhausted = received_http_429 || (remaining.has_value() && *remaining <= 0);
+	if (exhausted && reset_after)
+	{
+		return reset_after;
+	}
+	return std::nullopt;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <chrono>
+#include <optional>
+
+#include <QList>
+#include <QNetworkReply>
+
+// Rate limit information returned by Open Cloud in 'Retry-After' and 'x-ratelimit-*' response headers
+class HttpRateLimitHeaders
+{
+public:
+	static HttpRateLimitHeaders parse(const QList<QNetworkReply::RawHeaderPair>& headers);
+
+	// How long to wait before spending more of the same budget, or nullopt if the headers do not ask for a wait
+	std::optional<std::chrono::milliseconds> get_wait_time(bool received_http_429) const;
+
+	const std::optional<std::chrono::milliseconds>& get_retry_after() const { return retry_after; }
+	const std::optional<long long>& get_remaining() const { return remaining; }
+	const std::optional<std::chrono::milliseconds>& get_reset_after() const { return reset_after; }
+
+private:
+	std::optional<std::chrono::milliseconds> retry_after;
+	std::optional<long long> remaining;
+	std::optional<std::chrono::milliseconds> reset_after;
+};
@@ -0,0 +1,374 @@
+#include "http_rate_limiter.h"
+
+#include <cmath>
+
+#include <algorithm>
+#include <optional>
+#include <utility>
+
+#include <QByteArray>
+#include <QNetworkRequest>
+#include <QRegularExpression>
+#include <QRegularExpressionMatch>
+#include <QSettings>
+#include <QTimer>
+#include <QUrl>
+#include <QVariant>
+
+#include "assert.h"
+
+// Default budgets in requests per second, these approximate the documented per-key Open Cloud limits
+// Each can be overridden with a value in the 'rate_limits' settings group
+static double get_default_budget(const HttpEndpointFamily family)
+{
+	switch (family)
+	{
+	case HttpEndpointFamily::StandardDatastoreEntryRead:
+		return 20.0;
+	case HttpEndpointFamily::StandardDatastoreEntryWrite:
+		return 10.0;
+	case HttpEndpointFamily::StandardDatastoreEntryList:
+	case HttpEndpointFamily::StandardDatastoreList:
+	case HttpEndpointFamily::StandardDatastoreVersionList:
+		return 5.0;
+	case HttpEndpointFamily::StandardDatastoreSnapshot:
+		return 1.0;
+	case HttpEndpointFamily::MemoryStoreSortedMap:
+	case HttpEndpointFamily::MessagingService:
+	case HttpEndpointFamily::OrderedDatastore:
+	case HttpEndpointFamily::Universe:
+	case HttpEndpointFamily::UserRestriction:
+	case HttpEndpointFamily::Other:
+		return 10.0;
+	}
+	return 10.0;
+}
+
+static QString get_settings_name(const HttpEndpointFamily family)
+{
+	switch (family)
+	{
+	case HttpEndpointFamily::Other:
+		return "other";
+	case HttpEndpointFamily::MemoryStoreSortedMap:
+		return "memory_store_sorted_map";
+	case HttpEndpointFamily::MessagingService:
+		return "messaging_service";
+	case HttpEndpointFamily::OrderedDatastore:
+		return "ordered_datastore";
+	case HttpEndpointFamily::StandardDatastoreList:
+		return "standard_datastore_list";
+	case HttpEndpointFamily::StandardDatastoreEntryList:
+		return "standard_datastore_entry_list";
+	case HttpEndpointFamily::StandardDatastoreEntryRead:
+		return "standard_datastore_entry_read";
+	case HttpEndpointFamily::StandardDatastoreEntryWrite:
+		return "standard_datastore_entry_write";
+	case HttpEndpointFamily::StandardDatastoreVersionList:
+		return "standard_datastore_version_list";
+	case HttpEndpointFamily::StandardDatastoreSnapshot:
+		return "standard_datastore_snapshot";
+	case HttpEndpointFamily::Universe:
+		return "universe";
+	case HttpEndpointFamily::UserRestriction:
+		return "user_restriction";
+	}
+	return "other";
+}
+
+static constexpr HttpEndpointFamily ALL_ENDPOINT_FAMILIES[] = {
+	HttpEndpointFamily::Other,
+	HttpEndpointFamily::MemoryStoreSortedMap,
+	HttpEndpointFamily::MessagingService,
+	HttpEndpointFamily::OrderedDatastore,
+	HttpEndpointFamily::StandardDatastoreList,
+	HttpEndpointFamily::StandardDatastoreEntryList,
+	HttpEndpointFamily::StandardDatastoreEntryRead,
+	HttpEndpointFamily::StandardDatastoreEntryWrite,
+	HttpEndpointFamily::StandardDatastoreVersionList,
+	HttpEndpointFamily::StandardDatastoreSnapshot,
+	HttpEndpointFamily::Universe,
+	HttpEndpointFamily::UserRestriction,
+};
+
+HttpRateLimitKey HttpRateLimitKey::from_request(const HttpRequestType type, const QNetworkRequest& request)
+{
+	const QString path = request.url().path();
+
+	long long universe_id = 0;
+	static const QRegularExpression universe_regex{ "/universes/(\\d+)" };
+	const QRegularExpressionMatch universe_match = universe_regex.match(path);
+	if (universe_match.hasMatch())
+	{
+		universe_id = universe_match.captured(1).toLongLong();
+	}
+
+	const QString api_key = QString::fromUtf8(request.rawHeader("x-api-key"));
+	return HttpRateLimitKey{ api_key, universe_id, get_endpoint_family(type, path) };
+}
+
+HttpEndpointFamily HttpRateLimitKey::get_endpoint_family(const HttpRequestType type, const QString& url_path)
+{
+	if (url_path.startsWith("/datastores/v1/"))
+	{
+		if (url_path.endsWith("/standard-datastores"))
+		{
+			return HttpEndpointFamily::StandardDatastoreList;
+		}
+		else if (url_path.endsWith("/standard-datastores/datastore/entries"))
+		{
+			return HttpEndpointFamily::StandardDatastoreEntryList;
+		}
+		else if (url_path.endsWith("/entries/entry/versions"))
+		{
+			return HttpEndpointFamily::StandardDatastoreVersionList;
+		}
+		else if (url_path.endsWith("/entries/entry/versions/version"))
+		{
+			return HttpEndpointFamily::StandardDatastoreEntryRead;
+		}
+		else if (url_path.endsWith("/entries/entry"))
+		{
+			return type == HttpRequestType::Get ? HttpEndpointFamily::StandardDatastoreEntryRead : HttpEndpointFamily::StandardDatastoreEntryWrite;
+		}
+		return HttpEndpointFamily::Other;
+	}
+	else if (url_path.startsWith("/cloud/v2/"))
+	{
+		if (url_path.contains("/memory-store"))
+		{
+			return HttpEndpointFamily::MemoryStoreSortedMap;
+		}
+		else if (url_path.contains("/ordered-data-stores"))
+		{
+			return HttpEndpointFamily::OrderedDatastore;
+		}
+		else if (url_path.contains("/user-restrictions"))
+		{
+			return HttpEndpointFamily::UserRestriction;
+		}
+		else if (url_path.endsWith("/data-stores:snapshot"))
+		{
+			return HttpEndpointFamily::StandardDatastoreSnapshot;
+		}
+		else if (url_path.endsWith(":publishMessage"))
+		{
+			return HttpEndpointFamily::MessagingService;
+		}
+		return HttpEndpointFamily::Universe;
+	}
+	return HttpEndpointFamily::Other;
+}
+
+HttpRateLimitKey::HttpRateLimitKey(const QString& api_key, const long long universe_id, const HttpEndpointFamily family) : api_key{ api_key }, universe_id{ universe_id }, family{ family }
+{
+
+}
+
+bool HttpRateLimitKey::operator<(const HttpRateLimitKey& other) const
+{
+	if (universe_id != other.universe_id)
+	{
+		return universe_id < other.universe_id;
+	}
+	if (family != other.family)
+	{
+		return family < other.family;
+	}
+	return api_key < other.api_key;
+}
+
+HttpTokenBucket::HttpTokenBucket(const double tokens_per_second, const double capacity) :
+	tokens_per_second{ tokens_per_second },
+	capacity{ capacity },
+	tokens{ capacity },
+	last_refill{ std::chrono::steady_clock::now() }
+{
+
+}
+
+bool HttpTokenBucket::try_take(const std::chrono::steady_clock::time_point now)
+{
+	refill(now);
+	if (tokens >= 1.0)
+	{
+		tokens = tokens - 1.0;
+		return true;
+	}
+	return false;
+}
+
+std::chrono::milliseconds HttpTokenBucket::get_time_until_available(const std::chrono::steady_clock::time_point now)
+{
+	refill(now);
+	if (tokens >= 1.0)
+	{
+		return std::chrono::milliseconds{ 0 };
+	}
+	const double seconds = (1.0 - tokens) / tokens_per_second;
+	return std::chrono::milliseconds{ static_cast<long long>(std::ceil(seconds * 1000.0)) };
+}
+
+void HttpTokenBucket::refill(const std::chrono::steady_clock::time_point now)
+{
+	const std::chrono::duration<double> elapsed = now - last_refill;
+	last_refill = now;
+	tokens = std::min(capacity, tokens + elapsed.count() * tokens_per_second);
+}
+
+HttpRateLimiter::HttpRateLimiter(QObject* parent) : QObject{ parent }
+{
+	load_budgets();
+
+	dispatch_timer = new QTimer{ this };
+	dispatch_timer->setSingleShot(true);
+	connect(dispatch_timer, &QTimer::timeout, this, &HttpRateLimiter::dispatch_ready);
+}
+
+void HttpRateLimiter::enqueue(const HttpRateLimitKey& key, QObject* const context, const std::function<void()>& send_func, const std::function<void()>& on_dropped)
+{
+	get_lane(key).queue.push_back(PendingSend{ context, send_func, on_dropped });
+
+	if (dispatching)
+	{
+		// A send function queued another request, pick it up on the next pass instead of recursing
+		dispatch_timer->start(0);
+	}
+	else
+	{
+		dispatch_ready();
+	}
+}
+
+void HttpRateLimiter::set_send_gate(const SendGate& gate)
+{
+	send_gate = gate;
+}
+
+void HttpRateLimiter::wake()
+{
+	dispatch_timer->start(0);
+}
+
+void HttpRateLimiter::pause(const HttpRateLimitKey& key, const std::chrono::milliseconds duration)
+{
+	Lane& lane = get_lane(key);
+	lane.paused_until = std::max(lane.paused_until, std::chrono::steady_clock::now() + duration);
+	if (dispatching == false)
+	{
+		dispatch_ready();
+	}
+}
+
+double HttpRateLimiter::get_budget(const HttpEndpointFamily family) const
+{
+	const auto it = budgets.find(family);
+	if (it != budgets.end())
+	{
+		return it->second;
+	}
+	return get_default_budget(family);
+}
+
+HttpRateLimiter::Lane::Lane(const double tokens_per_second) : bucket{ tokens_per_second, std::max(1.0, tokens_per_second) }
+{
+
+}
+
+HttpRateLimiter::Lane& HttpRateLimiter::get_lane(const HttpRateLimitKey& key)
+{
+	auto lane_it = lanes.find(key);
+	if (lane_it == lanes.end())
+	{
+		lane_it = lanes.emplace(key, Lane{ get_budget(key.get_family()) }).first;
+	}
+	return lane_it->second;
+}
+
+void HttpRateLimiter::load_budgets()
+{
+	QSettings settings;
+	settings.beginGroup("rate_limits");
+	for (const HttpEndpointFamily this_family : ALL_ENDPOINT_FAMILIES)
+	{
+		double budget = get_default_budget(this_family);
+		const QVariant setting = settings.value(get_settings_name(this_family));
+		if (setting.isValid())
+		{
+			bool ok = false;
+			const double setting_budget = setting.toDouble(&ok);
+			if (ok && setting_budget > 0.0)
+			{
+				budget = setting_budget;
+			}
+		}
+		budgets.insert_or_assign(this_family, budget);
+	}
+	settings.endGroup();
+}
+
+void HttpRateLimiter::dispatch_ready()
+{
+	dispatching = true;
+
+	std::optional<std::chrono::milliseconds> next_wait;
+	for (auto& [key, lane] : lanes)
+	{
+		while (lane.queue.size() > 0)
+		{
+			if (lane.queue.front().context.isNull())
+			{
+				const std::function<void()> on_dropped = lane.queue.front().on_dropped;
+				lane.queue.pop_front();
+				if (on_dropped)
+				{
+					on_dropped();
+				}
+				continue;
+			}
+
+			const auto now = std::chrono::steady_clock::now();
+			std::optional<std::chrono::milliseconds> this_wait;
+			if (now < lane.paused_until)
+			{
+				this_wait = std::chrono::duration_cast<std::chrono::milliseconds>(lane.paused_until - now) + std::chrono::milliseconds{ 1 };
+			}
+			else if (const std::chrono::milliseconds bucket_wait = lane.bucket.get_time_until_available(now); bucket_wait.count() > 0)
+			{
+				this_wait = bucket_wait;
+			}
+			else if (send_gate)
+			{
+				// Only consult the gate once a token is known to be available, the gate may reserve a probe slot
+				this_wait = send_gate(key);
+			}
+
+			if (this_wait)
+			{
+				if (next_wait.has_value() == false || *this_wait < *next_wait)
+				{
+					next_wait = *this_wait;
+				}
+				break;
+			}
+
+			const bool took_token = lane.bucket.try_take(now);
+			OCTASSERT(took_token);
+
+			const PendingSend next_send = std::move(lane.queue.front());
+			lane.queue.pop_front();
+			next_send.send_func();
+		}
+	}
+
+	dispatching = false;
+
+	if (next_wait)
+	{
+		const auto wait_ms = std::max<long long>(1, next_wait->count());
+		if (dispatch_timer->isActive() == false || dispatch_timer->remainingTime() > wait_ms)
+		{
+			dispatch_timer->start(static_cast<int>(wait_ms));
+		}
+	}
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <optional>
+
+#include <QObject>
+#include <QPointer>
+#include <QString>
+
+#include "util_enum.h"
+
+class QNetworkRequest;
+class QTimer;
+
+// Identifies a single Open Cloud rate limit budget
+class HttpRateLimitKey
+{
+public:
+	static HttpRateLimitKey from_request(HttpRequestType type, const QNetworkRequest& request);
+	static HttpEndpointFamily get_endpoint_family(HttpRequestType type, const QString& url_path);
+
+	HttpRateLimitKey(const QString& api_key, long long universe_id, HttpEndpointFamily family);
+
+	bool operator<(const HttpRateLimitKey& other) const;
+
+	const QString& get_api_key() const { return api_key; }
+	long long get_universe_id() const { return universe_id; }
+	HttpEndpointFamily get_family() const { return family; }
+
+private:
+	QString api_key;
+	long long universe_id;
+	HttpEndpointFamily family;
+};
+
+class HttpTokenBucket
+{
+public:
+	HttpTokenBucket(double tokens_per_second, double capacity);
+
+	bool try_take(std::chrono::steady_clock::time_point now);
+	std::chrono::milliseconds get_time_until_available(std::chrono::steady_clock::time_point now);
+
+private:
+	void refill(std::chrono::steady_clock::time_point now);
+
+	double tokens_per_second;
+	double capacity;
+	double tokens;
+	std::chrono::steady_clock::time_point last_refill;
+};
+
+// Paces outgoing requests so that all panels and windows share the same budget for each api key, universe, and endpoint family
+class HttpRateLimiter : public QObject
+{
+	Q_OBJECT
+public:
+	// Checked before each send, returns nullopt to allow the send or the time to wait before checking again
+	using SendGate = std::function<std::optional<std::chrono::milliseconds>(const HttpRateLimitKey&)>;
+
+	explicit HttpRateLimiter(QObject* parent = nullptr);
+
+	void set_send_gate(const SendGate& gate);
+	// Schedules a dispatch pass, used when something the send gate depends on has changed
+	void wake();
+
+	// Runs send_func as soon as a token is available for the given key
+	// If context is destroyed first, send_func is dropped and on_dropped runs instead so the caller can forget the send
+	void enqueue(const HttpRateLimitKey& key, QObject* context, const std::function<void()>& send_func, const std::function<void()>& on_dropped = nullptr);
+	// Holds back every request for the given key until the duration has passed, used when the server says how long to wait
+	void pause(const HttpRateLimitKey& key, std::chrono::milliseconds duration);
+
+	double get_budget(HttpEndpointFamily family) const;
+
+private:
+	class PendingSend
+	{
+	public:
+		QPointer<QObject> context;
+		std::function<void()> send_func;
+		std::function<void()> on_dropped;
+	};
+
+	class Lane
+	{
+	public:
+		explicit Lane(double tokens_per_second);
+
+		HttpTokenBucket bucket;
+		std::deque<PendingSend> queue;
+		std::chrono::steady_clock::time_point paused_until;
+	};
+
+	Lane& get_lane(const HttpRateLimitKey& key);
+	void load_budgets();
+	void dispatch_ready();
+
+	std::map<HttpEndpointFamily, double> budgets;
+	std::map<HttpRateLimitKey, Lane> lanes;
+	SendGate send_gate;
+
+	QTimer* dispatch_timer = nullptr;
+	bool dispatching = false;
+};
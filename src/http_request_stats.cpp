@@ -0,0 +1,257 @@
+#include "http_request_stats.h"
+
+#include <cstddef>
+
+#include <algorithm>
+#include <map>
+
+#include "assert.h"
+
+static std::optional<std::chrono::milliseconds> get_percentile(std::vector<std::chrono::milliseconds>& values, const double percentile)
+{
+	if (values.size() == 0)
+	{
+		return std::nullopt;
+	}
+
+	const size_t rank = std::min(values.size() - 1, static_cast<size_t>(percentile * static_cast<double>(values.size())));
+	std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(rank), values.end());
+	return values[rank];
+}
+
+static QVariant format_msecs(const std::optional<std::chrono::milliseconds>& value)
+{
+	if (value)
+	{
+		return QString{ "%1 ms" }.arg(value->count());
+	}
+	return QString{ "-" };
+}
+
+static QVariant format_percent(const double rate)
+{
+	return QString{ "%1%" }.arg(rate * 100.0, 0, 'f', 1);
+}
+
+HttpRequestStats::HttpRequestStats(const std::chrono::seconds interval, const size_t max_samples) : interval{ interval }, max_samples{ max_samples }
+{
+
+}
+
+void HttpRequestStats::record(const HttpRequestSample& sample)
+{
+	if (first_sample.has_value() == false)
+	{
+		first_sample = sample.finished;
+	}
+	samples.push_back(sample);
+	trim_samples(sample.finished);
+}
+
+void HttpRequestStats::clear()
+{
+	samples.clear();
+	first_sample = std::nullopt;
+}
+
+std::vector<HttpEndpointStats> HttpRequestStats::get_endpoint_stats(const std::chrono::steady_clock::time_point now)
+{
+	trim_samples(now);
+
+	std::vector<HttpEndpointStats> result;
+	if (samples.size() == 0 || first_sample.has_value() == false)
+	{
+		return result;
+	}
+
+	// Never divide by less than a second so the first few requests do not show an absurd rate
+	const auto elapsed = std::min<std::chrono::steady_clock::duration>(interval, now - *first_sample);
+	const double elapsed_seconds = std::max(1.0, std::chrono::duration<double>(elapsed).count());
+
+	std::map<HttpEndpointFamily, std::vector<const HttpRequestSample*>> by_family;
+	std::vector<const HttpRequestSample*> all_samples;
+	all_samples.reserve(samples.size());
+	for (const HttpRequestSample& this_sample : samples)
+	{
+		by_family[this_sample.family].push_back(&this_sample);
+		all_samples.push_back(&this_sample);
+	}
+
+	for (const auto& [family, family_samples] : by_family)
+	{
+		result.push_back(summarize(family, family_samples, elapsed_seconds));
+	}
+	result.push_back(summarize(std::nullopt, all_samples, elapsed_seconds));
+	return result;
+}
+
+void HttpRequestStats::trim_samples(const std::chrono::steady_clock::time_point now)
+{
+	while (samples.size() > 0 && (samples.size() > max_samples || now - samples.front().finished > interval))
+	{
+		samples.pop_front();
+	}
+}
+
+HttpEndpointStats HttpRequestStats::summarize(const std::optional<HttpEndpointFamily> family, const std::vector<const HttpRequestSample*>& family_samples, const double elapsed_seconds) const
+{
+	OCTASSERT(family_samples.size() > 0);
+
+	HttpEndpointStats result;
+	result.family = family;
+	result.request_count = family_samples.size();
+
+	size_t error_count = 0;
+	size_t http_429_count = 0;
+	size_t retry_count = 0;
+	std::int64_t bytes_received = 0;
+	std::chrono::microseconds handler_time{ 0 };
+	std::vector<std::chrono::milliseconds> latencies;
+	std::vector<std::chrono::milliseconds> first_bytes;
+	std::vector<std::chrono::milliseconds> queue_waits;
+	for (const HttpRequestSample* const this_sample : family_samples)
+	{
+		if (this_sample->http_status == "429")
+		{
+			http_429_count++;
+		}
+		else if (this_sample->timed_out || this_sample->http_status == "" || this_sample->http_status.startsWith('5'))
+		{
+			error_count++;
+		}
+		if (this_sample->retry)
+		{
+			retry_count++;
+		}
+		bytes_received += this_sample->bytes_received;
+		handler_time += this_sample->handler_time;
+
+		// Timeouts would only show the timeout itself, leave them out of the latency figures
+		if (this_sample->timed_out == false)
+		{
+			if (this_sample->timing.total)
+			{
+				latencies.push_back(*this_sample->timing.total);
+			}
+			if (this_sample->timing.first_byte)
+			{
+				first_bytes.push_back(*this_sample->timing.first_byte);
+			}
+		}
+		if (this_sample->timing.queue_wait)
+		{
+			queue_waits.push_back(*this_sample->timing.queue_wait);
+		}
+	}
+
+	const double count = static_cast<double>(family_samples.size());
+	result.requests_per_second = count / elapsed_seconds;
+	result.error_rate = static_cast<double>(error_count) / count;
+	result.http_429_rate = static_cast<double>(http_429_count) / count;
+	result.retry_rate = static_cast<double>(retry_count) / count;
+	result.latency_p50 = get_percentile(latencies, 0.50);
+	result.latency_p95 = get_percentile(latencies, 0.95);
+	result.latency_p99 = get_percentile(latencies, 0.99);
+	result.first_byte_p50 = get_percentile(first_bytes, 0.50);
+	result.queue_wait_p50 = get_percentile(queue_waits, 0.50);
+	result.handler_load = std::chrono::duration<double>(handler_time).count() / elapsed_seconds;
+	result.bytes_received_per_second = static_cast<double>(bytes_received) / elapsed_seconds;
+	return result;
+}
+
+HttpRequestStatsModel::HttpRequestStatsModel(QObject* parent) : QAbstractTableModel{ parent }
+{
+
+}
+
+void HttpRequestStatsModel::set_stats(const std::vector<HttpEndpointStats>& new_stats)
+{
+	beginResetModel();
+	stats = new_stats;
+	endResetModel();
+}
+
+QVariant HttpRequestStatsModel::data(const QModelIndex& index, const int role) const
+{
+	if (role == Qt::DisplayRole && index.row() < static_cast<int>(stats.size()))
+	{
+		const HttpEndpointStats& this_stats = stats.at(static_cast<size_t>(index.row()));
+		switch (index.column())
+		{
+		case 0:
+			return this_stats.family ? get_enum_string(*this_stats.family) : QString{ "All" };
+		case 1:
+			return QString{ "%1" }.arg(this_stats.requests_per_second, 0, 'f', 1);
+		case 2:
+			return format_msecs(this_stats.latency_p50);
+		case 3:
+			return format_msecs(this_stats.latency_p95);
+		case 4:
+			return format_msecs(this_stats.latency_p99);
+		case 5:
+			return format_msecs(this_stats.first_byte_p50);
+		case 6:
+			return format_msecs(this_stats.queue_wait_p50);
+		case 7:
+			return format_percent(this_stats.error_rate);
+		case 8:
+			return format_percent(this_stats.http_429_rate);
+		case 9:
+			return format_percent(this_stats.retry_rate);
+		case 10:
+			return format_percent(this_stats.handler_load);
+		case 11:
+			return QString{ "%1" }.arg(this_stats.bytes_received_per_second / 1024.0, 0, 'f', 1);
+		default:
+			break;
+		}
+	}
+	return QVariant{};
+}
+
+int HttpRequestStatsModel::columnCount(const QModelIndex&) const
+{
+	return 12;
+}
+
+int HttpRequestStatsModel::rowCount(const QModelIndex&) const
+{
+	return static_cast<int>(stats.size());
+}
+
+QVariant HttpRequestStatsModel::headerData(const int section, const Qt::Orientation orientation, const int role) const
+{
+	if (orientation == Qt::Horizontal && role == Qt::DisplayRole)
+	{
+		switch (section)
+		{
+		case 0:
+			return "Endpoint";
+		case 1:
+			return "Req/s";
+		case 2:
+			return "p50";
+		case 3:
+			return "p95";
+		case 4:
+			return "p99";
+		case 5:
+			return "First byte p50";
+		case 6:
+			return "Queue wait p50";
+		case 7:
+			return "Errors";
+		case 8:
+			return "HTTP 429";
+		case 9:
+			return "Retries";
+		case 10:
+			return "Handler load";
+		case 11:
+			return "KiB/s";
+		default:
+			break;
+		}
+	}
+	return QVariant{};
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <chrono>
+#include <deque>
+#include <optional>
+#include <vector>
+
+#include <Qt>
+#include <QAbstractTableModel>
+#include <QModelIndex>
+#include <QString>
+#include <QVariant>
+
+#include "util_enum.h"
+
+// Durations for each phase of a single request, phases that did not happen are left empty
+class HttpRequestTiming
+{
+public:
+	// Time spent waiting for a rate limit token or an open circuit breaker
+	std::optional<std::chrono::milliseconds> queue_wait;
+	// Only present when a new connection was opened for this request
+	// Qt does not report when host lookup or the TCP handshake finish, so this covers both along with the TLS handshake
+	std::optional<std::chrono::milliseconds> connect;
+	// Time from sending the request until the response headers arrived
+	std::optional<std::chrono::milliseconds> first_byte;
+	std::optional<std::chrono::milliseconds> total;
+};
+
+class HttpRequestSample
+{
+public:
+	HttpEndpointFamily family = HttpEndpointFamily::Other;
+	std::chrono::steady_clock::time_point finished;
+	HttpRequestTiming timing;
+	// Empty for network errors and timeouts
+	QString http_status;
+	bool timed_out = false;
+	bool retry = false;
+	std::int64_t bytes_sent = 0;
+	std::int64_t bytes_received = 0;
+	// Time spent in the callbacks handling the response, this is where parsing and writing to disk happens
+	std::chrono::microseconds handler_time{ 0 };
+};
+
+class HttpEndpointStats
+{
+public:
+	// Empty for the entry combining all families
+	std::optional<HttpEndpointFamily> family;
+	size_t request_count = 0;
+	double requests_per_second = 0.0;
+	double error_rate = 0.0;
+	double http_429_rate = 0.0;
+	double retry_rate = 0.0;
+	std::optional<std::chrono::milliseconds> latency_p50;
+	std::optional<std::chrono::milliseconds> latency_p95;
+	std::optional<std::chrono::milliseconds> latency_p99;
+	std::optional<std::chrono::milliseconds> first_byte_p50;
+	std::optional<std::chrono::milliseconds> queue_wait_p50;
+	// Fraction of the interval spent in response handlers, close to 1.0 means the client is the bottleneck
+	double handler_load = 0.0;
+	double bytes_received_per_second = 0.0;
+};
+
+// Keeps the requests that finished in a trailing interval and summarizes them per endpoint family
+class HttpRequestStats
+{
+public:
+	HttpRequestStats(std::chrono::seconds interval, size_t max_samples);
+
+	void record(const HttpRequestSample& sample);
+	void clear();
+
+	// One entry per family with requests in the interval, followed by a combined entry for all families
+	std::vector<HttpEndpointStats> get_endpoint_stats(std::chrono::steady_clock::time_point now);
+	std::chrono::seconds get_interval() const { return interval; }
+
+private:
+	void trim_samples(std::chrono::steady_clock::time_point now);
+	HttpEndpointStats summarize(std::optional<HttpEndpointFamily> family, const std::vector<const HttpRequestSample*>& family_samples, double elapsed_seconds) const;
+
+	std::chrono::seconds interval;
+	size_t max_samples;
+	std::deque<HttpRequestSample> samples;
+	// Until a full interval has passed since this time, rates are measured over the shorter period
+	std::optional<std::chrono::steady_clock::time_point> first_sample;
+};
+
+class HttpRequestStatsModel : public QAbstractTableModel
+{
+	Q_OBJECT
+public:
+	HttpRequestStatsModel(QObject* parent);
+
+	void set_stats(const std::vector<HttpEndpointStats>& stats);
+
+	virtual QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+	virtual int columnCount(const QModelIndex& parent = QModelIndex{}) const override;
+	virtual int rowCount(const QModelIndex& parent = QModelIndex{}) const override;
+	virtual QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+	std::vector<HttpEndpointStats> stats;
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <chrono>
+#include <optional>
+
+#include <QByteArray>
+#include <QList>
+#include <QNetworkReply>
+#include <QString>
+
+#include "util_enum.h"
+
+// Everything a DataRequest needs from a finished reply, one instance may be delivered to several requests
+class HttpResponse
+{
+public:
+	QNetworkReply::NetworkError error = QNetworkReply::NetworkError::NoError;
+	// Empty if no http response was received
+	QString http_status;
+	QByteArray body;
+	QList<QNetworkReply::RawHeaderPair> headers;
+
+	// Set if the server asked for a pause, this has already been applied to the rate limiter
+	std::optional<std::chrono::milliseconds> rate_limit_wait;
+	// HTTP/2 failed at the protocol level, the same request should be sent again over HTTP/1.1
+	bool http2_failed = false;
+
+	HttpResponseSource source = HttpResponseSource::Network;
+};
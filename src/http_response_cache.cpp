@@ -0,0 +1,158 @@
+#include "http_response_cache.h"
+
+#include <iterator>
+
+#include <QByteArray>
+#include <QNetworkRequest>
+#include <QRegularExpression>
+#include <QRegularExpressionMatch>
+#include <QUrl>
+#include <QUrlQuery>
+
+// Larger bodies are almost always bulk data that will not be read again soon
+static constexpr size_t MAX_CACHED_BODY_BYTES = 1024 * 1024;
+
+std::optional<std::chrono::milliseconds> HttpResponseCache::get_ttl(const HttpEndpointFamily family)
+{
+	switch (family)
+	{
+	case HttpEndpointFamily::StandardDatastoreList:
+		return std::chrono::milliseconds{ 30000 };
+	case HttpEndpointFamily::StandardDatastoreEntryList:
+	case HttpEndpointFamily::StandardDatastoreVersionList:
+	case HttpEndpointFamily::UserRestriction:
+		return std::chrono::milliseconds{ 10000 };
+	case HttpEndpointFamily::StandardDatastoreEntryRead:
+	case HttpEndpointFamily::OrderedDatastore:
+		return std::chrono::milliseconds{ 5000 };
+	case HttpEndpointFamily::MemoryStoreSortedMap:
+	case HttpEndpointFamily::MessagingService:
+	case HttpEndpointFamily::StandardDatastoreSnapshot:
+	case HttpEndpointFamily::Universe:
+	case HttpEndpointFamily::Other:
+		return std::nullopt;
+	}
+	return std::nullopt;
+}
+
+QString HttpResponseCache::get_cache_key(const QNetworkRequest& request)
+{
+	// Different api keys may not have the same permissions, never share responses between them
+	return QString::fromUtf8(request.rawHeader("x-api-key")) + "\n" + request.url().toString();
+}
+
+bool HttpResponseCache::is_changed_by_write(const QNetworkRequest& read_request, const QNetworkRequest& write_request)
+{
+	return Scope::from_request(read_request).is_changed_by_write(Scope::from_request(write_request));
+}
+
+HttpResponseCache::HttpResponseCache(const size_t max_entries, const size_t max_bytes) : max_entries{ max_entries }, max_bytes{ max_bytes }
+{
+
+}
+
+std::optional<HttpResponse> HttpResponseCache::find(const QString& cache_key, const std::chrono::steady_clock::time_point now)
+{
+	const auto map_it = entries_by_key.find(cache_key);
+	if (map_it == entries_by_key.end())
+	{
+		return std::nullopt;
+	}
+
+	const std::list<CacheEntry>::iterator entry_it = map_it->second;
+	if (now >= entry_it->expires)
+	{
+		erase(entry_it);
+		return std::nullopt;
+	}
+
+	entries.splice(entries.begin(), entries, entry_it);
+	HttpResponse result = entry_it->response;
+	result.source = HttpResponseSource::Cache;
+	return result;
+}
+
+void HttpResponseCache::insert(const QString& cache_key, const QNetworkRequest& request, const HttpResponse& response, const std::chrono::steady_clock::time_point expires)
+{
+	const size_t body_bytes = static_cast<size_t>(response.body.size());
+	if (body_bytes > MAX_CACHED_BODY_BYTES)
+	{
+		return;
+	}
+
+	const auto existing_it = entries_by_key.find(cache_key);
+	if (existing_it != entries_by_key.end())
+	{
+		erase(existing_it->second);
+	}
+
+	entries.push_front(CacheEntry{ cache_key, Scope::from_request(request), response, expires });
+	entries_by_key[cache_key] = entries.begin();
+	total_bytes += body_bytes;
+
+	while (entries.size() > 0 && (entries.size() > max_entries || total_bytes > max_bytes))
+	{
+		erase(std::prev(entries.end()));
+	}
+}
+
+void HttpResponseCache::invalidate_for_write(const QNetworkRequest& request)
+{
+	const Scope write_scope = Scope::from_request(request);
+	for (auto it = entries.begin(); it != entries.end();)
+	{
+		const auto next_it = std::next(it);
+		if (it->scope.is_changed_by_write(write_scope))
+		{
+			erase(it);
+		}
+		it = next_it;
+	}
+}
+
+bool HttpResponseCache::Scope::is_changed_by_write(const Scope& write_scope) const
+{
+	if (universe != write_scope.universe)
+	{
+		return false;
+	}
+	// Universe-level listings such as the datastore list may change with any write
+	return resource == write_scope.resource || resource.isEmpty() || write_scope.resource.isEmpty();
+}
+
+HttpResponseCache::Scope HttpResponseCache::Scope::from_request(const QNetworkRequest& request)
+{
+	const QUrl url = request.url();
+	const QString path = url.path();
+
+	Scope result;
+
+	static const QRegularExpression universe_regex{ "/universes/(\\d+)" };
+	const QRegularExpressionMatch universe_match = universe_regex.match(path);
+	result.universe = QString::fromUtf8(request.rawHeader("x-api-key")) + "\n" + (universe_match.hasMatch() ? universe_match.captured(1) : QString{});
+
+	if (path.startsWith("/datastores/v1/"))
+	{
+		// Standard datastore v1 endpoints identify the datastore in the query
+		result.resource = QUrlQuery{ url }.queryItemValue("datastoreName", QUrl::FullyDecoded);
+	}
+	else
+	{
+		// Cloud v2 endpoints look like '/universes/{id}/{collection}/{name}/...'
+		static const QRegularExpression resource_regex{ "/universes/\\d+/([^/:]+)/([^/:]+)" };
+		const QRegularExpressionMatch resource_match = resource_regex.match(path);
+		if (resource_match.hasMatch())
+		{
+			result.resource = resource_match.captured(1) + "/" + resource_match.captured(2);
+		}
+	}
+
+	return result;
+}
+
+void HttpResponseCache::erase(const std::list<CacheEntry>::iterator it)
+{
+	total_bytes -= static_cast<size_t>(it->response.body.size());
+	entries_by_key.erase(it->cache_key);
+	entries.erase(it);
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+
+#include <chrono>
+#include <list>
+#include <map>
+#include <optional>
+
+#include <QString>
+
+#include "http_response.h"
+#include "util_enum.h"
+
+class QNetworkRequest;
+
+// Bounded LRU cache of successful GET responses, entries expire after a short per-endpoint TTL
+class HttpResponseCache
+{
+public:
+	// Returns nullopt for endpoint families that should never be cached
+	static std::optional<std::chrono::milliseconds> get_ttl(HttpEndpointFamily family);
+	static QString get_cache_key(const QNetworkRequest& request);
+	// True when a write sent with write_request may change what read_request returns
+	static bool is_changed_by_write(const QNetworkRequest& read_request, const QNetworkRequest& write_request);
+
+	HttpResponseCache(size_t max_entries, size_t max_bytes);
+
+	std::optional<HttpResponse> find(const QString& cache_key, std::chrono::steady_clock::time_point now);
+	void insert(const QString& cache_key, const QNetworkRequest& request, const HttpResponse& response, std::chrono::steady_clock::time_point expires);
+
+	// Drops everything a write to this request's datastore, map, or other resource may have changed
+	void invalidate_for_write(const QNetworkRequest& request);
+
+private:
+	class Scope
+	{
+	public:
+		static Scope from_request(const QNetworkRequest& request);
+
+		bool is_changed_by_write(const Scope& write_scope) const;
+
+		// Api key and universe, nothing is shared across these
+		QString universe;
+		// Datastore or other resource name, empty for universe-level listings
+		QString resource;
+	};
+
+	class CacheEntry
+	{
+	public:
+		QString cache_key;
+		Scope scope;
+		HttpResponse response;
+		std::chrono::steady_clock::time_point expires;
+	};
+
+	void erase(std::list<CacheEntry>::iterator it);
+
+	size_t max_entries;
+	size_t max_bytes;
+	size_t total_bytes = 0;
+
+	// Most recently used at the front
+	std::list<CacheEntry> entries;
+	std::map<QString, std::list<CacheEntry>::iterator> entries_by_key;
+};
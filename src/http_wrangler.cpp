@@ -1,75 +1,250 @@
 #include "http_wrangler.h"
 
+#include <algorithm>
+#include <iterator>
 #include <memory>
+#include <utility>
 
 #include <QByteArray>
 #include <QNetworkAccessManager>
+#include <QNetworkReply>
 #include <QNetworkRequest>
+#include <QTimer>
 #include <QUrl>
 #include <QVariant>
 
 #include "assert.h"
+#include "http_rate_limit_headers.h"
+#include "http_rate_limiter.h"
+#include "profile.h"
+#include "roblox_time.h"
 #include "util_enum.h"
 
-static constexpr size_t LOG_MAX_ENTRIES = 2000;
+static constexpr std::chrono::milliseconds LOG_FLUSH_INTERVAL{ 16 };
+static constexpr size_t RESPONSE_CACHE_MAX_ENTRIES = 256;
+static constexpr size_t RESPONSE_CACHE_MAX_BYTES = 16 * 1024 * 1024;
+static constexpr std::chrono::seconds REQUEST_STATS_INTERVAL{ 60 };
+static constexpr size_t REQUEST_STATS_MAX_SAMPLES = 20000;
 
-HttpLogEntry::HttpLogEntry(HttpRequestType type, const QString& url) : _timestamp{ QDateTime::currentDateTime() }, _type{type}, _url{url}
+static QVariant format_log_msecs(const std::optional<std::chrono::milliseconds>& value)
+{
+	if (value)
+	{
+		return static_cast<qlonglong>(value->count());
+	}
+	return QVariant{};
+}
+
+HttpLogEntry::HttpLogEntry(const std::uint64_t id, const HttpRequestType type, const QString& url) : _id{ id }, _timestamp{ QDateTime::currentDateTime() }, _type{ type }, _url{ url }
 {
 
 }
 
-HttpLogModel::HttpLogModel(QObject* parent, const std::vector<HttpLogEntry>& entries) : QAbstractTableModel{ parent }, entries{ entries }
+void HttpLogEntry::set_request_info(const QString& operation, const size_t retry_count, const std::int64_t bytes_sent)
 {
+	_operation = operation;
+	_retry_count = retry_count;
+	_bytes_sent = bytes_sent;
+}
 
+void HttpLogEntry::set_result(const QString& http_status, const std::int64_t bytes_received, const HttpRequestTiming& timing)
+{
+	_http_status = http_status;
+	_bytes_received = bytes_received;
+	_timing = timing;
 }
 
-std::optional<HttpLogEntry> HttpLogModel::get_entry(const std::size_t row_index) const
+HttpLogBuffer::HttpLogBuffer(const std::size_t capacity) : capacity{ std::max<std::size_t>(capacity, 1) }
 {
-	if (row_index < entries.size())
+
+}
+
+void HttpLogBuffer::push(const HttpLogEntry& entry)
+{
+	if (slots.size() < capacity)
 	{
-		// We need to return these in reverse order because new events are at the end of the vector
-		return entries.at(convert_offset(row_index));
+		slots.push_back(entry);
 	}
 	else
 	{
-		return std::nullopt;
+		slots[head] = entry;
+		head = (head + 1) % slots.size();
+	}
+	end_sequence++;
+}
+
+void HttpLogBuffer::clear()
+{
+	slots.clear();
+	head = 0;
+}
+
+void HttpLogBuffer::set_capacity(const std::size_t new_capacity)
+{
+	const std::size_t clamped_capacity = std::max<std::size_t>(new_capacity, 1);
+	const std::size_t kept_count = std::min(slots.size(), clamped_capacity);
+
+	// Unroll the ring so the oldest kept entry is at the front
+	std::vector<HttpLogEntry> new_slots;
+	new_slots.reserve(kept_count);
+	for (std::uint64_t sequence = end_sequence - kept_count; sequence < end_sequence; sequence++)
+	{
+		new_slots.push_back(slots[get_slot_index(sequence)]);
+	}
+	slots = std::move(new_slots);
+	head = 0;
+	capacity = clamped_capacity;
+}
+
+const HttpLogEntry* HttpLogBuffer::find_sequence(const std::uint64_t sequence) const
+{
+	if (sequence < get_begin_sequence() || sequence >= end_sequence)
+	{
+		return nullptr;
+	}
+	return &slots[get_slot_index(sequence)];
+}
+
+std::optional<std::uint64_t> HttpLogBuffer::find_id(const std::uint64_t id) const
+{
+	// Ids are handed out in the same order entries are pushed, so they are sorted by sequence
+	std::uint64_t low = get_begin_sequence();
+	std::uint64_t high = end_sequence;
+	while (low < high)
+	{
+		const std::uint64_t mid = low + (high - low) / 2;
+		if (slots[get_slot_index(mid)].id() < id)
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+	if (low < end_sequence && slots[get_slot_index(low)].id() == id)
+	{
+		return low;
+	}
+	return std::nullopt;
+}
+
+HttpLogEntry* HttpLogBuffer::get_mutable(const std::uint64_t sequence)
+{
+	if (sequence < get_begin_sequence() || sequence >= end_sequence)
+	{
+		return nullptr;
+	}
+	return &slots[get_slot_index(sequence)];
+}
+
+std::size_t HttpLogBuffer::get_slot_index(const std::uint64_t sequence) const
+{
+	OCTASSERT(sequence >= get_begin_sequence() && sequence < end_sequence);
+	return static_cast<std::size_t>((head + (sequence - get_begin_sequence())) % slots.size());
+}
+
+HttpLogModel::HttpLogModel(QObject* parent, const HttpLogBuffer& log_buffer) :
+	QAbstractTableModel{ parent },
+	log_buffer{ log_buffer },
+	begin_sequence{ log_buffer.get_begin_sequence() },
+	end_sequence{ log_buffer.get_end_sequence() }
+{
+
+}
+
+std::optional<HttpLogEntry> HttpLogModel::get_entry(const std::size_t row_index) const
+{
+	if (const HttpLogEntry* const entry = get_row_entry(row_index))
+	{
+		return *entry;
 	}
+	return std::nullopt;
 }
 
-void HttpLogModel::append_entry(const HttpLogEntry& entry)
+void HttpLogModel::sync(const std::uint64_t first_updated_sequence)
 {
 	const QModelIndex parent_index;
-	beginInsertRows(parent_index, 0, 1);
-	entries.push_back(entry);
-	endInsertRows();
-	while (entries.size() > LOG_MAX_ENTRIES)
+
+	// Evicted entries are the oldest, which are the bottom rows
+	const std::uint64_t log_begin = log_buffer.get_begin_sequence();
+	if (begin_sequence < log_begin && begin_sequence < end_sequence)
 	{
-		beginRemoveRows(parent_index, static_cast<int>(entries.size() - 2), static_cast<int>(entries.size() - 1));
-		entries.erase(entries.begin(), entries.begin() + 1);
+		const std::uint64_t evicted_end = std::min(log_begin, end_sequence);
+		const int first_row = static_cast<int>(end_sequence - evicted_end);
+		const int last_row = static_cast<int>(end_sequence - 1 - begin_sequence);
+		beginRemoveRows(parent_index, first_row, last_row);
+		begin_sequence = evicted_end;
 		endRemoveRows();
 	}
+	if (begin_sequence == end_sequence)
+	{
+		begin_sequence = std::max(log_begin, end_sequence);
+		end_sequence = begin_sequence;
+	}
+
+	// New entries go on top, anything pushed and evicted between syncs is never shown
+	const std::uint64_t new_begin = std::max(end_sequence, log_begin);
+	const std::uint64_t new_end = log_buffer.get_end_sequence();
+	if (new_end > new_begin)
+	{
+		beginInsertRows(parent_index, 0, static_cast<int>(new_end - new_begin - 1));
+		end_sequence = new_end;
+		endInsertRows();
+	}
+
+	if (first_updated_sequence < end_sequence && begin_sequence < end_sequence)
+	{
+		const std::uint64_t oldest_updated = std::max(first_updated_sequence, begin_sequence);
+		const int last_row = static_cast<int>(end_sequence - 1 - oldest_updated);
+		emit dataChanged(index(0, 0), index(last_row, columnCount() - 1));
+	}
 }
 
 QVariant HttpLogModel::data(const QModelIndex& index, const int role) const
 {
 	if (role == Qt::DisplayRole)
 	{
-		if (index.row() < static_cast<int>(entries.size()))
+		if (index.row() >= 0)
 		{
-			const std::size_t row_index = convert_offset(index.row());
-			if (index.column() == 0)
+			const HttpLogEntry* const entry_ptr = get_row_entry(static_cast<std::size_t>(index.row()));
+			if (entry_ptr == nullptr)
 			{
-				return entries.at(row_index).timestamp().toString(Qt::ISODateWithMs);
+				return QVariant{};
 			}
-			else if (index.column() == 1)
+			const HttpLogEntry& entry = *entry_ptr;
+			switch (index.column())
 			{
-				return get_enum_string(entries.at(row_index).type());
-			}
-			else if (index.column() == 2 || index.column() == 3)
+			case 0:
+				return entry.timestamp().toString(Qt::ISODateWithMs);
+			case 1:
+				return get_enum_string(entry.type());
+			case 2:
+				return entry.protocol();
+			case 3:
+				return entry.http_status();
+			case 4:
+				return entry.operation();
+			case 5:
+				return static_cast<qulonglong>(entry.retry_count());
+			case 6:
+				return format_log_msecs(entry.timing().queue_wait);
+			case 7:
+				return format_log_msecs(entry.timing().connect);
+			case 8:
+				return format_log_msecs(entry.timing().first_byte);
+			case 9:
+				return format_log_msecs(entry.timing().total);
+			case 10:
+				return static_cast<qlonglong>(entry.bytes_sent());
+			case 11:
+				return static_cast<qlonglong>(entry.bytes_received());
+			case 12:
+			case 13:
 			{
-				const QString& url = entries.at(row_index).url();
+				const QString& url = entry.url();
 				qsizetype paramIndex = url.indexOf('?');
-				if (index.column() == 2)
+				if (index.column() == 12)
 				{
 					if (paramIndex >= 0)
 					{
@@ -92,6 +267,9 @@ QVariant HttpLogModel::data(const QModelIndex& index, const int role) const
 					}
 				}
 			}
+			default:
+				break;
+			}
 		}
 	}
 	return QVariant{};
@@ -99,43 +277,63 @@ QVariant HttpLogModel::data(const QModelIndex& index, const int role) const
 
 int HttpLogModel::columnCount(const QModelIndex&) const
 {
-	return 4;
+	return 14;
 }
 
 int HttpLogModel::rowCount(const QModelIndex&) const
 {
-	return static_cast<int>(entries.size());
+	return static_cast<int>(end_sequence - begin_sequence);
 }
 
 QVariant HttpLogModel::headerData(int section, Qt::Orientation orientation, int role) const
 {
 	if (orientation == Qt::Horizontal && role == Qt::DisplayRole)
 	{
-		if (section == 0)
+		switch (section)
 		{
+		case 0:
 			return "Time";
-		}
-		else if (section == 1)
-		{
+		case 1:
 			return "Method";
-		}
-		else if (section == 2)
-		{
+		case 2:
+			return "Protocol";
+		case 3:
+			return "Status";
+		case 4:
+			return "Operation";
+		case 5:
+			return "Retry";
+		case 6:
+			return "Queued (ms)";
+		case 7:
+			return "Connect (ms)";
+		case 8:
+			return "First byte (ms)";
+		case 9:
+			return "Total (ms)";
+		case 10:
+			return "Sent (B)";
+		case 11:
+			return "Received (B)";
+		case 12:
 			return "Base URL";
-		}
-		else if (section == 3)
-		{
+		case 13:
 			return "URL Params";
+		default:
+			break;
 		}
 	}
 	return QVariant{};
 }
 
-std::size_t HttpLogModel::convert_offset(std::size_t in) const
+const HttpLogEntry* HttpLogModel::get_row_entry(const std::size_t row_index) const
 {
-	// We need to index elements in the opposite of the order of the vector
-	OCTASSERT(in < entries.size());
-	return entries.size() - 1 - in;
+	if (row_index >= end_sequence - begin_sequence)
+	{
+		return nullptr;
+	}
+	// Rows are newest first, the buffer is oldest first
+	return log_buffer.find_sequence(end_sequence - 1 - row_index);
 }
 
 const std::unique_ptr<HttpWrangler>& HttpWrangler::get()
@@ -144,10 +342,138 @@ const std::unique_ptr<HttpWrangler>& HttpWrangler::get()
 	return wrangler;
 }
 
-QNetworkReply* HttpWrangler::send(HttpRequestType type, QNetworkRequest& request, const std::optional<QString>& body)
+std::uint64_t HttpWrangler::submit(
+	const HttpRequestType type,
+	const QNetworkRequest& request,
+	const std::optional<QString>& body,
+	const HttpSendOptions& options,
+	QObject* const context,
+	const std::function<void()>& on_sent,
+	const ResponseCallback& on_finished
+)
+{
+	const std::uint64_t ticket = next_ticket++;
+	const Waiter waiter{ ticket, context, on_finished };
+	const HttpRateLimitKey key = HttpRateLimitKey::from_request(type, request);
+
+	if (type == HttpRequestType::Get && options.use_cache)
+	{
+		const std::optional<HttpResponse> cached_response = response_cache.find(HttpResponseCache::get_cache_key(request), std::chrono::steady_clock::now());
+		if (cached_response)
+		{
+			HttpLogEntry log_entry{ next_log_id++, type, request.url().toString() };
+			log_entry.set_request_info(options.operation, options.retry_count, 0);
+			log_entry.set_protocol("Cache");
+			log_entry.set_result(cached_response->http_status, cached_response->body.size(), HttpRequestTiming{});
+			add_log_entry(log_entry);
+
+			// Always deliver asynchronously so callers see the same ordering as a network reply
+			// The timer belongs to the wrangler so the ticket is erased even if the context is destroyed first
+			queued_tickets.insert(ticket);
+			on_sent();
+			QTimer::singleShot(0, this, [this, waiter, response = *cached_response]() {
+				if (queued_tickets.erase(waiter.ticket) > 0 && waiter.context.isNull() == false)
+				{
+					waiter.on_finished(response);
+				}
+			});
+			return ticket;
+		}
+	}
+
+	// Joining a reply that is already on the wire does not spend any rate limit budget
+	if (try_join(type, request, options, waiter))
+	{
+		on_sent();
+		return ticket;
+	}
+
+	queued_tickets.insert(ticket);
+	const auto queued_at = std::chrono::steady_clock::now();
+	rate_limiter->enqueue(key, context, [this, type, request, body, options, waiter, on_sent, queued_at]() {
+		if (queued_tickets.erase(waiter.ticket) == 0)
+		{
+			// Cancelled while waiting for a token
+			return;
+		}
+		if (try_join(type, request, options, waiter) == false)
+		{
+			const auto queue_wait = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - queued_at);
+			start_request(type, request, body, options, waiter, queue_wait);
+		}
+		on_sent();
+	}, [this, ticket]() {
+		queued_tickets.erase(ticket);
+	});
+	return ticket;
+}
+
+void HttpWrangler::cancel(const std::uint64_t ticket, const bool timed_out)
+{
+	if (queued_tickets.erase(ticket) > 0)
+	{
+		return;
+	}
+
+	for (auto flight_it = in_flight.begin(); flight_it != in_flight.end(); ++flight_it)
+	{
+		std::vector<Waiter>& waiters = flight_it->second.waiters;
+		const auto matches_ticket = [ticket](const Waiter& this_waiter) { return this_waiter.ticket == ticket; };
+		const auto waiter_it = std::find_if(waiters.begin(), waiters.end(), matches_ticket);
+		if (waiter_it == waiters.end())
+		{
+			continue;
+		}
+		waiters.erase(waiter_it);
+
+		QNetworkReply* const reply = flight_it->first;
+		if (flight_it->second.coalesce_key && timed_out)
+		{
+			// A reply that has timed out for one request should not pick up any new ones
+			coalescable_gets.erase(*flight_it->second.coalesce_key);
+			flight_it->second.coalesce_key = std::nullopt;
+		}
+		if (timed_out)
+		{
+			const HttpEndpointFamily family = HttpRateLimitKey::from_request(flight_it->second.type, flight_it->second.request).get_family();
+			record_result(family, true);
+
+			HttpRequestSample sample;
+			sample.family = family;
+			sample.finished = std::chrono::steady_clock::now();
+			sample.timing = flight_it->second.get_timing(sample.finished);
+			sample.timed_out = true;
+			sample.retry = flight_it->second.options.retry_count > 0;
+			sample.bytes_sent = flight_it->second.bytes_sent;
+			request_stats.record(sample);
+		}
+		if (waiters.size() == 0)
+		{
+			if (flight_it->second.coalesce_key)
+			{
+				coalescable_gets.erase(*flight_it->second.coalesce_key);
+			}
+			update_log_entry(flight_it->second.log_id, [](HttpLogEntry& log_entry) {
+				log_entry.set_protocol("Cancelled");
+			});
+			in_flight.erase(flight_it);
+			reply->disconnect(this);
+			reply->abort();
+			reply->deleteLater();
+		}
+		return;
+	}
+}
+
+QNetworkReply* HttpWrangler::send(const HttpRequestType type, QNetworkRequest& request, const std::optional<QByteArray>& body, const HttpSendOptions& options, std::uint64_t& log_id)
 {
-	request.setAttribute(QNetworkRequest::Attribute::Http2AllowedAttribute, false);
-	add_log_entry(HttpLogEntry{ type, request.url().toString() });
+	// Many HTTP/2 streams can share one connection, HTTP/1.1 is limited to a small pool of connections per host
+	request.setAttribute(QNetworkRequest::Attribute::Http2AllowedAttribute, options.allow_http2 && http2_disabled == false);
+	HttpLogEntry log_entry{ next_log_id++, type, request.url().toString() };
+	log_entry.set_request_info(options.operation, options.retry_count, body ? body->size() : 0);
+	add_log_entry(log_entry);
+	log_id = log_entry.id();
+
 	switch (type)
 	{
 	case HttpRequestType::Get:
@@ -156,7 +482,7 @@ QNetworkReply* HttpWrangler::send(HttpRequestType type, QNetworkRequest& request
 	case HttpRequestType::Patch:
 		if (body)
 		{
-			return network_access_manager->sendCustomRequest(request, "PATCH", body->toUtf8());
+			return network_access_manager->sendCustomRequest(request, "PATCH", *body);
 		}
 		else
 		{
@@ -165,7 +491,7 @@ QNetworkReply* HttpWrangler::send(HttpRequestType type, QNetworkRequest& request
 	case HttpRequestType::Post:
 		if (body)
 		{
-			return network_access_manager->post(request, body->toUtf8());
+			return network_access_manager->post(request, *body);
 		}
 		else
 		{
@@ -178,28 +504,336 @@ QNetworkReply* HttpWrangler::send(HttpRequestType type, QNetworkRequest& request
 	}
 }
 
+void HttpWrangler::start_request(const HttpRequestType type, const QNetworkRequest& request, const std::optional<QString>& body, const HttpSendOptions& options, const Waiter& waiter, const std::chrono::milliseconds queue_wait)
+{
+	if (type != HttpRequestType::Get)
+	{
+		response_cache.invalidate_for_write(request);
+		forget_coalescable_gets_for_write(request);
+	}
+
+	std::optional<QByteArray> body_bytes;
+	if (body)
+	{
+		body_bytes = body->toUtf8();
+	}
+
+	QNetworkRequest request_copy = request;
+	std::uint64_t log_id = 0;
+	QNetworkReply* const reply = send(type, request_copy, body_bytes, options, log_id);
+	if (reply == nullptr)
+	{
+		return;
+	}
+
+	std::optional<QString> coalesce_key;
+	if (type == HttpRequestType::Get)
+	{
+		coalesce_key = HttpResponseCache::get_cache_key(request);
+		coalescable_gets[*coalesce_key] = reply;
+	}
+	InFlight flight{ type, request_copy, options, log_id, coalesce_key, std::vector<Waiter>{ waiter } };
+	flight.bytes_sent = body_bytes ? body_bytes->size() : 0;
+	flight.queue_wait = queue_wait;
+	flight.started = std::chrono::steady_clock::now();
+	in_flight.insert_or_assign(reply, std::move(flight));
+
+	track_reply_timing(reply);
+	connect(reply, &QNetworkReply::finished, this, [this, reply]() {
+		handle_reply_finished(reply);
+	});
+}
+
+bool HttpWrangler::try_join(const HttpRequestType type, const QNetworkRequest& request, const HttpSendOptions& options, const Waiter& waiter)
+{
+	if (type != HttpRequestType::Get)
+	{
+		return false;
+	}
+
+	const auto coalesce_it = coalescable_gets.find(HttpResponseCache::get_cache_key(request));
+	if (coalesce_it == coalescable_gets.end())
+	{
+		return false;
+	}
+	const auto flight_it = in_flight.find(coalesce_it->second);
+	if (flight_it == in_flight.end())
+	{
+		return false;
+	}
+
+	flight_it->second.waiters.push_back(waiter);
+
+	HttpLogEntry log_entry{ next_log_id++, type, request.url().toString() };
+	log_entry.set_request_info(options.operation, options.retry_count, 0);
+	log_entry.set_protocol("Shared");
+	add_log_entry(log_entry);
+	return true;
+}
+
+void HttpWrangler::forget_coalescable_gets_for_write(const QNetworkRequest& write_request)
+{
+	for (auto it = coalescable_gets.begin(); it != coalescable_gets.end();)
+	{
+		const auto next_it = std::next(it);
+		const auto flight_it = in_flight.find(it->second);
+		// The GET itself keeps running for the waiters that already joined it
+		if (flight_it == in_flight.end() || HttpResponseCache::is_changed_by_write(flight_it->second.request, write_request))
+		{
+			coalescable_gets.erase(it);
+		}
+		it = next_it;
+	}
+}
+
+void HttpWrangler::track_reply_timing(QNetworkReply* const reply)
+{
+	// Each phase only keeps the first time it was seen, redirects and resends can repeat the signals
+	const auto mark_phase = [this, reply](std::optional<std::chrono::steady_clock::time_point> InFlight::* phase) {
+		const auto flight_it = in_flight.find(reply);
+		if (flight_it != in_flight.end() && (flight_it->second.*phase).has_value() == false)
+		{
+			flight_it->second.*phase = std::chrono::steady_clock::now();
+		}
+	};
+#if QT_VERSION >= QT_VERSION_CHECK(6, 3, 0)
+	connect(reply, &QNetworkReply::socketStartedConnecting, this, [mark_phase]() {
+		mark_phase(&InFlight::connect_started);
+	});
+#endif
+	connect(reply, &QNetworkReply::encrypted, this, [mark_phase]() {
+		mark_phase(&InFlight::encrypted);
+	});
+	connect(reply, &QNetworkReply::metaDataChanged, this, [mark_phase]() {
+		mark_phase(&InFlight::first_byte);
+	});
+}
+
+void HttpWrangler::record_result(const HttpEndpointFamily family, const bool server_failure)
+{
+	HttpCircuitBreaker& breaker = circuit_breakers[family];
+	const bool state_changed = server_failure ? breaker.record_failure(std::chrono::steady_clock::now()) : breaker.record_success();
+	if (state_changed)
+	{
+		emit circuit_state_changed();
+		// Requests held back by the breaker can go out now, or must wait for the next probe
+		rate_limiter->wake();
+	}
+}
+
+bool HttpWrangler::is_http2_failure(QNetworkReply* const reply) const
+{
+	if (reply->request().attribute(QNetworkRequest::Attribute::Http2AllowedAttribute).toBool() == false)
+	{
+		return false;
+	}
+	const QNetworkReply::NetworkError error = reply->error();
+	return
+		error == QNetworkReply::NetworkError::ProtocolFailure ||
+		error == QNetworkReply::NetworkError::ProtocolUnknownError ||
+		error == QNetworkReply::NetworkError::ProtocolInvalidOperationError;
+}
+
+std::vector<HttpEndpointStats> HttpWrangler::get_request_stats()
+{
+	return request_stats.get_endpoint_stats(std::chrono::steady_clock::now());
+}
+
 void HttpWrangler::clear_log()
 {
-	http_log_entries.clear();
+	http_log.clear();
+	request_stats.clear();
+	schedule_log_flush();
+}
+
+void HttpWrangler::set_log_capacity(const std::size_t capacity)
+{
+	http_log.set_capacity(capacity);
+	schedule_log_flush();
 }
 
 HttpLogModel* HttpWrangler::make_log_model(QObject* parent)
 {
-	return new HttpLogModel{ parent, http_log_entries };
+	return new HttpLogModel{ parent, http_log };
+}
+
+std::optional<std::chrono::milliseconds> HttpWrangler::acquire_circuit(const HttpEndpointFamily family)
+{
+	HttpCircuitBreaker& breaker = circuit_breakers[family];
+	const HttpCircuitState state_before = breaker.get_state();
+	const std::optional<std::chrono::milliseconds> wait = breaker.try_acquire(std::chrono::steady_clock::now());
+	if (breaker.get_state() != state_before)
+	{
+		emit circuit_state_changed();
+	}
+	return wait;
 }
 
 void HttpWrangler::add_log_entry(const HttpLogEntry& log_entry)
 {
-	http_log_entries.push_back(log_entry);
-	if (http_log_entries.size() > LOG_MAX_ENTRIES)
+	http_log.push(log_entry);
+	schedule_log_flush();
+}
+
+void HttpWrangler::update_log_entry(const std::uint64_t log_id, const std::function<void(HttpLogEntry&)>& update)
+{
+	if (const std::optional<std::uint64_t> sequence = http_log.find_id(log_id))
+	{
+		update(*http_log.get_mutable(*sequence));
+		log_first_updated_sequence = std::min(*sequence, log_first_updated_sequence.value_or(*sequence));
+		schedule_log_flush();
+	}
+}
+
+void HttpWrangler::schedule_log_flush()
+{
+	if (log_flush_pending)
+	{
+		return;
+	}
+	log_flush_pending = true;
+
+	// Views are notified about once per frame no matter how many requests finish in between
+	QTimer::singleShot(LOG_FLUSH_INTERVAL, this, [this]() {
+		log_flush_pending = false;
+		const std::uint64_t first_updated_sequence = log_first_updated_sequence.value_or(http_log.get_end_sequence());
+		log_first_updated_sequence = std::nullopt;
+		emit log_changed(first_updated_sequence);
+	});
+}
+
+void HttpWrangler::handle_reply_finished(QNetworkReply* const reply)
+{
+	reply->deleteLater();
+
+	const auto flight_it = in_flight.find(reply);
+	if (flight_it == in_flight.end())
+	{
+		return;
+	}
+	const InFlight flight = std::move(flight_it->second);
+	in_flight.erase(flight_it);
+	if (flight.coalesce_key)
+	{
+		const auto coalesce_it = coalescable_gets.find(*flight.coalesce_key);
+		if (coalesce_it != coalescable_gets.end() && coalesce_it->second == reply)
+		{
+			coalescable_gets.erase(coalesce_it);
+		}
+	}
+
+	const auto finished = std::chrono::steady_clock::now();
+	const HttpRequestTiming timing = flight.get_timing(finished);
+
+	HttpResponse response;
+	response.error = reply->error();
+	response.http_status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toString();
+	response.body = reply->readAll();
+	response.headers = reply->rawHeaderPairs();
+	RobloxTime::update_time_from_headers(response.headers);
+
+	QString protocol = "-";
+	if (response.http_status != "")
+	{
+		protocol = reply->attribute(QNetworkRequest::Attribute::Http2WasUsedAttribute).toBool() ? "HTTP/2" : "HTTP/1.1";
+	}
+	update_log_entry(flight.log_id, [&protocol, &response, &timing](HttpLogEntry& log_entry) {
+		log_entry.set_protocol(protocol);
+		log_entry.set_result(response.http_status, response.body.size(), timing);
+	});
+
+	const HttpRateLimitKey key = HttpRateLimitKey::from_request(flight.type, flight.request);
+	if (is_http2_failure(reply))
+	{
+		// Stay on HTTP/1.1 once anything has gone wrong rather than flip-flopping
+		http2_disabled = true;
+		response.http2_failed = true;
+	}
+	else
+	{
+		const bool server_failure = response.http_status == "" || response.http_status == "500" || response.http_status == "502" || response.http_status == "504";
+		record_result(key.get_family(), server_failure);
+	}
+
+	// The server may say a budget is exhausted before it starts rejecting requests
+	response.rate_limit_wait = HttpRateLimitHeaders::parse(response.headers).get_wait_time(response.http_status == "429");
+	if (response.rate_limit_wait)
+	{
+		rate_limiter->pause(key, *response.rate_limit_wait);
+	}
+
+	if (flight.type != HttpRequestType::Get)
+	{
+		// Catch any GETs for the same resource that were sent or finished while this write was in flight
+		response_cache.invalidate_for_write(flight.request);
+		forget_coalescable_gets_for_write(flight.request);
+	}
+	else if (flight.options.use_cache && response.http_status == "200")
+	{
+		const std::optional<std::chrono::milliseconds> ttl = HttpResponseCache::get_ttl(key.get_family());
+		if (ttl)
+		{
+			response_cache.insert(HttpResponseCache::get_cache_key(flight.request), flight.request, response, std::chrono::steady_clock::now() + *ttl);
+		}
+	}
+
+	HttpRequestSample sample;
+	sample.family = key.get_family();
+	sample.finished = finished;
+	sample.timing = timing;
+	sample.http_status = response.http_status;
+	sample.retry = flight.options.retry_count > 0;
+	sample.bytes_sent = flight.bytes_sent;
+	sample.bytes_received = response.body.size();
+
+	const auto handlers_started = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < flight.waiters.size(); i++)
+	{
+		const Waiter& this_waiter = flight.waiters[i];
+		if (this_waiter.context.isNull() == false)
+		{
+			response.source = i == 0 ? HttpResponseSource::Network : HttpResponseSource::Shared;
+			this_waiter.on_finished(response);
+		}
+	}
+
+	sample.handler_time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - handlers_started);
+	request_stats.record(sample);
+}
+
+HttpRequestTiming HttpWrangler::InFlight::get_timing(const std::chrono::steady_clock::time_point finished) const
+{
+	const auto to_msecs = [](const std::chrono::steady_clock::duration duration) {
+		return std::chrono::duration_cast<std::chrono::milliseconds>(duration);
+	};
+
+	HttpRequestTiming timing;
+	timing.queue_wait = queue_wait;
+	if (encrypted)
 	{
-		const auto erase_count = static_cast<std::vector<HttpLogEntry>::difference_type>(http_log_entries.size() - LOG_MAX_ENTRIES);
-		http_log_entries.erase(http_log_entries.begin(), http_log_entries.begin() + erase_count);
+		// Without the connecting signal the time spent waiting for a free connection is included as well
+		timing.connect = to_msecs(*encrypted - connect_started.value_or(started));
 	}
-	emit log_entry_added(log_entry);
+	if (first_byte)
+	{
+		timing.first_byte = to_msecs(*first_byte - started);
+	}
+	timing.total = to_msecs(finished - started);
+	return timing;
 }
 
-HttpWrangler::HttpWrangler(ConstructorToken)
+HttpWrangler::HttpWrangler(ConstructorToken) :
+	response_cache{ RESPONSE_CACHE_MAX_ENTRIES, RESPONSE_CACHE_MAX_BYTES },
+	request_stats{ REQUEST_STATS_INTERVAL, REQUEST_STATS_MAX_SAMPLES },
+	http_log{ UserProfile::get().get_http_log_capacity() }
 {
 	network_access_manager = new QNetworkAccessManager(this);
+	rate_limiter = new HttpRateLimiter{ this };
+	rate_limiter->set_send_gate([this](const HttpRateLimitKey& key) {
+		return acquire_circuit(key.get_family());
+	});
+
+	connect(&(UserProfile::get()), &UserProfile::http_log_capacity_changed, this, [this]() {
+		set_log_capacity(UserProfile::get().get_http_log_capacity());
+	});
 }
@@ -1,80 +1,246 @@
 #pragma once
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <map>
 #include <memory>
 #include <optional>
+#include <set>
 #include <vector>
 
 #include <Qt>
 #include <QAbstractTableModel>
+#include <QByteArray>
 #include <QDateTime>
 #include <QModelIndex>
+#include <QNetworkRequest>
 #include <QObject>
+#include <QPointer>
 #include <QString>
 
-enum class HttpRequestType : std::uint8_t;
+#include "http_circuit_breaker.h"
+#include "http_request_stats.h"
+#include "http_response.h"
+#include "http_response_cache.h"
+#include "util_enum.h"
 
+class HttpRateLimiter;
 class QNetworkAccessManager;
 class QNetworkReply;
-class QNetworkRequest;
 
 class HttpLogEntry
 {
 public:
-	HttpLogEntry(HttpRequestType type, const QString& url);
+	HttpLogEntry(std::uint64_t id, HttpRequestType type, const QString& url);
 
+	std::uint64_t id() const { return _id; }
 	const QDateTime& timestamp() const { return _timestamp; }
 	HttpRequestType type() const { return _type; }
 	const QString& url() const { return _url; }
+	const QString& operation() const { return _operation; }
+	size_t retry_count() const { return _retry_count; }
+	std::int64_t bytes_sent() const { return _bytes_sent; }
+	// Everything below is empty until the reply has finished
+	const QString& protocol() const { return _protocol; }
+	const QString& http_status() const { return _http_status; }
+	std::int64_t bytes_received() const { return _bytes_received; }
+	const HttpRequestTiming& timing() const { return _timing; }
+
+	void set_request_info(const QString& operation, size_t retry_count, std::int64_t bytes_sent);
+	void set_protocol(const QString& protocol) { _protocol = protocol; }
+	void set_result(const QString& http_status, std::int64_t bytes_received, const HttpRequestTiming& timing);
 
 private:
+	std::uint64_t _id;
 	QDateTime _timestamp;
 	HttpRequestType _type;
 	QString _url;
+	QString _operation;
+	size_t _retry_count = 0;
+	std::int64_t _bytes_sent = 0;
+	QString _protocol;
+	QString _http_status;
+	std::int64_t _bytes_received = 0;
+	HttpRequestTiming _timing;
 };
 
+// Fixed capacity ring buffer of log entries, the oldest entry is overwritten once it is full
+// Every entry pushed gets a sequence number, these keep increasing across evictions and clears
+class HttpLogBuffer
+{
+public:
+	explicit HttpLogBuffer(std::size_t capacity);
+
+	void push(const HttpLogEntry& entry);
+	void clear();
+	void set_capacity(std::size_t capacity);
+
+	std::size_t get_capacity() const { return capacity; }
+	std::size_t size() const { return slots.size(); }
+	// Sequence number of the oldest entry still held and one past the newest
+	std::uint64_t get_begin_sequence() const { return end_sequence - slots.size(); }
+	std::uint64_t get_end_sequence() const { return end_sequence; }
+
+	// Returns nullptr once the entry has been evicted
+	const HttpLogEntry* find_sequence(std::uint64_t sequence) const;
+	std::optional<std::uint64_t> find_id(std::uint64_t id) const;
+	HttpLogEntry* get_mutable(std::uint64_t sequence);
+
+private:
+	std::size_t get_slot_index(std::uint64_t sequence) const;
+
+	std::size_t capacity;
+	std::vector<HttpLogEntry> slots;
+	// Slot holding the oldest entry, only nonzero once the buffer has wrapped around
+	std::size_t head = 0;
+	std::uint64_t end_sequence = 0;
+};
+
+// A view into the wrangler's log buffer, call sync when HttpWrangler::log_changed is emitted
 class HttpLogModel : public QAbstractTableModel
 {
 	Q_OBJECT
 public:
-	HttpLogModel(QObject* parent, const std::vector<HttpLogEntry>& entries);
+	HttpLogModel(QObject* parent, const HttpLogBuffer& log_buffer);
 
 	std::optional<HttpLogEntry> get_entry(std::size_t row_index) const;
-	void append_entry(const HttpLogEntry& entry);
+	void sync(std::uint64_t first_updated_sequence);
 
 	virtual QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
 	virtual int columnCount(const QModelIndex& parent = QModelIndex{}) const override;
 	virtual int rowCount(const QModelIndex& parent = QModelIndex{}) const override;
 	virtual QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
 
-	std::vector<HttpLogEntry> entries;
-
 private:
-	std::size_t convert_offset(std::size_t in) const;
+	const HttpLogEntry* get_row_entry(std::size_t row_index) const;
+
+	const HttpLogBuffer& log_buffer;
+	// Range of sequence numbers currently shown as rows, newest first
+	std::uint64_t begin_sequence;
+	std::uint64_t end_sequence;
+};
+
+class HttpSendOptions
+{
+public:
+	// HTTP/2 is only used when both the caller allows it and it has not previously failed
+	bool allow_http2 = false;
+	// GET responses may be served from and stored in the short-lived response cache
+	bool use_cache = true;
+
+	// Only used to label the request in the HTTP log and statistics
+	QString operation;
+	size_t retry_count = 0;
 };
 
 class HttpWrangler : public QObject
 {
 	Q_OBJECT
 public:
+	using ResponseCallback = std::function<void(const HttpResponse&)>;
+
 	static const std::unique_ptr<HttpWrangler>& get();
 
-	QNetworkReply* send(HttpRequestType type, QNetworkRequest& request, const std::optional<QString>& body = std::nullopt);
+	// Queues the request behind the shared rate limiter, on_sent is called once it is on the wire and on_finished once it is complete
+	// Identical GETs share a single reply and recent GET responses may be served from the cache
+	// No callbacks are made after context is destroyed or the returned ticket is cancelled
+	std::uint64_t submit(
+		HttpRequestType type,
+		const QNetworkRequest& request,
+		const std::optional<QString>& body,
+		const HttpSendOptions& options,
+		QObject* context,
+		const std::function<void()>& on_sent,
+		const ResponseCallback& on_finished
+	);
+	// Stops waiting for a submitted request, timed out requests count as a failure for the circuit breaker
+	void cancel(std::uint64_t ticket, bool timed_out);
+
+	const std::map<HttpEndpointFamily, HttpCircuitBreaker>& get_circuit_breakers() const { return circuit_breakers; }
+	bool is_http2_disabled() const { return http2_disabled; }
+
+	// Aggregates for requests that finished recently, see HttpRequestStats
+	std::vector<HttpEndpointStats> get_request_stats();
+	std::chrono::seconds get_request_stats_interval() const { return request_stats.get_interval(); }
+	size_t get_queued_count() const { return queued_tickets.size(); }
+	size_t get_in_flight_count() const { return in_flight.size(); }
 
 	void clear_log();
+	void set_log_capacity(std::size_t capacity);
+	const HttpLogBuffer& get_log() const { return http_log; }
 	HttpLogModel* make_log_model(QObject* parent);
 
 signals:
-	void log_entry_added(HttpLogEntry log_entry);
+	// Batches every log change since the last emit, entries from first_updated_sequence onward may have been modified
+	void log_changed(std::uint64_t first_updated_sequence);
+	void circuit_state_changed();
 
 private:
 	class ConstructorToken {};
 
+	class Waiter
+	{
+	public:
+		std::uint64_t ticket;
+		QPointer<QObject> context;
+		ResponseCallback on_finished;
+	};
+
+	class InFlight
+	{
+	public:
+		HttpRequestType type;
+		QNetworkRequest request;
+		HttpSendOptions options;
+		std::uint64_t log_id;
+		std::optional<QString> coalesce_key;
+		std::vector<Waiter> waiters;
+
+		std::int64_t bytes_sent = 0;
+		std::chrono::milliseconds queue_wait{ 0 };
+		std::chrono::steady_clock::time_point started;
+		std::optional<std::chrono::steady_clock::time_point> connect_started;
+		std::optional<std::chrono::steady_clock::time_point> encrypted;
+		std::optional<std::chrono::steady_clock::time_point> first_byte;
+
+		HttpRequestTiming get_timing(std::chrono::steady_clock::time_point finished) const;
+	};
+
+	QNetworkReply* send(HttpRequestType type, QNetworkRequest& request, const std::optional<QByteArray>& body, const HttpSendOptions& options, std::uint64_t& log_id);
+	void start_request(HttpRequestType type, const QNetworkRequest& request, const std::optional<QString>& body, const HttpSendOptions& options, const Waiter& waiter, std::chrono::milliseconds queue_wait);
+	bool try_join(HttpRequestType type, const QNetworkRequest& request, const HttpSendOptions& options, const Waiter& waiter);
+	// GETs already in flight may return what was there before the write, later GETs must not join them
+	void forget_coalescable_gets_for_write(const QNetworkRequest& write_request);
+	void track_reply_timing(QNetworkReply* reply);
+
+	void record_result(HttpEndpointFamily family, bool server_failure);
+	bool is_http2_failure(QNetworkReply* reply) const;
+
 	void add_log_entry(const HttpLogEntry& log_entry);
+	void update_log_entry(std::uint64_t log_id, const std::function<void(HttpLogEntry&)>& update);
+	void schedule_log_flush();
+	void handle_reply_finished(QNetworkReply* reply);
+	std::optional<std::chrono::milliseconds> acquire_circuit(HttpEndpointFamily family);
 
 	QNetworkAccessManager* network_access_manager;
-	std::vector<HttpLogEntry> http_log_entries;
+	HttpRateLimiter* rate_limiter;
+	HttpResponseCache response_cache;
+	std::map<HttpEndpointFamily, HttpCircuitBreaker> circuit_breakers;
+	HttpRequestStats request_stats;
+	HttpLogBuffer http_log;
+	std::uint64_t next_log_id = 1;
+	bool log_flush_pending = false;
+	std::optional<std::uint64_t> log_first_updated_sequence;
+
+	std::uint64_t next_ticket = 1;
+	// Tickets that have not yet been sent or joined to a reply
+	std::set<std::uint64_t> queued_tickets;
+	std::map<QNetworkReply*, InFlight> in_flight;
+	std::map<QString, QNetworkReply*> coalescable_gets;
+
+	bool http2_disabled = false;
 
 public:
 	HttpWrangler(ConstructorToken token);
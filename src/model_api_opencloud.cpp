@@ -61,9 +61,9 @@ static std::optional<QString> extract_string(const QJsonObject& obj, const QStri
 	return std::nullopt;
 }
 
-std::optional<GetMemoryStoreSortedMapItemListResponse> GetMemoryStoreSortedMapItemListResponse::from_json(const long long universe_id, const QString& map_name, const QString& json)
+std::optional<GetMemoryStoreSortedMapItemListResponse> GetMemoryStoreSortedMapItemListResponse::from_json(const long long universe_id, const QString& map_name, const QByteArray& json)
 {
-	QJsonDocument doc = QJsonDocument::fromJson(json.toUtf8());
+	QJsonDocument doc = QJsonDocument::fromJson(json);
 	QJsonObject root = doc.object();
 
 	std::vector<MemoryStoreSortedMapItem> items;
@@ -117,9 +117,9 @@ std::optional<GetMemoryStoreSortedMapItemListResponse> GetMemoryStoreSortedMapIt
 	return std::nullopt;
 }
 
-std::optional<GetOrderedDatastoreEntryDetailsV2Response> GetOrderedDatastoreEntryDetailsV2Response::from_json(long long universe_id, const QString& datastore_name, const QString& scope, [[maybe_unused]] const QString& key_name, const QString& json)
+std::optional<GetOrderedDatastoreEntryDetailsV2Response> GetOrderedDatastoreEntryDetailsV2Response::from_json(long long universe_id, const QString& datastore_name, const QString& scope, [[maybe_unused]] const QString& key_name, const QByteArray& json)
 {
-	QJsonDocument doc = QJsonDocument::fromJson(json.toUtf8());
+	QJsonDocument doc = QJsonDocument::fromJson(json);
 	QJsonObject root = doc.object();
 
 	std::optional<QString> path_opt;
@@ -171,9 +171,9 @@ std::optional<GetOrderedDatastoreEntryDetailsV2Response> GetOrderedDatastoreEntr
 	}
 }
 
-std::optional<GetOrderedDatastoreEntryListV2Response> GetOrderedDatastoreEntryListV2Response::from_json(const long long universe_id, const QString& datastore_name, const QString& scope, const QString& json)
+std::optional<GetOrderedDatastoreEntryListV2Response> GetOrderedDatastoreEntryListV2Response::from_json(const long long universe_id, const QString& datastore_name, const QString& scope, const QByteArray& json)
 {
-	QJsonDocument doc = QJsonDocument::fromJson(json.toUtf8());
+	QJsonDocument doc = QJsonDocument::fromJson(json);
 	QJsonObject root = doc.object();
 
 	std::vector<OrderedDatastoreEntryFull> entries;
@@ -250,9 +250,9 @@ std::optional<GetOrderedDatastoreEntryListV2Response> GetOrderedDatastoreEntryLi
 	return GetOrderedDatastoreEntryListV2Response{ entries, page_token };
 }
 
-std::optional<GetStandardDatastoreListResponse> GetStandardDatastoreListResponse::from_json(const QString& json)
+std::optional<GetStandardDatastoreListResponse> GetStandardDatastoreListResponse::from_json(const QByteArray& json)
 {
-	QJsonDocument doc = QJsonDocument::fromJson(json.toUtf8());
+	QJsonDocument doc = QJsonDocument::fromJson(json);
 	QJsonObject root = doc.object();
 
 	std::vector<QString> datastores_vec;
@@ -302,9 +302,9 @@ std::optional<GetStandardDatastoreListResponse> GetStandardDatastoreListResponse
 	}
 }
 
-std::optional<GetStandardDatastoreEntryListResponse> GetStandardDatastoreEntryListResponse::from_json(const QString& json, const long long universe_id, const QString& datastore_name)
+std::optional<GetStandardDatastoreEntryListResponse> GetStandardDatastoreEntryListResponse::from_json(const QByteArray& json, const long long universe_id, const QString& datastore_name)
 {
-	QJsonDocument doc = QJsonDocument::fromJson(json.toUtf8());
+	QJsonDocument doc = QJsonDocument::fromJson(json);
 	QJsonObject root = doc.object();
 
 	std::vector<StandardDatastoreEntryName> entries_vec;
@@ -370,20 +370,20 @@ std::optional<GetStandardDatastoreEntryListResponse> GetStandardDatastoreEntryLi
 	}
 }
 
-std::optional<GetStandardDatastoreEntryDetailsResponse> GetStandardDatastoreEntryDetailsResponse::from(long long universe_id, const QString& datastore_name, const QString& scope, const QString& key_name, const QString& version, const std::optional<QString>& userids, const std::optional<QString>& attributes, const QString& body)
+std::optional<GetStandardDatastoreEntryDetailsResponse> GetStandardDatastoreEntryDetailsResponse::from(long long universe_id, const QString& datastore_name, const QString& scope, const QString& key_name, const QString& version, const std::optional<QString>& userids, const std::optional<QString>& attributes, const QByteArray& body)
 {
 	return GetStandardDatastoreEntryDetailsResponse{ universe_id, datastore_name, scope, key_name, version, userids, attributes, body };
 }
 
-GetStandardDatastoreEntryDetailsResponse::GetStandardDatastoreEntryDetailsResponse(long long universe_id, const QString& datastore_name, const QString& scope, const QString& key_name, const QString& version, const std::optional<QString>& userids, const std::optional<QString>& attributes, const QString& data) :
+GetStandardDatastoreEntryDetailsResponse::GetStandardDatastoreEntryDetailsResponse(long long universe_id, const QString& datastore_name, const QString& scope, const QString& key_name, const QString& version, const std::optional<QString>& userids, const std::optional<QString>& attributes, const QByteArray& data) :
 	details{ universe_id, datastore_name, scope, key_name, version, userids, attributes, data}
 {
 
 }
 
-std::optional<GetStandardDatastoreEntryVersionListResponse> GetStandardDatastoreEntryVersionListResponse::from(const QString& json)
+std::optional<GetStandardDatastoreEntryVersionListResponse> GetStandardDatastoreEntryVersionListResponse::from(const QByteArray& json)
 {
-	QJsonDocument doc = QJsonDocument::fromJson(json.toUtf8());
+	QJsonDocument doc = QJsonDocument::fromJson(json);
 	QJsonObject root = doc.object();
 
 	std::vector<StandardDatastoreEntryVersion> versions_vec;
@@ -489,9 +489,9 @@ std::optional<GetStandardDatastoreEntryVersionListResponse> GetStandardDatastore
 	}
 }
 
-std::optional<GetUniverseDetailsResponse> GetUniverseDetailsResponse::from(const QString& json)
+std::optional<GetUniverseDetailsResponse> GetUniverseDetailsResponse::from(const QByteArray& json)
 {
-	QJsonDocument doc = QJsonDocument::fromJson(json.toUtf8());
+	QJsonDocument doc = QJsonDocument::fromJson(json);
 	QJsonObject root = doc.object();
 
 	QJsonObject::iterator display_name_it = root.find("displayName");
@@ -514,9 +514,9 @@ std::optional<GetUniverseDetailsResponse> GetUniverseDetailsResponse::from(const
 	}
 }
 
-std::optional<GetUserRestrictionListV2Response> GetUserRestrictionListV2Response::from(const QString& json)
+std::optional<GetUserRestrictionListV2Response> GetUserRestrictionListV2Response::from(const QByteArray& json)
 {
-	const QJsonDocument doc = QJsonDocument::fromJson(json.toUtf8());
+	const QJsonDocument doc = QJsonDocument::fromJson(json);
 	QJsonObject root = doc.object();
 
 	std::vector<BanListUserRestriction> user_restrictions_vec;
@@ -586,9 +586,9 @@ std::optional<GetUserRestrictionListV2Response> GetUserRestrictionListV2Response
 	return GetUserRestrictionListV2Response{ user_restrictions_vec, next_page_token };
 }
 
-std::optional<PostStandardDatastoreSnapshotResponseV2> PostStandardDatastoreSnapshotResponseV2::from(const QString& json)
+std::optional<PostStandardDatastoreSnapshotResponseV2> PostStandardDatastoreSnapshotResponseV2::from(const QByteArray& json)
 {
-	const QJsonDocument doc = QJsonDocument::fromJson(json.toUtf8());
+	const QJsonDocument doc = QJsonDocument::fromJson(json);
 	const QJsonObject root = doc.object();
 
 	const std::optional<bool> new_snapshot = extract_bool(root, "newSnapshotTaken");
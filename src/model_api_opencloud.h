@@ -3,6 +3,7 @@
 #include <optional>
 #include <vector>
 
+#include <QByteArray>
 #include <QString>
 
 #include "model_common.h"
@@ -10,7 +11,7 @@
 class GetMemoryStoreSortedMapItemListResponse
 {
 public:
-	static std::optional<GetMemoryStoreSortedMapItemListResponse> from_json(long long universe_id, const QString& datastore_name, const QString& json);
+	static std::optional<GetMemoryStoreSortedMapItemListResponse> from_json(long long universe_id, const QString& datastore_name, const QByteArray& json);
 
 	const std::vector<MemoryStoreSortedMapItem>& get_items() const { return items; }
 	const std::optional<QString> get_next_page_token() const { return next_page_token; }
@@ -26,7 +27,7 @@ private:
 class GetOrderedDatastoreEntryDetailsV2Response
 {
 public:
-	static std::optional<GetOrderedDatastoreEntryDetailsV2Response> from_json(long long universe_id, const QString& datastore_name, const QString& scope, const QString& key_name, const QString& json);
+	static std::optional<GetOrderedDatastoreEntryDetailsV2Response> from_json(long long universe_id, const QString& datastore_name, const QString& scope, const QString& key_name, const QByteArray& json);
 
 	OrderedDatastoreEntryFull get_details() const { return details; }
 
@@ -40,7 +41,7 @@ private:
 class GetOrderedDatastoreEntryListV2Response
 {
 public:
-	static std::optional<GetOrderedDatastoreEntryListV2Response> from_json(long long universe_id, const QString& datastore_name, const QString& scope, const QString& json);
+	static std::optional<GetOrderedDatastoreEntryListV2Response> from_json(long long universe_id, const QString& datastore_name, const QString& scope, const QByteArray& json);
 
 	const std::vector<OrderedDatastoreEntryFull>& get_entries() const { return entries; }
 	const std::optional<QString> get_next_page_token() const { return next_page_token; }
@@ -57,7 +58,7 @@ private:
 class GetStandardDatastoreListResponse
 {
 public:
-	static std::optional<GetStandardDatastoreListResponse> from_json(const QString& json);
+	static std::optional<GetStandardDatastoreListResponse> from_json(const QByteArray& json);
 
 	const std::vector<QString>& get_datastores_vec() const { return datastores_vec; }
 	const std::optional<QString>& get_cursor() const { return cursor; }
@@ -72,7 +73,7 @@ private:
 class GetStandardDatastoreEntryListResponse
 {
 public:
-	static std::optional<GetStandardDatastoreEntryListResponse> from_json(const QString& json, long long universe_id, const QString& datastore_name);
+	static std::optional<GetStandardDatastoreEntryListResponse> from_json(const QByteArray& json, long long universe_id, const QString& datastore_name);
 
 	const std::vector<StandardDatastoreEntryName>& get_entries() const { return entries; }
 	const std::optional<QString>& get_cursor() const { return cursor; }
@@ -87,12 +88,12 @@ private:
 class GetStandardDatastoreEntryDetailsResponse
 {
 public:
-	static std::optional<GetStandardDatastoreEntryDetailsResponse> from(long long universe_id, const QString& datastore_name, const QString& scope, const QString& key_name, const QString& version, const std::optional<QString>& userids, const std::optional<QString>& attributes, const QString& body);
+	static std::optional<GetStandardDatastoreEntryDetailsResponse> from(long long universe_id, const QString& datastore_name, const QString& scope, const QString& key_name, const QString& version, const std::optional<QString>& userids, const std::optional<QString>& attributes, const QByteArray& body);
 
 	StandardDatastoreEntryFull get_details() const { return details; }
 
 private:
-	GetStandardDatastoreEntryDetailsResponse(long long universe_id, const QString& datastore_name, const QString& scope, const QString& key_name, const QString& version, const std::optional<QString>& userids, const std::optional<QString>& attributes, const QString& data);
+	GetStandardDatastoreEntryDetailsResponse(long long universe_id, const QString& datastore_name, const QString& scope, const QString& key_name, const QString& version, const std::optional<QString>& userids, const std::optional<QString>& attributes, const QByteArray& data);
 
 	StandardDatastoreEntryFull details;
 };
@@ -100,7 +101,7 @@ private:
 class GetStandardDatastoreEntryVersionListResponse
 {
 public:
-	static std::optional<GetStandardDatastoreEntryVersionListResponse> from(const QString& json);
+	static std::optional<GetStandardDatastoreEntryVersionListResponse> from(const QByteArray& json);
 
 	const std::vector<StandardDatastoreEntryVersion>& get_versions() const { return versions; }
 	const std::optional<QString>& get_cursor() const { return cursor; }
@@ -115,7 +116,7 @@ private:
 class GetUniverseDetailsResponse
 {
 public:
-	static std::optional<GetUniverseDetailsResponse> from(const QString& json);
+	static std::optional<GetUniverseDetailsResponse> from(const QByteArray& json);
 
 	const QString& get_display_name() const { return display_name; }
 
@@ -128,7 +129,7 @@ private:
 class GetUserRestrictionListV2Response
 {
 public:
-	static std::optional<GetUserRestrictionListV2Response> from(const QString& json);
+	static std::optional<GetUserRestrictionListV2Response> from(const QByteArray& json);
 
 	const std::vector<BanListUserRestriction>& get_restrictions() const { return restrictions; }
 	const std::optional<QString>& get_next_page_token() const { return next_page_token; }
@@ -143,7 +144,7 @@ private:
 class PostStandardDatastoreSnapshotResponseV2
 {
 public:
-	static std::optional<PostStandardDatastoreSnapshotResponseV2> from(const QString& json);
+	static std::optional<PostStandardDatastoreSnapshotResponseV2> from(const QByteArray& json);
 
 	bool get_new_snapshot_taken() const { return new_snapshot_taken; }
 	const QString& get_latest_snapshot_time() const { return latest_snapshot_time; }
@@ -1,5 +1,9 @@
 #include "model_common.h"
 
+#include <algorithm>
+#include <utility>
+
+#include <QCryptographicHash>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonValue>
@@ -28,24 +32,23 @@ QString BanListGameJoinRestrictionUpdate::to_json() const
 	return QString::fromUtf8(json_doc.toJson(QJsonDocument::Compact));
 }
 
-StandardDatastoreEntryFull::StandardDatastoreEntryFull(long long universe_id, const QString& datastore_name, const QString& scope, const QString& key_name, const QString& version, const std::optional<QString>& userids, const std::optional<QString>& attributes, const QString& data) :
+StandardDatastoreEntryFull::StandardDatastoreEntryFull(long long universe_id, const QString& datastore_name, const QString& scope, const QString& key_name, const QString& version, const std::optional<QString>& userids, const std::optional<QString>& attributes, const QByteArray& data) :
 	universe_id{ universe_id }, datastore_name{ datastore_name }, scope{ scope }, key_name{ key_name }, version{ version }, userids{ userids }, attributes{ attributes }, data_raw{ data }
 {
-	data_decoded = data_raw;
-	if (DataValidator::is_json(data))
+	if (DataValidator::is_json(data_raw))
 	{
 		entry_type = DatastoreEntryType::Json;
 	}
-	else if (std::optional<QString> decoded_string = decode_json_string(data))
+	else if (std::optional<QString> decoded_string = decode_json_string(data_raw))
 	{
-		data_decoded = *decoded_string;
+		data_decoded = std::move(*decoded_string);
 		entry_type = DatastoreEntryType::String;
 	}
-	else if (DataValidator::is_number(data))
+	else if (DataValidator::is_number(QString::fromUtf8(data_raw)))
 	{
 		entry_type = DatastoreEntryType::Number;
 	}
-	else if (DataValidator::is_bool(data))
+	else if (data_raw == "true" || data_raw == "false")
 	{
 		entry_type = DatastoreEntryType::Bool;
 	}
@@ -54,3 +57,174 @@ StandardDatastoreEntryFull::StandardDatastoreEntryFull(long long universe_id, co
 		entry_type = DatastoreEntryType::Error;
 	}
 }
+
+StandardDatastoreEntryFull::StandardDatastoreEntryFull(long long universe_id, const QString& datastore_name, const QString& scope, const QString& key_name, const QString& version, const std::optional<QString>& userids, const std::optional<QString>& attributes, const QString& data) :
+	StandardDatastoreEntryFull{ universe_id, datastore_name, scope, key_name, version, userids, attributes, data.toUtf8() }
+{
+
+}
+
+QString StandardDatastoreEntryFull::get_data_decoded() const
+{
+	if (data_decoded)
+	{
+		return *data_decoded;
+	}
+	return QString::fromUtf8(data_raw);
+}
+
+QByteArray StandardDatastoreEntryFull::get_content_hash() const
+{
+	// Optional parts are prefixed by whether they are set and parts are separated, so moving text between them changes the hash
+	QByteArray content;
+	content.append(data_raw);
+	content.append('\0');
+	content.append(userids ? 'u' : '-');
+	if (userids)
+	{
+		content.append(userids->toUtf8());
+	}
+	content.append('\0');
+	content.append(attributes ? 'a' : '-');
+	if (attributes)
+	{
+		content.append(attributes->toUtf8());
+	}
+	return QCryptographicHash::hash(content, QCryptographicHash::Md5);
+}
+
+StandardDatastoreEntryNameList::StandardDatastoreEntryNameList(const std::vector<StandardDatastoreEntryName>& entries)
+{
+	append(entries);
+}
+
+StandardDatastoreEntryName StandardDatastoreEntryNameList::at(const size_t index) const
+{
+	const Entry& entry = entries.at(index);
+	const Source& source = sources.at(entry.source_index);
+	return StandardDatastoreEntryName{ source.universe_id, source.datastore_name, get_key(index), source.scope };
+}
+
+StandardDatastoreEntryName StandardDatastoreEntryNameList::back() const
+{
+	return at(entries.size() - 1);
+}
+
+long long StandardDatastoreEntryNameList::get_universe_id(const size_t index) const
+{
+	return sources.at(entries.at(index).source_index).universe_id;
+}
+
+const QString& StandardDatastoreEntryNameList::get_datastore_name(const size_t index) const
+{
+	return sources.at(entries.at(index).source_index).datastore_name;
+}
+
+const QString& StandardDatastoreEntryNameList::get_scope(const size_t index) const
+{
+	return sources.at(entries.at(index).source_index).scope;
+}
+
+QString StandardDatastoreEntryNameList::get_key(const size_t index) const
+{
+	const std::string_view key = get_key_utf8(entries.at(index));
+	return QString::fromUtf8(key.data(), static_cast<int>(key.size()));
+}
+
+void StandardDatastoreEntryNameList::push_back(const StandardDatastoreEntryName& entry)
+{
+	const QByteArray key = entry.get_key().toUtf8();
+	const std::uint32_t source_index = intern_source(entry.get_universe_id(), entry.get_datastore_name(), entry.get_scope());
+	entries.push_back(Entry{ key_data.size(), static_cast<std::uint32_t>(key.size()), source_index });
+	key_data.append(key.constData(), static_cast<size_t>(key.size()));
+}
+
+void StandardDatastoreEntryNameList::append(const StandardDatastoreEntryNameList& other)
+{
+	entries.reserve(entries.size() + other.entries.size());
+	key_data.reserve(key_data.size() + other.key_data.size());
+	for (const Entry& this_entry : other.entries)
+	{
+		push_back(other.sources.at(this_entry.source_index), other.get_key_utf8(this_entry));
+	}
+}
+
+void StandardDatastoreEntryNameList::append(const std::vector<StandardDatastoreEntryName>& other)
+{
+	entries.reserve(entries.size() + other.size());
+	for (const StandardDatastoreEntryName& this_entry : other)
+	{
+		push_back(this_entry);
+	}
+}
+
+void StandardDatastoreEntryNameList::pop_back()
+{
+	const Entry& entry = entries.back();
+	// Entries are usually consumed in the order they were added, so the key is normally at the end of the buffer
+	if (entry.key_begin + entry.key_size == key_data.size())
+	{
+		key_data.resize(entry.key_begin);
+	}
+	entries.pop_back();
+	if (entries.size() == 0)
+	{
+		key_data.clear();
+	}
+}
+
+void StandardDatastoreEntryNameList::clear()
+{
+	sources.clear();
+	source_indices.clear();
+	entries.clear();
+	key_data.clear();
+}
+
+void StandardDatastoreEntryNameList::sort_by_key()
+{
+	std::sort(entries.begin(), entries.end(), [this](const Entry& a, const Entry& b) {
+		const std::string_view a_key = get_key_utf8(a);
+		const std::string_view b_key = get_key_utf8(b);
+		if (a_key == b_key)
+		{
+			return sources.at(a.source_index).scope < sources.at(b.source_index).scope;
+		}
+		else
+		{
+			return a_key < b_key;
+		}
+	});
+}
+
+std::uint32_t StandardDatastoreEntryNameList::intern_source(const long long universe_id, const QString& datastore_name, const QString& scope)
+{
+	// Entries from one listing share a source, so the most recent one is almost always the match
+	if (sources.size() > 0)
+	{
+		const Source& last_source = sources.back();
+		if (last_source.universe_id == universe_id && last_source.datastore_name == datastore_name && last_source.scope == scope)
+		{
+			return static_cast<std::uint32_t>(sources.size() - 1);
+		}
+	}
+
+	const auto [source_it, inserted] = source_indices.emplace(std::make_tuple(universe_id, datastore_name, scope), static_cast<std::uint32_t>(sources.size()));
+	if (inserted)
+	{
+		sources.push_back(Source{ universe_id, datastore_name, scope });
+	}
+	return source_it->second;
+}
+
+void StandardDatastoreEntryNameList::push_back(const Source& source, const std::string_view key)
+{
+	const std::uint32_t source_index = intern_source(source.universe_id, source.datastore_name, source.scope);
+	entries.push_back(Entry{ key_data.size(), static_cast<std::uint32_t>(key.size()), source_index });
+	key_data.append(key.data(), key.size());
+}
+
+std::string_view StandardDatastoreEntryNameList::get_key_utf8(const Entry& entry) const
+{
+	return std::string_view{ key_data.data() + entry.key_begin, entry.key_size };
+}
@@ -2,8 +2,14 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <map>
 #include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
 
+#include <QByteArray>
 #include <QString>
 
 #include "util_json.h"
@@ -177,6 +183,7 @@ private:
 class StandardDatastoreEntryFull
 {
 public:
+	StandardDatastoreEntryFull(long long universe_id, const QString& datastore_name, const QString& scope, const QString& key_name, const QString& version, const std::optional<QString>& userids, const std::optional<QString>& attributes, const QByteArray& data);
 	StandardDatastoreEntryFull(long long universe_id, const QString& datastore_name, const QString& scope, const QString& key_name, const QString& version, const std::optional<QString>& userids, const std::optional<QString>& attributes, const QString& data);
 
 	long long get_universe_id() const { return universe_id; }
@@ -187,8 +194,11 @@ public:
 	const std::optional<QString>& get_userids() const { return userids; }
 	const std::optional<QString>& get_attributes() const { return attributes; }
 	DatastoreEntryType get_entry_type() const { return entry_type; }
-	const QString& get_data_decoded() const { return data_decoded; }
-	const QString& get_data_raw() const { return data_raw; }
+	QString get_data_decoded() const;
+	QString get_data_raw() const { return QString::fromUtf8(data_raw); }
+	const QByteArray& get_data_raw_utf8() const { return data_raw; }
+	// MD5 of the value, user IDs and attributes, equal for entries that would be written identically
+	QByteArray get_content_hash() const;
 
 private:
 	long long universe_id;
@@ -199,8 +209,9 @@ private:
 	std::optional<QString> userids;
 	std::optional<QString> attributes;
 	DatastoreEntryType entry_type;
-	QString data_decoded;
-	QString data_raw;
+	// Only set for string entries, everything else decodes to the raw data
+	std::optional<QString> data_decoded;
+	QByteArray data_raw;
 };
 
 class StandardDatastoreEntryName
@@ -221,6 +232,62 @@ private:
 	QString scope;
 };
 
+// Holds many entry names in little more memory than their keys take up
+// Universe, datastore and scope are stored once per distinct combination and keys are packed into a single UTF-8 buffer
+class StandardDatastoreEntryNameList
+{
+public:
+	StandardDatastoreEntryNameList() = default;
+	explicit StandardDatastoreEntryNameList(const std::vector<StandardDatastoreEntryName>& entries);
+
+	size_t size() const { return entries.size(); }
+
+	// Names are rebuilt on access, hold on to the result rather than calling this repeatedly
+	StandardDatastoreEntryName at(size_t index) const;
+	StandardDatastoreEntryName back() const;
+
+	long long get_universe_id(size_t index) const;
+	const QString& get_datastore_name(size_t index) const;
+	const QString& get_scope(size_t index) const;
+	QString get_key(size_t index) const;
+
+	void push_back(const StandardDatastoreEntryName& entry);
+	void append(const StandardDatastoreEntryNameList& other);
+	void append(const std::vector<StandardDatastoreEntryName>& other);
+	// Releases the key's storage as well when it was the last one added
+	void pop_back();
+	void clear();
+
+	// Orders by key, then by scope
+	void sort_by_key();
+
+private:
+	class Source
+	{
+	public:
+		long long universe_id;
+		QString datastore_name;
+		QString scope;
+	};
+
+	class Entry
+	{
+	public:
+		size_t key_begin;
+		std::uint32_t key_size;
+		std::uint32_t source_index;
+	};
+
+	std::uint32_t intern_source(long long universe_id, const QString& datastore_name, const QString& scope);
+	void push_back(const Source& source, std::string_view key);
+	std::string_view get_key_utf8(const Entry& entry) const;
+
+	std::vector<Source> sources;
+	std::map<std::tuple<long long, QString, QString>, std::uint32_t> source_indices;
+	std::vector<Entry> entries;
+	std::string key_data;
+};
+
 class StandardDatastoreEntryVersion
 {
 public:
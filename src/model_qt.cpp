@@ -237,18 +237,9 @@ QVariant OrderedDatastoreEntryQTableModel::headerData(int section, Qt::Orientati
 	return QVariant{};
 }
 
-StandardDatastoreEntryQTableModel::StandardDatastoreEntryQTableModel(QObject* parent, const std::vector<StandardDatastoreEntryName>& entries) : QAbstractTableModel{ parent } , entries { entries }
+StandardDatastoreEntryQTableModel::StandardDatastoreEntryQTableModel(QObject* parent, const StandardDatastoreEntryNameList& entries) : QAbstractTableModel{ parent } , entries { entries }
 {
-	std::sort(this->entries.begin(), this->entries.end(), [](const StandardDatastoreEntryName& a, const StandardDatastoreEntryName& b) {
-		if (a.get_key() == b.get_key())
-		{
-			return a.get_scope() < b.get_scope();
-		}
-		else
-		{
-			return a.get_key() < b.get_key();
-		}
-	});
+	this->entries.sort_by_key();
 }
 
 std::optional<StandardDatastoreEntryName> StandardDatastoreEntryQTableModel::get_entry(const size_t row_index) const
@@ -271,11 +262,11 @@ QVariant StandardDatastoreEntryQTableModel::data(const QModelIndex& index, const
 		{
 			if (index.column() == 0)
 			{
-				return entries.at(index.row()).get_scope();
+				return entries.get_scope(index.row());
 			}
 			else if (index.column() == 1)
 			{
-				return entries.at(index.row()).get_key();
+				return entries.get_key(index.row());
 			}
 		}
 	}
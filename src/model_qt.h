@@ -68,7 +68,7 @@ class StandardDatastoreEntryQTableModel : public QAbstractTableModel
 	Q_OBJECT
 
 public:
-	StandardDatastoreEntryQTableModel(QObject* parent, const std::vector<StandardDatastoreEntryName>& entries);
+	StandardDatastoreEntryQTableModel(QObject* parent, const StandardDatastoreEntryNameList& entries);
 
 	std::optional<StandardDatastoreEntryName> get_entry(size_t row_index) const;
 
@@ -77,7 +77,7 @@ public:
 	virtual int rowCount(const QModelIndex& parent = QModelIndex{}) const override;
 	virtual QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
 
-	std::vector<StandardDatastoreEntryName> entries;
+	StandardDatastoreEntryNameList entries;
 };
 
 class StandardDatastoreEntryVersionQTableModel : public QAbstractTableModel
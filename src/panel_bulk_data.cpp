@@ -9,6 +9,7 @@
 #include <Qt>
 #include <QtGlobal>
 #include <QCheckBox>
+#include <QDialog>
 #include <QFile>
 #include <QFileDialog>
 #include <QFrame>
@@ -22,6 +23,7 @@
 #include "data_request.h"
 #include "diag_confirm_change.h"
 #include "diag_operation_in_progress.h"
+#include "diag_upload_options.h"
 #include "gui_constants.h"
 #include "model_common.h"
 #include "profile.h"
@@ -76,6 +78,11 @@ BulkDataPanel::BulkDataPanel(QWidget* const parent, const QString& api_key, cons
 			datastore_undelete_button->setMinimumWidth(150);
 			connect(datastore_undelete_button, &QPushButton::clicked, this, &BulkDataPanel::pressed_undelete);
 
+			datastore_resume_button = new QPushButton{ "Resume delete/undelete...", datastore_group };
+			datastore_resume_button->setToolTip(ToolTip::BulkDataPanel_Resume);
+			datastore_resume_button->setMinimumWidth(150);
+			connect(datastore_resume_button, &QPushButton::clicked, this, &BulkDataPanel::pressed_resume);
+
 			datastore_upload_button = new QPushButton{ "Bulk upload...", datastore_group };
 			datastore_upload_button->setToolTip(ToolTip::BulkDataPanel_Upload);
 			datastore_upload_button->setMinimumWidth(150);
@@ -89,6 +96,7 @@ BulkDataPanel::BulkDataPanel(QWidget* const parent, const QString& api_key, cons
 			group_layout->addWidget(danger_buttons_check);
 			group_layout->addWidget(datastore_delete_button);
 			group_layout->addWidget(datastore_undelete_button);
+			group_layout->addWidget(datastore_resume_button);
 			group_layout->addWidget(datastore_upload_button);
 		}
 
@@ -123,6 +131,7 @@ void BulkDataPanel::gui_refresh()
 	const bool enable_danger = (danger_buttons_check->checkState() == Qt::Checked);
 	datastore_delete_button->setEnabled(enable_danger);
 	datastore_undelete_button->setEnabled(enable_danger);
+	datastore_resume_button->setEnabled(enable_danger);
 	datastore_upload_button->setEnabled(enable_danger);
 }
 
@@ -221,6 +230,11 @@ void BulkDataPanel::pressed_download_resume()
 		QMessageBox::critical(nullptr, "Error", "Selected file has unexpected database schema, unable to proceed");
 		return;
 	}
+	if (writer->get_journal_operation())
+	{
+		QMessageBox::critical(nullptr, "Error", "Selected file was saved by a bulk delete or undelete, use 'Resume delete/undelete' instead");
+		return;
+	}
 	if (writer->is_resumable(universe_id) == false)
 	{
 		QMessageBox::critical(nullptr, "Error", "Selected file cannot be resumed for the selected universe");
@@ -232,6 +246,81 @@ void BulkDataPanel::pressed_download_resume()
 	progress_window->start();
 }
 
+void BulkDataPanel::pressed_resume()
+{
+	const std::shared_ptr<UniverseProfile> universe_profile = attached_universe.lock();
+	if (!universe_profile)
+	{
+		OCTASSERT(false);
+		return;
+	}
+
+	if (danger_buttons_check->isChecked() == false)
+	{
+		OCTASSERT(false);
+		return;
+	}
+
+	const QString file_name = QFileDialog::getOpenFileName(this, "Resume delete or undelete", "", "sqlite3 databases (*.sqlite3)");
+	if (file_name.trimmed().length() == 0)
+	{
+		// User selected nothing, return silently
+		return;
+	}
+
+	{
+		const QFile existing_file{ file_name };
+		if (existing_file.exists() == false)
+		{
+			QMessageBox::critical(nullptr, "Error", "Unable to open file");
+			return;
+		}
+	}
+
+	const long long universe_id = universe_profile->get_universe_id();
+
+	std::unique_ptr<SqliteDatastoreWrapper> journal = SqliteDatastoreWrapper::open_from_path(file_name.toStdString());
+	if (!journal || journal->is_correct_schema() == false)
+	{
+		QMessageBox::critical(nullptr, "Error", "Selected file has unexpected database schema, unable to proceed");
+		return;
+	}
+	const std::optional<SqliteJournalOperation> operation = journal->get_journal_operation();
+	if (operation.has_value() == false)
+	{
+		QMessageBox::critical(nullptr, "Error", "Selected file was not saved by a bulk delete or undelete");
+		return;
+	}
+	if (journal->is_resumable(universe_id) == false)
+	{
+		QMessageBox::critical(nullptr, "Error", "Selected file cannot be resumed for the selected universe");
+		return;
+	}
+
+	const ChangeType change_type = *operation == SqliteJournalOperation::Delete ? ChangeType::StandardDatastoreBulkDelete : ChangeType::StandardDatastoreBulkUndelete;
+	ConfirmChangeDialog* const confirm_dialog = new ConfirmChangeDialog{ this, change_type };
+	if (static_cast<bool>(confirm_dialog->exec()) == false)
+	{
+		return;
+	}
+
+	DatastoreBulkOperationProgressWindow* progress_window = nullptr;
+	switch (*operation)
+	{
+	case SqliteJournalOperation::Delete:
+		progress_window = new DatastoreBulkDeleteProgressWindow{ this, api_key, universe_profile, std::move(journal) };
+		break;
+	case SqliteJournalOperation::Undelete:
+		progress_window = new DatastoreBulkUndeleteProgressWindow{ this, api_key, universe_id, std::move(journal) };
+		break;
+	}
+	if (progress_window)
+	{
+		progress_window->show();
+		progress_window->start();
+	}
+}
+
 void BulkDataPanel::pressed_snapshot()
 {
 	const std::shared_ptr<UniverseProfile> universe_profile = attached_universe.lock();
@@ -334,33 +423,60 @@ void BulkDataPanel::pressed_upload()
 		return;
 	}
 
-	std::optional<std::vector<StandardDatastoreEntryFull>> loaded_data = SqliteDatastoreReader::read_all(load_file_path.toStdString());
-	if (loaded_data)
+	std::unique_ptr<SqliteDatastoreWrapper> reader = SqliteDatastoreWrapper::open_from_path(load_file_path.toStdString());
+	if (!reader || reader->is_correct_schema() == false)
 	{
-		std::vector<std::shared_ptr<DataRequest>> shared_requests;
+		QMessageBox* msg_box = new QMessageBox{ this };
+		msg_box->setWindowTitle("Error");
+		msg_box->setText("Failed to open database.");
+		msg_box->exec();
+		return;
+	}
 
-		for (const StandardDatastoreEntryFull& this_entry : *loaded_data)
+	bool resume = false;
+	if (reader->get_upload_checkpoint())
+	{
+		QMessageBox* const resume_message_box = new QMessageBox{ this };
+		resume_message_box->setWindowTitle("Resume Upload");
+		resume_message_box->setText("An earlier upload of this file was interrupted.\nDo you want to continue where it stopped?\n\nSelect 'No' to upload every entry again.");
+		resume_message_box->setStandardButtons(QMessageBox::Yes | QMessageBox::No | QMessageBox::Cancel);
+		const int resume_status = resume_message_box->exec();
+		if (resume_status == QMessageBox::Cancel)
 		{
-			shared_requests.push_back(std::make_shared<StandardDatastoreEntryPostSetRequest>(
-				api_key,
-				this_entry.get_universe_id(),
-				this_entry.get_datastore_name(),
-				this_entry.get_scope(),
-				this_entry.get_key_name(),
-				this_entry.get_userids(),
-				this_entry.get_attributes(),
-				this_entry.get_data_raw()
-			));
+			return;
 		}
+		resume = resume_status == QMessageBox::Yes;
+	}
 
-		OperationInProgressDialog diag{ this, shared_requests };
-		diag.exec();
+	UploadOptionsDialog* const options_dialog = new UploadOptionsDialog{ this };
+	if (options_dialog->exec() != QDialog::Accepted)
+	{
+		return;
 	}
-	else
+
+	std::unique_ptr<SqliteDatastoreWrapper> baseline;
+	if (const std::optional<QString> baseline_path = options_dialog->get_baseline_path())
 	{
-		QMessageBox* msg_box = new QMessageBox{ this };
-		msg_box->setWindowTitle("Error");
-		msg_box->setText("Failed to open database.");
-		msg_box->exec();
+		baseline = SqliteDatastoreWrapper::open_from_path(baseline_path->toStdString());
+		if (!baseline || baseline->is_correct_schema() == false)
+		{
+			QMessageBox* msg_box = new QMessageBox{ this };
+			msg_box->setWindowTitle("Error");
+			msg_box->setText("Failed to open previous dump.");
+			msg_box->exec();
+			return;
+		}
 	}
+
+	DatastoreBulkUploadProgressWindow* const progress_window = new DatastoreBulkUploadProgressWindow{
+		this,
+		api_key,
+		universe_profile->get_universe_id(),
+		std::move(reader),
+		resume,
+		std::move(baseline),
+		options_dialog->get_dry_run()
+	};
+	progress_window->show();
+	progress_window->start();
 }
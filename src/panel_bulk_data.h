@@ -25,6 +25,7 @@ private:
 	void pressed_delete();
 	void pressed_download();
 	void pressed_download_resume();
+	void pressed_resume();
 	void pressed_snapshot();
 	void pressed_undelete();
 	void pressed_upload();
@@ -39,5 +40,6 @@ private:
 	QCheckBox* danger_buttons_check = nullptr;
 	QPushButton* datastore_delete_button = nullptr;
 	QPushButton* datastore_undelete_button = nullptr;
+	QPushButton* datastore_resume_button = nullptr;
 	QPushButton* datastore_upload_button = nullptr;
 };
@@ -267,7 +267,7 @@ void StandardDatastorePanel::set_table_model(StandardDatastoreEntryQTableModel*
 	}
 	else
 	{
-		tree_view_main->setModel(new StandardDatastoreEntryQTableModel{ tree_view_main, std::vector<StandardDatastoreEntryName>{} });
+		tree_view_main->setModel(new StandardDatastoreEntryQTableModel{ tree_view_main, StandardDatastoreEntryNameList{} });
 	}
 	tree_view_main->setColumnWidth(0, 140);
 	connect(tree_view_main->selectionModel(), &QItemSelectionModel::selectionChanged, this, &StandardDatastorePanel::handle_selected_datastore_entry_changed);
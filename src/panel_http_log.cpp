@@ -1,5 +1,7 @@
 #include "panel_http_log.h"
 
+#include <chrono>
+#include <map>
 #include <memory>
 #include <optional>
 
@@ -8,17 +10,42 @@
 #include <QAction>
 #include <QClipboard>
 #include <QGuiApplication>
+#include <QLabel>
 #include <QMenu>
 #include <QModelIndex>
 #include <QPushButton>
 #include <QString>
+#include <QStringList>
+#include <QTimer>
 #include <QTreeView>
 #include <QVBoxLayout>
 
+#include "http_circuit_breaker.h"
+#include "http_request_stats.h"
 #include "http_wrangler.h"
+#include "util_enum.h"
 
 HttpLogPanel::HttpLogPanel(QWidget* parent) : QWidget{ parent }
 {
+	circuit_label = new QLabel{ this };
+	circuit_label->setWordWrap(true);
+
+	// Only needed to count down while a breaker is open
+	circuit_timer = new QTimer{ this };
+	connect(circuit_timer, &QTimer::timeout, this, &HttpLogPanel::refresh_circuit_state);
+
+	stats_label = new QLabel{ this };
+
+	stats_model = new HttpRequestStatsModel{ this };
+	stats_view = new QTreeView{ this };
+	stats_view->setRootIsDecorated(false);
+	stats_view->setModel(stats_model);
+	stats_view->setMaximumHeight(160);
+
+	stats_timer = new QTimer{ this };
+	connect(stats_timer, &QTimer::timeout, this, &HttpLogPanel::refresh_stats);
+	stats_timer->start(1000);
+
 	tree_view = new QTreeView{ this };
 	tree_view->setContextMenuPolicy(Qt::ContextMenuPolicy::CustomContextMenu);
 	connect(tree_view, &QTreeView::customContextMenuRequested, this, &HttpLogPanel::pressed_right_click);
@@ -27,18 +54,26 @@ HttpLogPanel::HttpLogPanel(QWidget* parent) : QWidget{ parent }
 	connect(clear_button, &QPushButton::clicked, this, &HttpLogPanel::pressed_clear);
 
 	QVBoxLayout* layout = new QVBoxLayout{ this };
+	layout->addWidget(circuit_label);
+	layout->addWidget(stats_label);
+	layout->addWidget(stats_view);
 	layout->addWidget(tree_view);
 	layout->addWidget(clear_button);
 
 	refresh();
 
 	const std::unique_ptr<HttpWrangler>& wrangler = HttpWrangler::get();
-	connect(wrangler.get(), &HttpWrangler::log_entry_added, this, &HttpLogPanel::handle_log_entry_added);
+	connect(wrangler.get(), &HttpWrangler::log_changed, this, &HttpLogPanel::handle_log_changed);
+	connect(wrangler.get(), &HttpWrangler::circuit_state_changed, this, &HttpLogPanel::refresh_circuit_state);
+
+	refresh_circuit_state();
+	refresh_stats();
 }
 
 void HttpLogPanel::tab_opened()
 {
 	refresh();
+	refresh_stats();
 }
 
 void HttpLogPanel::refresh()
@@ -56,12 +91,67 @@ void HttpLogPanel::refresh()
 	}
 }
 
-// NOLINTNEXTLINE(*-unnecessary-value-param)
-void HttpLogPanel::handle_log_entry_added(const HttpLogEntry log_entry)
+void HttpLogPanel::refresh_circuit_state()
+{
+	const auto now = std::chrono::steady_clock::now();
+	QStringList tripped_list;
+	for (const auto& [family, breaker] : HttpWrangler::get()->get_circuit_breakers())
+	{
+		if (breaker.get_state() == HttpCircuitState::Open)
+		{
+			const auto probe_secs = std::chrono::duration_cast<std::chrono::seconds>(breaker.get_time_until_probe(now));
+			tripped_list.append(QString{ "%1: %2, probing in %3s" }.arg(get_enum_string(family), get_enum_string(breaker.get_state())).arg(probe_secs.count()));
+		}
+		else if (breaker.get_state() == HttpCircuitState::HalfOpen)
+		{
+			tripped_list.append(QString{ "%1: %2, probing" }.arg(get_enum_string(family), get_enum_string(breaker.get_state())));
+		}
+	}
+
+	if (tripped_list.size() > 0)
+	{
+		circuit_label->setText(QString{ "Circuit breakers paused after repeated server errors: %1" }.arg(tripped_list.join("; ")));
+		circuit_label->setVisible(true);
+		if (circuit_timer->isActive() == false)
+		{
+			circuit_timer->start(1000);
+		}
+	}
+	else
+	{
+		circuit_label->setText("");
+		circuit_label->setVisible(false);
+		circuit_timer->stop();
+	}
+}
+
+void HttpLogPanel::refresh_stats()
+{
+	// Percentiles are recalculated from scratch, skip the work while the tab is not shown
+	if (isVisible() == false)
+	{
+		return;
+	}
+
+	const std::unique_ptr<HttpWrangler>& wrangler = HttpWrangler::get();
+	stats_label->setText(QString{ "Last %1s, queued for rate limit: %2, in flight: %3" }.arg(wrangler->get_request_stats_interval().count()).arg(wrangler->get_queued_count()).arg(wrangler->get_in_flight_count()));
+
+	const bool first_stats = stats_model->rowCount() == 0;
+	stats_model->set_stats(wrangler->get_request_stats());
+	if (first_stats)
+	{
+		for (int i = 0; i < stats_model->columnCount(); i++)
+		{
+			stats_view->resizeColumnToContents(i);
+		}
+	}
+}
+
+void HttpLogPanel::handle_log_changed(const std::uint64_t first_updated_sequence)
 {
 	if (HttpLogModel* const log_model = dynamic_cast<HttpLogModel*>(tree_view->model()))
 	{
-		log_model->append_entry(log_entry);
+		log_model->sync(first_updated_sequence);
 	}
 }
 
@@ -69,6 +159,7 @@ void HttpLogPanel::pressed_clear()
 {
 	HttpWrangler::get()->clear_log();
 	refresh();
+	refresh_stats();
 }
 
 void HttpLogPanel::pressed_right_click(const QPoint& pos)
@@ -1,12 +1,17 @@
 #pragma once
 
+#include <cstdint>
+
 #include <QObject>
 #include <QWidget>
 
+class QLabel;
 class QPoint;
+class QTimer;
 class QTreeView;
 
 class HttpLogEntry;
+class HttpRequestStatsModel;
 
 class HttpLogPanel : public QWidget
 {
@@ -18,11 +23,19 @@ public:
 
 private:
 	void refresh();
+	void refresh_circuit_state();
+	void refresh_stats();
 
-	void handle_log_entry_added(HttpLogEntry log_entry);
+	void handle_log_changed(std::uint64_t first_updated_sequence);
 
 	void pressed_clear();
 	void pressed_right_click(const QPoint& pos);
 
+	QLabel* circuit_label = nullptr;
+	QTimer* circuit_timer = nullptr;
+	QLabel* stats_label = nullptr;
+	QTreeView* stats_view = nullptr;
+	HttpRequestStatsModel* stats_model = nullptr;
+	QTimer* stats_timer = nullptr;
 	QTreeView* tree_view = nullptr;
 };
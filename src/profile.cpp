@@ -19,6 +19,10 @@
 
 #include "assert.h"
 
+static constexpr size_t MAX_BULK_OPERATION_CONCURRENCY = 32;
+static constexpr size_t MIN_HTTP_LOG_CAPACITY = 100;
+static constexpr size_t MAX_HTTP_LOG_CAPACITY = 1000000;
+
 static bool compare_api_key_profile(const std::shared_ptr<const ApiKeyProfile>& a, const std::shared_ptr<const ApiKeyProfile>& b)
 {
 	return a->get_name() < b->get_name();
@@ -411,6 +415,46 @@ void UserProfile::set_less_verbose_bulk_operations(const bool less_verbose)
 	}
 }
 
+void UserProfile::set_bulk_operation_concurrency(const size_t concurrency)
+{
+	const size_t clamped_concurrency = std::clamp<size_t>(concurrency, 1, MAX_BULK_OPERATION_CONCURRENCY);
+	if (bulk_operation_concurrency != clamped_concurrency)
+	{
+		bulk_operation_concurrency = clamped_concurrency;
+		emit bulk_operation_concurrency_changed();
+		save_to_disk();
+	}
+}
+
+void UserProfile::set_bulk_operation_http2(const bool use_http2)
+{
+	if (bulk_operation_http2 != use_http2)
+	{
+		bulk_operation_http2 = use_http2;
+		save_to_disk();
+	}
+}
+
+void UserProfile::set_bulk_download_pipelined(const bool pipelined)
+{
+	if (bulk_download_pipelined != pipelined)
+	{
+		bulk_download_pipelined = pipelined;
+		save_to_disk();
+	}
+}
+
+void UserProfile::set_http_log_capacity(const size_t capacity)
+{
+	const size_t clamped_capacity = std::clamp<size_t>(capacity, MIN_HTTP_LOG_CAPACITY, MAX_HTTP_LOG_CAPACITY);
+	if (http_log_capacity != clamped_capacity)
+	{
+		http_log_capacity = clamped_capacity;
+		emit http_log_capacity_changed();
+		save_to_disk();
+	}
+}
+
 void UserProfile::set_show_datastore_name_filter(const bool show_filter)
 {
 	if (show_datastore_name_filter != show_filter)
@@ -532,6 +576,22 @@ void UserProfile::load_from_disk()
 	{
 		less_verbose_bulk_operations = settings.value("less_verbose_bulk_operations").toBool();
 	}
+	if (settings.value("bulk_operation_concurrency").isValid())
+	{
+		bulk_operation_concurrency = std::clamp<size_t>(settings.value("bulk_operation_concurrency").toULongLong(), 1, MAX_BULK_OPERATION_CONCURRENCY);
+	}
+	if (settings.value("bulk_operation_http2").isValid())
+	{
+		bulk_operation_http2 = settings.value("bulk_operation_http2").toBool();
+	}
+	if (settings.value("bulk_download_pipelined").isValid())
+	{
+		bulk_download_pipelined = settings.value("bulk_download_pipelined").toBool();
+	}
+	if (settings.value("http_log_capacity").isValid())
+	{
+		http_log_capacity = std::clamp<size_t>(settings.value("http_log_capacity").toULongLong(), MIN_HTTP_LOG_CAPACITY, MAX_HTTP_LOG_CAPACITY);
+	}
 	if (settings.value("show_datastore_name_filter").isValid())
 	{
 		show_datastore_name_filter = settings.value("show_datastore_name_filter").toBool();
@@ -679,6 +739,10 @@ void UserProfile::save_to_disk()
 	settings.setValue("qt_theme", qt_theme);
 	settings.setValue("autoclose_progress_window", autoclose_progress_window);
 	settings.setValue("less_verbose_bulk_operations", less_verbose_bulk_operations);
+	settings.setValue("bulk_operation_concurrency", static_cast<qulonglong>(bulk_operation_concurrency));
+	settings.setValue("bulk_operation_http2", bulk_operation_http2);
+	settings.setValue("bulk_download_pipelined", bulk_download_pipelined);
+	settings.setValue("http_log_capacity", static_cast<qulonglong>(http_log_capacity));
 	settings.setValue("show_datastore_name_filter", show_datastore_name_filter);
 	settings.endGroup();
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+
 #include <functional>
 #include <map>
 #include <memory>
@@ -160,6 +162,18 @@ public:
 	bool get_less_verbose_bulk_operations() const { return less_verbose_bulk_operations; }
 	void set_less_verbose_bulk_operations(bool less_verbose);
 
+	size_t get_bulk_operation_concurrency() const { return bulk_operation_concurrency; }
+	void set_bulk_operation_concurrency(size_t concurrency);
+
+	bool get_bulk_operation_http2() const { return bulk_operation_http2; }
+	void set_bulk_operation_http2(bool use_http2);
+
+	bool get_bulk_download_pipelined() const { return bulk_download_pipelined; }
+	void set_bulk_download_pipelined(bool pipelined);
+
+	size_t get_http_log_capacity() const { return http_log_capacity; }
+	void set_http_log_capacity(size_t capacity);
+
 	bool get_show_datastore_name_filter() const { return show_datastore_name_filter; }
 	void set_show_datastore_name_filter(bool show_filter);
 
@@ -174,6 +188,8 @@ public:
 signals:
 	void qt_theme_changed();
 	void autoclose_changed();
+	void bulk_operation_concurrency_changed();
+	void http_log_capacity_changed();
 	void active_api_key_changed();
 	void api_key_list_changed();
 	void show_datastore_filter_changed();
@@ -191,6 +207,10 @@ private:
 	QString qt_theme;
 	bool autoclose_progress_window = true;
 	bool less_verbose_bulk_operations = true;
+	size_t bulk_operation_concurrency = 16;
+	bool bulk_operation_http2 = true;
+	bool bulk_download_pipelined = true;
+	size_t http_log_capacity = 10000;
 	bool show_datastore_name_filter = false;
 
 	std::map<ApiKeyProfile::Id, std::shared_ptr<ApiKeyProfile>> api_keys;
@@ -2,9 +2,12 @@
 
 #include <cstddef>
 
+#include <algorithm>
 #include <array>
 #include <optional>
+#include <utility>
 
+#include <QByteArray>
 #include <QString>
 
 #include <sqlite3.h>
@@ -12,9 +15,230 @@
 #include "model_common.h"
 #include "util_enum.h"
 
+static constexpr size_t DEFAULT_GROUP_MAX_ROWS = 1000;
+static constexpr std::chrono::milliseconds DEFAULT_GROUP_MAX_AGE{ 500 };
+
+static const char* get_durability_setting(const SqliteDurability durability)
+{
+	switch (durability)
+	{
+	case SqliteDurability::Safe:
+		return "safe";
+	case SqliteDurability::Fast:
+		return "fast";
+	case SqliteDurability::Bulk:
+		return "bulk";
+	}
+	return "safe";
+}
+
+static void apply_durability(sqlite3* const db_handle, const SqliteDurability durability)
+{
+	if (durability == SqliteDurability::Safe)
+	{
+		// Rollback journal with synchronous=FULL, the sqlite defaults
+		return;
+	}
+
+	// WAL normally coordinates readers through shared memory, which does not work on network filesystems
+	// Holding an exclusive lock lets sqlite keep the WAL index on the heap instead, nothing else should be using the file during a download anyway
+	sqlite3_exec(db_handle, "PRAGMA locking_mode = EXCLUSIVE;", nullptr, nullptr, nullptr);
+	sqlite3_exec(db_handle, "PRAGMA journal_mode = WAL;", nullptr, nullptr, nullptr);
+	// In WAL mode this can only lose the most recent commits on power loss, never corrupt the file
+	sqlite3_exec(db_handle, "PRAGMA synchronous = NORMAL;", nullptr, nullptr, nullptr);
+	// Negative sizes are in KiB rather than pages, this is 64 MiB
+	sqlite3_exec(db_handle, "PRAGMA cache_size = -65536;", nullptr, nullptr, nullptr);
+	sqlite3_exec(db_handle, "PRAGMA temp_store = MEMORY;", nullptr, nullptr, nullptr);
+
+	if (durability == SqliteDurability::Bulk)
+	{
+		// Map up to 256 MiB of the file instead of copying pages through read and write calls
+		sqlite3_exec(db_handle, "PRAGMA mmap_size = 268435456;", nullptr, nullptr, nullptr);
+		// Checkpoint less often while downloading, the log is folded into the database once the download is done
+		sqlite3_exec(db_handle, "PRAGMA wal_autocheckpoint = 16384;", nullptr, nullptr, nullptr);
+	}
+}
+
+static const char* get_value_codec_setting(const SqliteValueCodec codec)
+{
+	switch (codec)
+	{
+	case SqliteValueCodec::None:
+		return "none";
+	case SqliteValueCodec::QCompress:
+		return "qcompress";
+	}
+	return "none";
+}
+
+static const char* get_journal_operation_setting(const SqliteJournalOperation operation)
+{
+	switch (operation)
+	{
+	case SqliteJournalOperation::Delete:
+		return "delete";
+	case SqliteJournalOperation::Undelete:
+		return "undelete";
+	}
+	return "delete";
+}
+
+static std::optional<std::string> read_setting(sqlite3* const db_handle, const std::string& key)
+{
+	std::optional<std::string> result;
+
+	// Files from older versions do not have this table, preparing the statement fails and the setting is treated as missing
+	sqlite3_stmt* stmt = nullptr;
+	const std::string sql = "SELECT value FROM datastore_settings WHERE key = ?010;";
+	sqlite3_prepare_v2(db_handle, sql.c_str(), static_cast<int>(sql.size()), &stmt, nullptr);
+	if (stmt != nullptr)
+	{
+		sqlite3_bind_text(stmt, 10, key.c_str(), -1, SQLITE_TRANSIENT);
+		if (sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_type(stmt, 0) == SQLITE_TEXT)
+		{
+			result = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+		}
+		sqlite3_finalize(stmt);
+	}
+
+	return result;
+}
+
+static void write_setting(sqlite3* const db_handle, const std::string& key, const std::string& value)
+{
+	sqlite3_stmt* stmt = nullptr;
+	const std::string sql = "INSERT OR REPLACE INTO datastore_settings (key, value) VALUES (?010, ?020);";
+	sqlite3_prepare_v2(db_handle, sql.c_str(), static_cast<int>(sql.size()), &stmt, nullptr);
+	sqlite3_bind_text(stmt, 10, key.c_str(), -1, SQLITE_TRANSIENT);
+	sqlite3_bind_text(stmt, 20, value.c_str(), -1, SQLITE_TRANSIENT);
+	sqlite3_step(stmt);
+	sqlite3_finalize(stmt);
+}
+
+static std::optional<SqliteDurability> read_durability(sqlite3* const db_handle)
+{
+	if (const std::optional<std::string> value = read_setting(db_handle, "durability"))
+	{
+		for (const SqliteDurability this_durability : { SqliteDurability::Safe, SqliteDurability::Fast, SqliteDurability::Bulk })
+		{
+			if (*value == get_durability_setting(this_durability))
+			{
+				return this_durability;
+			}
+		}
+	}
+	return std::nullopt;
+}
+
+static std::optional<SqliteValueCodec> read_value_codec(sqlite3* const db_handle)
+{
+	if (const std::optional<std::string> value = read_setting(db_handle, "value_codec"))
+	{
+		for (const SqliteValueCodec this_codec : { SqliteValueCodec::None, SqliteValueCodec::QCompress })
+		{
+			if (*value == get_value_codec_setting(this_codec))
+			{
+				return this_codec;
+			}
+		}
+		// Earlier builds wrote the same format under this name
+		if (*value == "zlib")
+		{
+			return SqliteValueCodec::QCompress;
+		}
+	}
+	return std::nullopt;
+}
+
 // NOLINTBEGIN(*-no-int-to-ptr)
 
-std::unique_ptr<SqliteDatastoreWrapper> SqliteDatastoreWrapper::new_from_path(const std::string& file_path)
+// Reads the columns of the datastore table in schema order, starting at first_column
+static std::optional<StandardDatastoreEntryFull> read_entry_row(sqlite3_stmt* const stmt, const int first_column, const SqliteValueCodec value_codec)
+{
+	std::optional<long long> opt_universe_id;
+	if (sqlite3_column_type(stmt, first_column) == SQLITE_INTEGER)
+	{
+		opt_universe_id = sqlite3_column_int64(stmt, first_column);
+	}
+
+	std::optional<QString> opt_datastore_name;
+	if (sqlite3_column_type(stmt, first_column + 1) == SQLITE_TEXT)
+	{
+		opt_datastore_name = QString{ reinterpret_cast<const char*>(sqlite3_column_text(stmt, first_column + 1)) };
+	}
+
+	std::optional<QString> opt_scope;
+	if (sqlite3_column_type(stmt, first_column + 2) == SQLITE_TEXT)
+	{
+		opt_scope = QString{ reinterpret_cast<const char*>(sqlite3_column_text(stmt, first_column + 2)) };
+	}
+
+	std::optional<QString> opt_key_name;
+	if (sqlite3_column_type(stmt, first_column + 3) == SQLITE_TEXT)
+	{
+		opt_key_name = QString{ reinterpret_cast<const char*>(sqlite3_column_text(stmt, first_column + 3)) };
+	}
+
+	std::optional<QString> opt_version;
+	if (sqlite3_column_type(stmt, first_column + 4) == SQLITE_TEXT)
+	{
+		opt_version = QString{ reinterpret_cast<const char*>(sqlite3_column_text(stmt, first_column + 4)) };
+	}
+
+	// Slot 5 is data_type, slots 7 to 9 are derived from data_raw
+
+	std::optional<QByteArray> opt_data_raw;
+	if (sqlite3_column_type(stmt, first_column + 6) == SQLITE_TEXT)
+	{
+		const char* const data_raw_text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, first_column + 6));
+		opt_data_raw = QByteArray{ data_raw_text, sqlite3_column_bytes(stmt, first_column + 6) };
+	}
+	else if (sqlite3_column_type(stmt, first_column + 6) == SQLITE_BLOB && value_codec == SqliteValueCodec::QCompress)
+	{
+		const char* const data_raw_blob = reinterpret_cast<const char*>(sqlite3_column_blob(stmt, first_column + 6));
+		const QByteArray compressed = QByteArray::fromRawData(data_raw_blob, sqlite3_column_bytes(stmt, first_column + 6));
+		QByteArray data_raw = qUncompress(compressed);
+		// qUncompress() also returns an empty array when it fails, only the bare length prefix of an empty value may decode to nothing
+		if (data_raw.size() > 0 || compressed == QByteArray(4, '\0'))
+		{
+			opt_data_raw = std::move(data_raw);
+		}
+	}
+
+	std::optional<QString> opt_userids;
+	if (sqlite3_column_type(stmt, first_column + 10) == SQLITE_TEXT)
+	{
+		opt_userids = QString{ reinterpret_cast<const char*>(sqlite3_column_text(stmt, first_column + 10)) };
+	}
+
+	std::optional<QString> opt_attributes;
+	if (sqlite3_column_type(stmt, first_column + 11) == SQLITE_TEXT)
+	{
+		opt_attributes = QString{ reinterpret_cast<const char*>(sqlite3_column_text(stmt, first_column + 11)) };
+	}
+
+	if (opt_universe_id && opt_datastore_name && opt_scope && opt_key_name && opt_version && opt_data_raw)
+	{
+		return StandardDatastoreEntryFull{ *opt_universe_id, *opt_datastore_name, *opt_scope, *opt_key_name, *opt_version, opt_userids, opt_attributes, *opt_data_raw };
+	}
+	return std::nullopt;
+}
+
+SqlitePendingEntryReader::SqlitePendingEntryReader(const long long universe_id, const long long last_id) :
+	universe_id{ universe_id },
+	last_id{ last_id }
+{
+
+}
+
+SqliteStoredEntryReader::SqliteStoredEntryReader(const long long after_row_id, const long long last_row_id) :
+	after_row_id{ after_row_id },
+	last_row_id{ last_row_id }
+{
+
+}
+
+std::unique_ptr<SqliteDatastoreWrapper> SqliteDatastoreWrapper::new_from_path(const std::string& file_path, const SqliteDurability durability, const SqliteValueCodec value_codec)
 {
 	sqlite3* db_handle = nullptr;
 	if (sqlite3_open(file_path.c_str(), &db_handle) != SQLITE_OK)
@@ -22,9 +246,14 @@ std::unique_ptr<SqliteDatastoreWrapper> SqliteDatastoreWrapper::new_from_path(co
 		return nullptr;
 	}
 
+	apply_durability(db_handle, durability);
+
 	// Table to store raw datastore data
 	sqlite3_exec(db_handle, "DROP TABLE IF EXISTS datastore;", nullptr, nullptr, nullptr);
-	sqlite3_exec(db_handle, "CREATE TABLE datastore (universe_id INTEGER NOT NULL, datastore_name TEXT NOT NULL, scope TEXT NOT NULL, key_name TEXT NOT NULL, version TEXT NOT NULL, data_type TEXT NOT NULL, data_raw TEXT NOT NULL, data_str TEXT, data_num REAL, data_bool INTEGER, userids TEXT, attributes TEXT, PRIMARY KEY (universe_id, datastore_name, scope, key_name))", nullptr, nullptr, nullptr);
+	// Compressed values are declared as blobs so other tools do not try to read them as text
+	const std::string data_raw_type = value_codec == SqliteValueCodec::None ? "TEXT" : "BLOB";
+	const std::string create_datastore_sql = "CREATE TABLE datastore (universe_id INTEGER NOT NULL, datastore_name TEXT NOT NULL, scope TEXT NOT NULL, key_name TEXT NOT NULL, version TEXT NOT NULL, data_type TEXT NOT NULL, data_raw " + data_raw_type + " NOT NULL, data_str TEXT, data_num REAL, data_bool INTEGER, userids TEXT, attributes TEXT, PRIMARY KEY (universe_id, datastore_name, scope, key_name))";
+	sqlite3_exec(db_handle, create_datastore_sql.c_str(), nullptr, nullptr, nullptr);
 
 	// Table to track which enumerated entries no longer exist
 	sqlite3_exec(db_handle, "DROP TABLE IF EXISTS datastore_deleted;", nullptr, nullptr, nullptr);
@@ -42,7 +271,21 @@ std::unique_ptr<SqliteDatastoreWrapper> SqliteDatastoreWrapper::new_from_path(co
 	sqlite3_exec(db_handle, "DROP TABLE IF EXISTS datastore_pending;", nullptr, nullptr, nullptr);
 	sqlite3_exec(db_handle, "CREATE TABLE datastore_pending (id INTEGER PRIMARY KEY, universe_id INTEGER NOT NULL, datastore_name TEXT NOT NULL, scope TEXT NOT NULL, key_name TEXT NOT NULL)", nullptr, nullptr, nullptr);
 
-	return std::make_unique<SqliteDatastoreWrapper>(db_handle);
+	// Table to record what happened to each entry of a journaled delete or undelete
+	sqlite3_exec(db_handle, "DROP TABLE IF EXISTS datastore_outcome;", nullptr, nullptr, nullptr);
+	sqlite3_exec(db_handle, "CREATE TABLE datastore_outcome (universe_id INTEGER NOT NULL, datastore_name TEXT NOT NULL, scope TEXT NOT NULL, key_name TEXT NOT NULL, outcome TEXT NOT NULL, PRIMARY KEY (universe_id, datastore_name, scope, key_name))", nullptr, nullptr, nullptr);
+
+	// Table for options that apply to the whole file, so a resumed download opens it the same way
+	sqlite3_exec(db_handle, "DROP TABLE IF EXISTS datastore_settings;", nullptr, nullptr, nullptr);
+	sqlite3_exec(db_handle, "CREATE TABLE datastore_settings (key TEXT NOT NULL, value TEXT NOT NULL, PRIMARY KEY (key))", nullptr, nullptr, nullptr);
+	write_setting(db_handle, "durability", get_durability_setting(durability));
+	// Readers that do not know about this setting would see compressed values as text, so it is only written when compressing
+	if (value_codec != SqliteValueCodec::None)
+	{
+		write_setting(db_handle, "value_codec", get_value_codec_setting(value_codec));
+	}
+
+	return std::make_unique<SqliteDatastoreWrapper>(db_handle, value_codec);
 }
 
 std::unique_ptr<SqliteDatastoreWrapper> SqliteDatastoreWrapper::open_from_path(const std::string& file_path)
@@ -53,10 +296,21 @@ std::unique_ptr<SqliteDatastoreWrapper> SqliteDatastoreWrapper::open_from_path(c
 		return nullptr;
 	}
 
-	return std::make_unique<SqliteDatastoreWrapper>(db_handle);
+	// The lock has to be exclusive before the first read if the file is in WAL mode, see apply_durability()
+	sqlite3_exec(db_handle, "PRAGMA locking_mode = EXCLUSIVE;", nullptr, nullptr, nullptr);
+	const SqliteDurability durability = read_durability(db_handle).value_or(SqliteDurability::Safe);
+	if (durability == SqliteDurability::Safe)
+	{
+		// Takes effect as soon as the database is next accessed
+		sqlite3_exec(db_handle, "PRAGMA locking_mode = NORMAL;", nullptr, nullptr, nullptr);
+	}
+	apply_durability(db_handle, durability);
+
+	const SqliteValueCodec value_codec = read_value_codec(db_handle).value_or(SqliteValueCodec::None);
+	return std::make_unique<SqliteDatastoreWrapper>(db_handle, value_codec);
 }
 
-SqliteDatastoreWrapper::SqliteDatastoreWrapper(sqlite3* db_handle) : db_handle{ db_handle }
+SqliteDatastoreWrapper::SqliteDatastoreWrapper(sqlite3* db_handle, const SqliteValueCodec value_codec) : db_handle{ db_handle }, value_codec{ value_codec }, group_max_rows{ DEFAULT_GROUP_MAX_ROWS }, group_max_age{ DEFAULT_GROUP_MAX_AGE }
 {
 
 }
@@ -65,6 +319,12 @@ SqliteDatastoreWrapper::~SqliteDatastoreWrapper()
 {
 	if (db_handle != nullptr)
 	{
+		commit_group();
+		for (const auto& [sql, stmt] : statement_cache)
+		{
+			sqlite3_finalize(stmt);
+		}
+		statement_cache.clear();
 		sqlite3_close(db_handle);
 		db_handle = nullptr;
 	}
@@ -140,9 +400,11 @@ bool SqliteDatastoreWrapper::is_correct_schema()
 							std::string{ reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2)) } == "TEXT";
 						break;
 					case 6:
+						// Compressed files from before the column was declared as a blob still say TEXT
 						column_valid[6] =
 							std::string{ reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)) } == "data_raw" &&
-							std::string{ reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2)) } == "TEXT";
+							(std::string{ reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2)) } == "TEXT" ||
+							(std::string{ reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2)) } == "BLOB" && value_codec != SqliteValueCodec::None));
 						break;
 					case 7:
 						column_valid[7] =
@@ -411,15 +673,24 @@ bool SqliteDatastoreWrapper::is_correct_schema()
 	return false;
 }
 
+void SqliteDatastoreWrapper::upgrade_schema()
+{
+	if (db_handle != nullptr)
+	{
+		commit_group();
+		// Files from older versions were created without settings or outcomes
+		sqlite3_exec(db_handle, "CREATE TABLE IF NOT EXISTS datastore_settings (key TEXT NOT NULL, value TEXT NOT NULL, PRIMARY KEY (key))", nullptr, nullptr, nullptr);
+		sqlite3_exec(db_handle, "CREATE TABLE IF NOT EXISTS datastore_outcome (universe_id INTEGER NOT NULL, datastore_name TEXT NOT NULL, scope TEXT NOT NULL, key_name TEXT NOT NULL, outcome TEXT NOT NULL, PRIMARY KEY (universe_id, datastore_name, scope, key_name))", nullptr, nullptr, nullptr);
+	}
+}
+
 bool SqliteDatastoreWrapper::is_resumable(const long long universe_id)
 {
 	if (db_handle != nullptr)
 	{
-		bool has_valid_cursors = false;
+		bool has_entries_pending = false;
 		{
-			sqlite3_stmt* stmt = nullptr;
-			const std::string sql = "SELECT COUNT(*) FROM datastore_enumerate WHERE universe_id = ?010 AND next_cursor IS NOT NULL;";
-			sqlite3_prepare_v2(db_handle, sql.c_str(), static_cast<int>(sql.size()), &stmt, nullptr);
+			sqlite3_stmt* stmt = get_cached_statement("SELECT COUNT(*) FROM datastore_pending WHERE universe_id = ?010;");
 			if (stmt != nullptr)
 			{
 				sqlite3_bind_int64(stmt, 10, universe_id);
@@ -427,17 +698,15 @@ bool SqliteDatastoreWrapper::is_resumable(const long long universe_id)
 				const int sqlite_result = sqlite3_step(stmt);
 				if (sqlite_result == SQLITE_ROW)
 				{
-					has_valid_cursors = sqlite3_column_int64(stmt, 0) <= 1;
+					has_entries_pending = sqlite3_column_int64(stmt, 0) > 0;
 				}
-				sqlite3_finalize(stmt);
+				release_cached_statement(stmt);
 			}
 		}
 
-		bool has_entries_pending = false;
+		bool has_enumeration_pending = false;
 		{
-			sqlite3_stmt* stmt = nullptr;
-			const std::string sql = "SELECT COUNT(*) FROM datastore_pending WHERE universe_id = ?010;";
-			sqlite3_prepare_v2(db_handle, sql.c_str(), static_cast<int>(sql.size()), &stmt, nullptr);
+			sqlite3_stmt* stmt = get_cached_statement("SELECT COUNT(*) FROM datastore_enumerate WHERE universe_id = ?010;");
 			if (stmt != nullptr)
 			{
 				sqlite3_bind_int64(stmt, 10, universe_id);
@@ -445,43 +714,146 @@ bool SqliteDatastoreWrapper::is_resumable(const long long universe_id)
 				const int sqlite_result = sqlite3_step(stmt);
 				if (sqlite_result == SQLITE_ROW)
 				{
-					has_entries_pending = sqlite3_column_int64(stmt, 0) > 0;
+					has_enumeration_pending = sqlite3_column_int64(stmt, 0) > 0;
 				}
-				sqlite3_finalize(stmt);
+				release_cached_statement(stmt);
 			}
 		}
 
-		bool has_enumeration_pending = false;
+		return has_entries_pending || has_enumeration_pending;
+	}
+
+	return false;
+}
+
+std::optional<SqliteJournalOperation> SqliteDatastoreWrapper::get_journal_operation()
+{
+	if (db_handle != nullptr)
+	{
+		if (const std::optional<std::string> value = read_setting(db_handle, "journal_operation"))
 		{
-			sqlite3_stmt* stmt = nullptr;
-			const std::string sql = "SELECT COUNT(*) FROM datastore_enumerate WHERE universe_id = ?010;";
-			sqlite3_prepare_v2(db_handle, sql.c_str(), static_cast<int>(sql.size()), &stmt, nullptr);
-			if (stmt != nullptr)
+			for (const SqliteJournalOperation this_operation : { SqliteJournalOperation::Delete, SqliteJournalOperation::Undelete })
 			{
-				sqlite3_bind_int64(stmt, 10, universe_id);
-
-				const int sqlite_result = sqlite3_step(stmt);
-				if (sqlite_result == SQLITE_ROW)
+				if (*value == get_journal_operation_setting(this_operation))
 				{
-					has_enumeration_pending = sqlite3_column_int64(stmt, 0) > 0;
+					return this_operation;
 				}
-				sqlite3_finalize(stmt);
 			}
 		}
+	}
+	return std::nullopt;
+}
+
+std::optional<std::string> SqliteDatastoreWrapper::get_journal_option(const std::string& key)
+{
+	if (db_handle != nullptr)
+	{
+		return read_setting(db_handle, "journal_option_" + key);
+	}
+	return std::nullopt;
+}
+
+void SqliteDatastoreWrapper::set_group_commit_limits(const size_t max_rows, const std::chrono::milliseconds max_age)
+{
+	group_max_rows = max_rows;
+	group_max_age = max_age;
+}
 
-		return has_valid_cursors && (has_entries_pending || has_enumeration_pending);
+void SqliteDatastoreWrapper::set_statement_cache_enabled(const bool enabled)
+{
+	statement_cache_enabled = enabled;
+}
+
+void SqliteDatastoreWrapper::resume_point()
+{
+	if (group_open && (group_rows >= group_max_rows || std::chrono::steady_clock::now() - group_started >= group_max_age))
+	{
+		commit_group();
 	}
+}
 
-	return false;
+void SqliteDatastoreWrapper::flush()
+{
+	commit_group();
 }
 
-void SqliteDatastoreWrapper::write_deleted(const StandardDatastoreEntryName& entry)
+void SqliteDatastoreWrapper::checkpoint()
 {
+	commit_group();
 	if (db_handle != nullptr)
+	{
+		// Truncating also gives the space used by the log back to the filesystem
+		sqlite3_exec(db_handle, "PRAGMA wal_checkpoint(TRUNCATE);", nullptr, nullptr, nullptr);
+	}
+}
+
+void SqliteDatastoreWrapper::begin_group()
+{
+	if (group_open == false && db_handle != nullptr)
+	{
+		// A crash loses at most the uncommitted group, which always ends at a resume point
+		if (sqlite3_exec(db_handle, "BEGIN;", nullptr, nullptr, nullptr) == SQLITE_OK)
+		{
+			group_open = true;
+			group_rows = 0;
+			group_started = std::chrono::steady_clock::now();
+		}
+	}
+	group_rows++;
+}
+
+void SqliteDatastoreWrapper::commit_group()
+{
+	if (group_open && db_handle != nullptr)
+	{
+		sqlite3_exec(db_handle, "COMMIT;", nullptr, nullptr, nullptr);
+		group_open = false;
+		group_rows = 0;
+	}
+}
+
+sqlite3_stmt* SqliteDatastoreWrapper::get_cached_statement(const std::string& sql)
+{
+	if (statement_cache_enabled == false)
 	{
 		sqlite3_stmt* stmt = nullptr;
-		const std::string sql = "INSERT INTO datastore_deleted (universe_id, datastore_name, scope, key_name) VALUES (?010, ?020, ?030, ?040);";
 		sqlite3_prepare_v2(db_handle, sql.c_str(), static_cast<int>(sql.size()), &stmt, nullptr);
+		return stmt;
+	}
+
+	const auto cache_it = statement_cache.find(sql);
+	if (cache_it != statement_cache.end())
+	{
+		return cache_it->second;
+	}
+
+	sqlite3_stmt* stmt = nullptr;
+	sqlite3_prepare_v3(db_handle, sql.c_str(), static_cast<int>(sql.size()), SQLITE_PREPARE_PERSISTENT, &stmt, nullptr);
+	if (stmt != nullptr)
+	{
+		statement_cache[sql] = stmt;
+	}
+	return stmt;
+}
+
+void SqliteDatastoreWrapper::release_cached_statement(sqlite3_stmt* const stmt)
+{
+	if (statement_cache_enabled == false)
+	{
+		sqlite3_finalize(stmt);
+		return;
+	}
+	// Clearing bindings also drops any SQLITE_STATIC pointers into buffers the caller is about to free
+	sqlite3_reset(stmt);
+	sqlite3_clear_bindings(stmt);
+}
+
+void SqliteDatastoreWrapper::write_deleted(const StandardDatastoreEntryName& entry)
+{
+	if (db_handle != nullptr)
+	{
+		begin_group();
+		sqlite3_stmt* stmt = get_cached_statement("INSERT INTO datastore_deleted (universe_id, datastore_name, scope, key_name) VALUES (?010, ?020, ?030, ?040);");
 		if (stmt != nullptr)
 		{
 			sqlite3_bind_int64(stmt, 10, entry.get_universe_id());
@@ -491,7 +863,7 @@ void SqliteDatastoreWrapper::write_deleted(const StandardDatastoreEntryName& ent
 
 			sqlite3_step(stmt);
 
-			sqlite3_finalize(stmt);
+			release_cached_statement(stmt);
 		}
 	}
 }
@@ -499,9 +871,8 @@ void SqliteDatastoreWrapper::write_details(const StandardDatastoreEntryFull& det
 {
 	if (db_handle != nullptr)
 	{
-		sqlite3_stmt* stmt = nullptr;
-		const std::string sql = "INSERT INTO datastore (universe_id, datastore_name, scope, key_name, version, data_type, data_raw, data_str, data_num, data_bool, userids, attributes) VALUES (?010, ?020, ?030, ?040, ?050, ?060, ?070, ?080, ?090, ?095, ?100, ?110);";
-		sqlite3_prepare_v2(db_handle, sql.c_str(), static_cast<int>(sql.size()), &stmt, nullptr);
+		begin_group();
+		sqlite3_stmt* stmt = get_cached_statement("INSERT INTO datastore (universe_id, datastore_name, scope, key_name, version, data_type, data_raw, data_str, data_num, data_bool, userids, attributes) VALUES (?010, ?020, ?030, ?040, ?050, ?060, ?070, ?080, ?090, ?095, ?100, ?110);");
 		if (stmt != nullptr)
 		{
 			sqlite3_bind_int64(stmt, 10, details.get_universe_id());
@@ -510,20 +881,34 @@ void SqliteDatastoreWrapper::write_details(const StandardDatastoreEntryFull& det
 			sqlite3_bind_text(stmt, 40, details.get_key_name().toStdString().c_str(), -1, SQLITE_TRANSIENT);
 			sqlite3_bind_text(stmt, 50, details.get_version().toStdString().c_str(), -1, SQLITE_TRANSIENT);
 			sqlite3_bind_text(stmt, 60, get_enum_string(details.get_entry_type()).toStdString().c_str(), -1, SQLITE_TRANSIENT);
-			sqlite3_bind_text(stmt, 70, details.get_data_raw().toStdString().c_str(), -1, SQLITE_TRANSIENT);
-			if (details.get_entry_type() == DatastoreEntryType::String)
+			// Raw data is already utf-8 and outlives the statement, so sqlite can use it without another copy
+			const QByteArray& data_raw = details.get_data_raw_utf8();
+			QByteArray data_compressed;
+			if (value_codec == SqliteValueCodec::QCompress)
 			{
-				sqlite3_bind_text(stmt, 80, details.get_data_decoded().toStdString().c_str(), -1, SQLITE_TRANSIENT);
+				data_compressed = qCompress(data_raw);
+				sqlite3_bind_blob(stmt, 70, data_compressed.constData(), static_cast<int>(data_compressed.size()), SQLITE_STATIC);
+			}
+			else
+			{
+				sqlite3_bind_text(stmt, 70, data_raw.constData(), static_cast<int>(data_raw.size()), SQLITE_STATIC);
+			}
+			QByteArray data_decoded;
+			// Compressed files leave out the decoded string, it would be an uncompressed copy of nearly the same data
+			if (details.get_entry_type() == DatastoreEntryType::String && value_codec == SqliteValueCodec::None)
+			{
+				data_decoded = details.get_data_decoded().toUtf8();
+				sqlite3_bind_text(stmt, 80, data_decoded.constData(), static_cast<int>(data_decoded.size()), SQLITE_STATIC);
 			}
 			bool is_double = false;
-			const double as_double = details.get_data_raw().toDouble(&is_double);
+			const double as_double = data_raw.toDouble(&is_double);
 			if (is_double)
 			{
 				sqlite3_bind_double(stmt, 90, as_double);
 			}
 			if (details.get_entry_type() == DatastoreEntryType::Bool)
 			{
-				const int value = details.get_data_raw() == "true" ? 1 : 0;
+				const int value = data_raw == "true" ? 1 : 0;
 				sqlite3_bind_int(stmt, 95, value);
 			}
 			if (details.get_userids())
@@ -537,7 +922,7 @@ void SqliteDatastoreWrapper::write_details(const StandardDatastoreEntryFull& det
 
 			sqlite3_step(stmt);
 
-			sqlite3_finalize(stmt);
+			release_cached_statement(stmt);
 		}
 	}
 }
@@ -546,11 +931,10 @@ void SqliteDatastoreWrapper::write_enumeration(long long universe_id, const std:
 {
 	if (db_handle != nullptr)
 	{
+		begin_group();
 		if (cursor)
 		{
-			sqlite3_stmt* stmt = nullptr;
-			const std::string sql = "UPDATE datastore_enumerate SET next_cursor = ?030 WHERE universe_id = ?010 AND datastore_name = ?020;";
-			sqlite3_prepare_v2(db_handle, sql.c_str(), static_cast<int>(sql.size()), &stmt, nullptr);
+			sqlite3_stmt* stmt = get_cached_statement("UPDATE datastore_enumerate SET next_cursor = ?030 WHERE universe_id = ?010 AND datastore_name = ?020;");
 			if (stmt != nullptr)
 			{
 				sqlite3_bind_int64(stmt, 10, universe_id);
@@ -560,14 +944,12 @@ void SqliteDatastoreWrapper::write_enumeration(long long universe_id, const std:
 
 				sqlite3_step(stmt);
 
-				sqlite3_finalize(stmt);
+				release_cached_statement(stmt);
 			}
 		}
 		else
 		{
-			sqlite3_stmt* stmt = nullptr;
-			const std::string sql = "INSERT INTO datastore_enumerate (universe_id, datastore_name) VALUES (?010, ?020);";
-			sqlite3_prepare_v2(db_handle, sql.c_str(), static_cast<int>(sql.size()), &stmt, nullptr);
+			sqlite3_stmt* stmt = get_cached_statement("INSERT INTO datastore_enumerate (universe_id, datastore_name) VALUES (?010, ?020);");
 			if (stmt != nullptr)
 			{
 				sqlite3_bind_int64(stmt, 10, universe_id);
@@ -575,7 +957,7 @@ void SqliteDatastoreWrapper::write_enumeration(long long universe_id, const std:
 
 				sqlite3_step(stmt);
 
-				sqlite3_finalize(stmt);
+				release_cached_statement(stmt);
 			}
 		}
 	}
@@ -585,10 +967,9 @@ void SqliteDatastoreWrapper::write_enumeration_metadata(const long long universe
 {
 	if (db_handle != nullptr)
 	{
+		begin_group();
 		{
-			sqlite3_stmt* stmt = nullptr;
-			const std::string sql = "INSERT INTO datastore_enumerate_meta (universe_id, key, value) VALUES (?010, 'search_scope', ?020);";
-			sqlite3_prepare_v2(db_handle, sql.c_str(), static_cast<int>(sql.size()), &stmt, nullptr);
+			sqlite3_stmt* stmt = get_cached_statement("INSERT INTO datastore_enumerate_meta (universe_id, key, value) VALUES (?010, 'search_scope', ?020);");
 			if (stmt != nullptr)
 			{
 				sqlite3_bind_int64(stmt, 10, universe_id);
@@ -596,14 +977,12 @@ void SqliteDatastoreWrapper::write_enumeration_metadata(const long long universe
 
 				sqlite3_step(stmt);
 
-				sqlite3_finalize(stmt);
+				release_cached_statement(stmt);
 			}
 		}
 
 		{
-			sqlite3_stmt* stmt = nullptr;
-			const std::string sql = "INSERT INTO datastore_enumerate_meta (universe_id, key, value) VALUES (?010, 'search_key_prefix', ?020);";
-			sqlite3_prepare_v2(db_handle, sql.c_str(), static_cast<int>(sql.size()), &stmt, nullptr);
+			sqlite3_stmt* stmt = get_cached_statement("INSERT INTO datastore_enumerate_meta (universe_id, key, value) VALUES (?010, 'search_key_prefix', ?020);");
 			if (stmt != nullptr)
 			{
 				sqlite3_bind_int64(stmt, 10, universe_id);
@@ -611,19 +990,57 @@ void SqliteDatastoreWrapper::write_enumeration_metadata(const long long universe
 
 				sqlite3_step(stmt);
 
-				sqlite3_finalize(stmt);
+				release_cached_statement(stmt);
 			}
 		}
 	}
 }
 
+void SqliteDatastoreWrapper::write_journal_operation(const SqliteJournalOperation operation)
+{
+	if (db_handle != nullptr)
+	{
+		begin_group();
+		write_setting(db_handle, "journal_operation", get_journal_operation_setting(operation));
+	}
+}
+
+void SqliteDatastoreWrapper::write_journal_option(const std::string& key, const std::string& value)
+{
+	if (db_handle != nullptr)
+	{
+		begin_group();
+		write_setting(db_handle, "journal_option_" + key, value);
+	}
+}
+
+void SqliteDatastoreWrapper::write_outcome(const StandardDatastoreEntryName& entry, const std::string& outcome)
+{
+	if (db_handle != nullptr)
+	{
+		begin_group();
+		sqlite3_stmt* stmt = get_cached_statement("INSERT OR REPLACE INTO datastore_outcome (universe_id, datastore_name, scope, key_name, outcome) VALUES (?010, ?020, ?030, ?040, ?050);");
+		if (stmt != nullptr)
+		{
+			sqlite3_bind_int64(stmt, 10, entry.get_universe_id());
+			sqlite3_bind_text(stmt, 20, entry.get_datastore_name().toStdString().c_str(), -1, SQLITE_TRANSIENT);
+			sqlite3_bind_text(stmt, 30, entry.get_scope().toStdString().c_str(), -1, SQLITE_TRANSIENT);
+			sqlite3_bind_text(stmt, 40, entry.get_key().toStdString().c_str(), -1, SQLITE_TRANSIENT);
+			sqlite3_bind_text(stmt, 50, outcome.c_str(), -1, SQLITE_TRANSIENT);
+
+			sqlite3_step(stmt);
+
+			release_cached_statement(stmt);
+		}
+	}
+}
+
 void SqliteDatastoreWrapper::write_pending(const StandardDatastoreEntryName& entry)
 {
 	if (db_handle != nullptr)
 	{
-		sqlite3_stmt* stmt = nullptr;
-		const std::string sql = "INSERT INTO datastore_pending (universe_id, datastore_name, scope, key_name) VALUES (?010, ?020, ?030, ?040);";
-		sqlite3_prepare_v2(db_handle, sql.c_str(), static_cast<int>(sql.size()), &stmt, nullptr);
+		begin_group();
+		sqlite3_stmt* stmt = get_cached_statement("INSERT INTO datastore_pending (universe_id, datastore_name, scope, key_name) VALUES (?010, ?020, ?030, ?040);");
 		if (stmt != nullptr)
 		{
 			sqlite3_bind_int64(stmt, 10, entry.get_universe_id());
@@ -633,7 +1050,38 @@ void SqliteDatastoreWrapper::write_pending(const StandardDatastoreEntryName& ent
 
 			sqlite3_step(stmt);
 
-			sqlite3_finalize(stmt);
+			release_cached_statement(stmt);
+		}
+	}
+}
+
+void SqliteDatastoreWrapper::write_upload_checkpoint(const long long row_id)
+{
+	if (db_handle != nullptr)
+	{
+		begin_group();
+		write_setting(db_handle, "upload_row_id", std::to_string(row_id));
+	}
+}
+
+void SqliteDatastoreWrapper::write_upload_manifest(const StandardDatastoreEntryFull& details)
+{
+	if (db_handle != nullptr)
+	{
+		begin_group();
+		sqlite3_stmt* stmt = get_cached_statement("INSERT OR REPLACE INTO temp.upload_manifest (universe_id, datastore_name, scope, key_name, content_md5) VALUES (?010, ?020, ?030, ?040, ?050);");
+		if (stmt != nullptr)
+		{
+			const QByteArray content_hash = details.get_content_hash();
+			sqlite3_bind_int64(stmt, 10, details.get_universe_id());
+			sqlite3_bind_text(stmt, 20, details.get_datastore_name().toStdString().c_str(), -1, SQLITE_TRANSIENT);
+			sqlite3_bind_text(stmt, 30, details.get_scope().toStdString().c_str(), -1, SQLITE_TRANSIENT);
+			sqlite3_bind_text(stmt, 40, details.get_key_name().toStdString().c_str(), -1, SQLITE_TRANSIENT);
+			sqlite3_bind_blob(stmt, 50, content_hash.constData(), static_cast<int>(content_hash.size()), SQLITE_TRANSIENT);
+
+			sqlite3_step(stmt);
+
+			release_cached_statement(stmt);
 		}
 	}
 }
@@ -642,9 +1090,8 @@ void SqliteDatastoreWrapper::delete_enumeration(const long long universe_id, con
 {
 	if (db_handle != nullptr)
 	{
-		sqlite3_stmt* stmt = nullptr;
-		const std::string sql = "DELETE FROM datastore_enumerate WHERE universe_id = ?010 AND datastore_name = ?020;";
-		sqlite3_prepare_v2(db_handle, sql.c_str(), static_cast<int>(sql.size()), &stmt, nullptr);
+		begin_group();
+		sqlite3_stmt* stmt = get_cached_statement("DELETE FROM datastore_enumerate WHERE universe_id = ?010 AND datastore_name = ?020;");
 		if (stmt != nullptr)
 		{
 			sqlite3_bind_int64(stmt, 10, universe_id);
@@ -652,7 +1099,7 @@ void SqliteDatastoreWrapper::delete_enumeration(const long long universe_id, con
 
 			sqlite3_step(stmt);
 
-			sqlite3_finalize(stmt);
+			release_cached_statement(stmt);
 		}
 	}
 }
@@ -667,9 +1114,8 @@ void SqliteDatastoreWrapper::delete_pending(const StandardDatastoreEntryName& en
 {
 	if (db_handle != nullptr)
 	{
-		sqlite3_stmt* stmt = nullptr;
-		const std::string sql = "DELETE FROM datastore_pending WHERE universe_id = ?010 AND datastore_name = ?020 AND scope = ?030 AND key_name = ?040;";
-		sqlite3_prepare_v2(db_handle, sql.c_str(), static_cast<int>(sql.size()), &stmt, nullptr);
+		begin_group();
+		sqlite3_stmt* stmt = get_cached_statement("DELETE FROM datastore_pending WHERE universe_id = ?010 AND datastore_name = ?020 AND scope = ?030 AND key_name = ?040;");
 		if (stmt != nullptr)
 		{
 			sqlite3_bind_int64(stmt, 10, entry.get_universe_id());
@@ -679,57 +1125,83 @@ void SqliteDatastoreWrapper::delete_pending(const StandardDatastoreEntryName& en
 
 			sqlite3_step(stmt);
 
-			sqlite3_finalize(stmt);
+			release_cached_statement(stmt);
 		}
 	}
 }
 
-std::optional<std::string> SqliteDatastoreWrapper::get_enumerating_cursor(const long long universe_id)
+void SqliteDatastoreWrapper::delete_upload_checkpoint()
 {
-	std::optional<std::string> result;
+	if (db_handle != nullptr)
+	{
+		begin_group();
+		sqlite3_exec(db_handle, "DELETE FROM datastore_settings WHERE key = 'upload_row_id';", nullptr, nullptr, nullptr);
+	}
+}
 
+void SqliteDatastoreWrapper::delete_upload_manifest()
+{
 	if (db_handle != nullptr)
 	{
-		sqlite3_stmt* stmt = nullptr;
-		const std::string sql = "SELECT next_cursor FROM datastore_enumerate WHERE universe_id = ?010 AND next_cursor IS NOT NULL;";
-		sqlite3_prepare_v2(db_handle, sql.c_str(), static_cast<int>(sql.size()), &stmt, nullptr);
-		if (stmt != nullptr)
-		{
-			sqlite3_bind_int64(stmt, 10, universe_id);
+		begin_group();
+		// Temporary tables live outside the dump file, so older files need no upgrade and nothing is left behind
+		sqlite3_exec(db_handle, "CREATE TEMP TABLE IF NOT EXISTS upload_manifest (universe_id INTEGER NOT NULL, datastore_name TEXT NOT NULL, scope TEXT NOT NULL, key_name TEXT NOT NULL, content_md5 BLOB NOT NULL, PRIMARY KEY (universe_id, datastore_name, scope, key_name))", nullptr, nullptr, nullptr);
+		sqlite3_exec(db_handle, "DELETE FROM temp.upload_manifest;", nullptr, nullptr, nullptr);
+	}
+}
+
+std::map<std::string, std::string> SqliteDatastoreWrapper::get_enumerating_cursors(const long long universe_id)
+{
+	std::map<std::string, std::string> result;
 
+	if (db_handle != nullptr)
+	{
+		sqlite3_stmt* stmt = get_cached_statement("SELECT datastore_name, next_cursor FROM datastore_enumerate WHERE universe_id = ?010 AND next_cursor IS NOT NULL;");
+		sqlite3_bind_int64(stmt, 10, universe_id);
+		while (stmt != nullptr)
+		{
 			const int sqlite_result = sqlite3_step(stmt);
 			if (sqlite_result == SQLITE_ROW)
 			{
-				result = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+				const std::string this_name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+				const std::string this_cursor = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+				result[this_name] = this_cursor;
+			}
+			else
+			{
+				release_cached_statement(stmt);
+				stmt = nullptr;
 			}
-
-			sqlite3_finalize(stmt);
 		}
 	}
 
 	return result;
 }
 
-std::optional<std::string> SqliteDatastoreWrapper::get_enumerating_datastore(const long long universe_id)
+std::map<std::string, size_t> SqliteDatastoreWrapper::get_outcome_counts(const long long universe_id)
 {
-	std::optional<std::string> result;
+	std::map<std::string, size_t> result;
 
 	if (db_handle != nullptr)
 	{
-		sqlite3_stmt* stmt = nullptr;
-		const std::string sql = "SELECT datastore_name FROM datastore_enumerate WHERE universe_id = ?010 AND next_cursor IS NOT NULL;";
-		sqlite3_prepare_v2(db_handle, sql.c_str(), static_cast<int>(sql.size()), &stmt, nullptr);
+		sqlite3_stmt* stmt = get_cached_statement("SELECT outcome, COUNT(*) FROM datastore_outcome WHERE universe_id = ?010 GROUP BY outcome;");
 		if (stmt != nullptr)
 		{
 			sqlite3_bind_int64(stmt, 10, universe_id);
-
+		}
+		while (stmt != nullptr)
+		{
 			const int sqlite_result = sqlite3_step(stmt);
 			if (sqlite_result == SQLITE_ROW)
 			{
-				result = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+				const std::string outcome = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+				result[outcome] = static_cast<size_t>(sqlite3_column_int64(stmt, 1));
+			}
+			else
+			{
+				release_cached_statement(stmt);
+				stmt = nullptr;
 			}
-
-			sqlite3_finalize(stmt);
 		}
 	}
 
@@ -742,9 +1214,7 @@ std::optional<std::string> SqliteDatastoreWrapper::get_enumeration_search_key_pr
 
 	if (db_handle != nullptr)
 	{
-		sqlite3_stmt* stmt = nullptr;
-		const std::string sql = "SELECT value FROM datastore_enumerate_meta WHERE universe_id = ?010 AND key = 'search_key_prefix';";
-		sqlite3_prepare_v2(db_handle, sql.c_str(), static_cast<int>(sql.size()), &stmt, nullptr);
+		sqlite3_stmt* stmt = get_cached_statement("SELECT value FROM datastore_enumerate_meta WHERE universe_id = ?010 AND key = 'search_key_prefix';");
 		if (stmt != nullptr)
 		{
 			sqlite3_bind_int64(stmt, 10, universe_id);
@@ -755,7 +1225,7 @@ std::optional<std::string> SqliteDatastoreWrapper::get_enumeration_search_key_pr
 				result = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
 			}
 
-			sqlite3_finalize(stmt);
+			release_cached_statement(stmt);
 		}
 	}
 
@@ -768,9 +1238,7 @@ std::optional<std::string> SqliteDatastoreWrapper::get_enumeration_search_scope(
 
 	if (db_handle != nullptr)
 	{
-		sqlite3_stmt* stmt = nullptr;
-		const std::string sql = "SELECT value FROM datastore_enumerate_meta WHERE universe_id = ?010 AND key = 'search_scope';";
-		sqlite3_prepare_v2(db_handle, sql.c_str(), static_cast<int>(sql.size()), &stmt, nullptr);
+		sqlite3_stmt* stmt = get_cached_statement("SELECT value FROM datastore_enumerate_meta WHERE universe_id = ?010 AND key = 'search_scope';");
 		if (stmt != nullptr)
 		{
 			sqlite3_bind_int64(stmt, 10, universe_id);
@@ -781,7 +1249,7 @@ std::optional<std::string> SqliteDatastoreWrapper::get_enumeration_search_scope(
 				result = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
 			}
 
-			sqlite3_finalize(stmt);
+			release_cached_statement(stmt);
 		}
 	}
 
@@ -795,9 +1263,7 @@ std::vector<std::string> SqliteDatastoreWrapper::get_pending_datastores(const lo
 	if (db_handle != nullptr)
 	{
 		{
-			sqlite3_stmt* stmt = nullptr;
-			const std::string sql = "SELECT count(*) FROM datastore_enumerate WHERE universe_id = ?010 AND next_cursor IS NULL;";
-			sqlite3_prepare_v2(db_handle, sql.c_str(), static_cast<int>(sql.size()), &stmt, nullptr);
+			sqlite3_stmt* stmt = get_cached_statement("SELECT count(*) FROM datastore_enumerate WHERE universe_id = ?010 AND next_cursor IS NULL;");
 			if (stmt != nullptr)
 			{
 				sqlite3_bind_int64(stmt, 10, universe_id);
@@ -808,14 +1274,12 @@ std::vector<std::string> SqliteDatastoreWrapper::get_pending_datastores(const lo
 					result.reserve(static_cast<size_t>(sqlite3_column_int64(stmt, 0)));
 				}
 
-				sqlite3_finalize(stmt);
+				release_cached_statement(stmt);
 			}
 		}
 
 		{
-			sqlite3_stmt* stmt = nullptr;
-			const std::string sql = "SELECT datastore_name FROM datastore_enumerate WHERE universe_id = ?010 AND next_cursor IS NULL;";
-			sqlite3_prepare_v2(db_handle, sql.c_str(), static_cast<int>(sql.size()), &stmt, nullptr);
+			sqlite3_stmt* stmt = get_cached_statement("SELECT datastore_name FROM datastore_enumerate WHERE universe_id = ?010 AND next_cursor IS NULL;");
 			sqlite3_bind_int64(stmt, 10, universe_id);
 			while (stmt != nullptr)
 			{
@@ -827,7 +1291,7 @@ std::vector<std::string> SqliteDatastoreWrapper::get_pending_datastores(const lo
 				}
 				else
 				{
-					sqlite3_finalize(stmt);
+					release_cached_statement(stmt);
 					stmt = nullptr;
 				}
 			}
@@ -837,149 +1301,246 @@ std::vector<std::string> SqliteDatastoreWrapper::get_pending_datastores(const lo
 	return result;
 }
 
-std::vector<StandardDatastoreEntryName> SqliteDatastoreWrapper::get_pending_entries(const long long universe_id)
+size_t SqliteDatastoreWrapper::get_pending_count(const long long universe_id)
 {
-	std::vector<StandardDatastoreEntryName> result;
+	size_t result = 0;
 
 	if (db_handle != nullptr)
 	{
+		sqlite3_stmt* stmt = get_cached_statement("SELECT count(*) FROM datastore_pending WHERE universe_id = ?010;");
+		if (stmt != nullptr)
 		{
-			sqlite3_stmt* stmt = nullptr;
-			const std::string sql = "SELECT count(*) FROM datastore_pending WHERE universe_id = ?010;";
-			sqlite3_prepare_v2(db_handle, sql.c_str(), static_cast<int>(sql.size()), &stmt, nullptr);
-			if (stmt != nullptr)
+			sqlite3_bind_int64(stmt, 10, universe_id);
+
+			const int sqlite_result = sqlite3_step(stmt);
+			if (sqlite_result == SQLITE_ROW)
 			{
-				sqlite3_bind_int64(stmt, 10, universe_id);
+				result = static_cast<size_t>(sqlite3_column_int64(stmt, 0));
+			}
 
-				const int sqlite_result = sqlite3_step(stmt);
-				if (sqlite_result == SQLITE_ROW)
-				{
-					result.reserve(static_cast<size_t>(sqlite3_column_int64(stmt, 0)));
-				}
+			release_cached_statement(stmt);
+		}
+	}
+
+	return result;
+}
+
+SqlitePendingEntryReader SqliteDatastoreWrapper::get_pending_reader(const long long universe_id)
+{
+	long long last_id = 0;
 
-				sqlite3_finalize(stmt);
+	if (db_handle != nullptr)
+	{
+		sqlite3_stmt* stmt = get_cached_statement("SELECT max(id) FROM datastore_pending WHERE universe_id = ?010;");
+		if (stmt != nullptr)
+		{
+			sqlite3_bind_int64(stmt, 10, universe_id);
+
+			const int sqlite_result = sqlite3_step(stmt);
+			if (sqlite_result == SQLITE_ROW && sqlite3_column_type(stmt, 0) == SQLITE_INTEGER)
+			{
+				last_id = sqlite3_column_int64(stmt, 0);
 			}
+
+			release_cached_statement(stmt);
 		}
+	}
+
+	return SqlitePendingEntryReader{ universe_id, last_id };
+}
+
+void SqliteDatastoreWrapper::extend_pending_reader(SqlitePendingEntryReader& reader)
+{
+	reader.last_id = std::max(reader.last_id, get_pending_reader(reader.universe_id).last_id);
+}
 
+StandardDatastoreEntryNameList SqliteDatastoreWrapper::get_pending_entries(SqlitePendingEntryReader& reader, const size_t page_size)
+{
+	StandardDatastoreEntryNameList result;
+
+	if (db_handle != nullptr && reader.is_done() == false)
+	{
+		// Keyset pagination, each page starts from an index seek instead of skipping over earlier rows
+		sqlite3_stmt* stmt = get_cached_statement("SELECT id, universe_id, datastore_name, scope, key_name FROM datastore_pending WHERE universe_id = ?010 AND id > ?020 AND id <= ?030 ORDER BY id LIMIT ?040;");
+		if (stmt != nullptr)
 		{
-			sqlite3_stmt* stmt = nullptr;
-			const std::string sql = "SELECT universe_id, datastore_name, scope, key_name FROM datastore_pending WHERE universe_id = ?010;";
-			sqlite3_prepare_v2(db_handle, sql.c_str(), static_cast<int>(sql.size()), &stmt, nullptr);
-			sqlite3_bind_int64(stmt, 10, universe_id);
-			while (stmt != nullptr)
+			sqlite3_bind_int64(stmt, 10, reader.universe_id);
+			sqlite3_bind_int64(stmt, 20, reader.after_id);
+			sqlite3_bind_int64(stmt, 30, reader.last_id);
+			sqlite3_bind_int64(stmt, 40, static_cast<sqlite3_int64>(page_size));
+		}
+		while (stmt != nullptr)
+		{
+			const int sqlite_result = sqlite3_step(stmt);
+			if (sqlite_result == SQLITE_ROW)
 			{
-				const int sqlite_result = sqlite3_step(stmt);
-				if (sqlite_result == SQLITE_ROW)
-				{
-					const long long this_universe_id = sqlite3_column_int64(stmt, 0);
-					const QString this_datastore_name = QString{ reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)) };
-					const QString this_scope = QString{ reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2)) };
-					const QString this_key_name = QString{ reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3)) };
+				reader.after_id = sqlite3_column_int64(stmt, 0);
 
-					const StandardDatastoreEntryName this_entry{ this_universe_id, this_datastore_name, this_key_name, this_scope };
-					result.push_back(this_entry);
-				}
-				else
-				{
-					sqlite3_finalize(stmt);
-					stmt = nullptr;
-				}
+				const long long this_universe_id = sqlite3_column_int64(stmt, 1);
+				const QString this_datastore_name = QString{ reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2)) };
+				const QString this_scope = QString{ reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3)) };
+				const QString this_key_name = QString{ reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4)) };
+
+				const StandardDatastoreEntryName this_entry{ this_universe_id, this_datastore_name, this_key_name, this_scope };
+				result.push_back(this_entry);
 			}
+			else
+			{
+				release_cached_statement(stmt);
+				stmt = nullptr;
+			}
+		}
+
+		if (result.size() < page_size)
+		{
+			// A short page means no rows are left up to the last id
+			reader.after_id = reader.last_id;
 		}
 	}
 
 	return result;
 }
 
-std::optional<std::vector<StandardDatastoreEntryFull>> SqliteDatastoreReader::read_all(const std::string& file_path)
+std::optional<long long> SqliteDatastoreWrapper::get_upload_checkpoint()
 {
-	sqlite3* db_handle = nullptr;
-	if (sqlite3_open(file_path.c_str(), &db_handle) != SQLITE_OK)
+	if (db_handle != nullptr)
 	{
-		return std::nullopt;
+		if (const std::optional<std::string> value = read_setting(db_handle, "upload_row_id"))
+		{
+			bool is_valid = false;
+			const long long row_id = QString::fromStdString(*value).toLongLong(&is_valid);
+			if (is_valid)
+			{
+				return row_id;
+			}
+		}
 	}
+	return std::nullopt;
+}
 
-	std::vector<StandardDatastoreEntryFull> result;
-	{
-		const std::string sql = "SELECT universe_id, datastore_name, scope, key_name, version, data_type, data_raw, data_str, data_num, data_bool, userids, attributes FROM datastore;";
-
-		sqlite3_stmt* stmt = nullptr;
-		sqlite3_prepare_v2(db_handle, sql.c_str(), static_cast<int>(sql.size()), &stmt, nullptr);
+SqliteStoredEntryReader SqliteDatastoreWrapper::get_entry_reader(const long long after_row_id)
+{
+	long long last_row_id = 0;
 
-		while (true)
+	if (db_handle != nullptr)
+	{
+		sqlite3_stmt* stmt = get_cached_statement("SELECT max(rowid) FROM datastore;");
+		if (stmt != nullptr)
 		{
 			const int sqlite_result = sqlite3_step(stmt);
-			if (sqlite_result == SQLITE_ROW)
+			if (sqlite_result == SQLITE_ROW && sqlite3_column_type(stmt, 0) == SQLITE_INTEGER)
 			{
-				std::optional<long long> opt_universe_id;
-				if (sqlite3_column_type(stmt, 0) == SQLITE_INTEGER)
-				{
-					opt_universe_id = sqlite3_column_int64(stmt, 0);
-				}
+				last_row_id = sqlite3_column_int64(stmt, 0);
+			}
 
-				std::optional<QString> opt_datastore_name;
-				if (sqlite3_column_type(stmt, 1) == SQLITE_TEXT)
-				{
-					opt_datastore_name = QString{ reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)) };
-				}
+			release_cached_statement(stmt);
+		}
+	}
 
-				std::optional<QString> opt_scope;
-				if (sqlite3_column_type(stmt, 2) == SQLITE_TEXT)
-				{
-					opt_scope = QString{ reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2)) };
-				}
+	return SqliteStoredEntryReader{ after_row_id, last_row_id };
+}
 
-				std::optional<QString> opt_key_name;
-				if (sqlite3_column_type(stmt, 3) == SQLITE_TEXT)
-				{
-					opt_key_name = QString{ reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3)) };
-				}
+size_t SqliteDatastoreWrapper::get_entry_count(const SqliteStoredEntryReader& reader)
+{
+	size_t result = 0;
 
-				std::optional<QString> opt_version;
-				if (sqlite3_column_type(stmt, 4) == SQLITE_TEXT)
-				{
-					opt_version = QString{ reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4)) };
-				}
+	if (db_handle != nullptr)
+	{
+		sqlite3_stmt* stmt = get_cached_statement("SELECT count(*) FROM datastore WHERE rowid > ?010 AND rowid <= ?020;");
+		if (stmt != nullptr)
+		{
+			sqlite3_bind_int64(stmt, 10, reader.after_row_id);
+			sqlite3_bind_int64(stmt, 20, reader.last_row_id);
 
-				// Slot 5 is data_type
+			const int sqlite_result = sqlite3_step(stmt);
+			if (sqlite_result == SQLITE_ROW)
+			{
+				result = static_cast<size_t>(sqlite3_column_int64(stmt, 0));
+			}
 
-				std::optional<QString> opt_data_raw;
-				if (sqlite3_column_type(stmt, 6) == SQLITE_TEXT)
-				{
-					opt_data_raw = QString{ reinterpret_cast<const char*>(sqlite3_column_text(stmt, 6)) };
-				}
+			release_cached_statement(stmt);
+		}
+	}
 
-				std::optional<QString> opt_userids;
-				if (sqlite3_column_type(stmt, 10) == SQLITE_TEXT)
-				{
-					opt_userids = QString{ reinterpret_cast<const char*>(sqlite3_column_text(stmt, 10)) };
-				}
+	return result;
+}
+
+std::vector<StandardDatastoreEntryFull> SqliteDatastoreWrapper::get_entries(SqliteStoredEntryReader& reader, const size_t page_size)
+{
+	std::vector<StandardDatastoreEntryFull> result;
 
-				std::optional<QString> opt_attributes;
-				if (sqlite3_column_type(stmt, 11) == SQLITE_TEXT)
+	if (db_handle != nullptr && reader.is_done() == false)
+	{
+		result.reserve(page_size);
+
+		sqlite3_stmt* stmt = get_cached_statement("SELECT rowid, universe_id, datastore_name, scope, key_name, version, data_type, data_raw, data_str, data_num, data_bool, userids, attributes FROM datastore WHERE rowid > ?010 AND rowid <= ?020 ORDER BY rowid LIMIT ?030;");
+		if (stmt != nullptr)
+		{
+			sqlite3_bind_int64(stmt, 10, reader.after_row_id);
+			sqlite3_bind_int64(stmt, 20, reader.last_row_id);
+			sqlite3_bind_int64(stmt, 30, static_cast<sqlite3_int64>(page_size));
+		}
+		size_t rows_read = 0;
+		while (stmt != nullptr)
+		{
+			const int sqlite_result = sqlite3_step(stmt);
+			if (sqlite_result == SQLITE_ROW)
+			{
+				rows_read++;
+				reader.after_row_id = sqlite3_column_int64(stmt, 0);
+				if (std::optional<StandardDatastoreEntryFull> this_entry = read_entry_row(stmt, 1, value_codec))
 				{
-					opt_attributes = QString{ reinterpret_cast<const char*>(sqlite3_column_text(stmt, 11)) };
+					result.push_back(std::move(*this_entry));
 				}
-
-				if (opt_universe_id && opt_datastore_name && opt_scope && opt_key_name && opt_version && opt_data_raw)
+				else
 				{
-					result.push_back(StandardDatastoreEntryFull{
-						*opt_universe_id, *opt_datastore_name, *opt_scope, *opt_key_name, *opt_version, opt_userids, opt_attributes, *opt_data_raw
-					});
+					reader.unreadable_count++;
 				}
 			}
-			else if (sqlite_result == SQLITE_DONE)
-			{
-				sqlite3_finalize(stmt);
-				return result;
-			}
 			else
 			{
-				sqlite3_finalize(stmt);
-				return std::nullopt;
+				release_cached_statement(stmt);
+				stmt = nullptr;
 			}
 		}
+
+		if (rows_read < page_size)
+		{
+			// A short page means no rows are left up to the last row id
+			reader.after_row_id = reader.last_row_id;
+		}
 	}
+
+	return result;
 }
 
 // NOLINTEND(*-no-int-to-ptr)
+
+bool SqliteDatastoreWrapper::is_in_upload_manifest(const StandardDatastoreEntryFull& details)
+{
+	bool result = false;
+
+	if (db_handle != nullptr)
+	{
+		sqlite3_stmt* stmt = get_cached_statement("SELECT COUNT(*) FROM temp.upload_manifest WHERE universe_id = ?010 AND datastore_name = ?020 AND scope = ?030 AND key_name = ?040 AND content_md5 = ?050;");
+		if (stmt != nullptr)
+		{
+			const QByteArray content_hash = details.get_content_hash();
+			sqlite3_bind_int64(stmt, 10, details.get_universe_id());
+			sqlite3_bind_text(stmt, 20, details.get_datastore_name().toStdString().c_str(), -1, SQLITE_TRANSIENT);
+			sqlite3_bind_text(stmt, 30, details.get_scope().toStdString().c_str(), -1, SQLITE_TRANSIENT);
+			sqlite3_bind_text(stmt, 40, details.get_key_name().toStdString().c_str(), -1, SQLITE_TRANSIENT);
+			sqlite3_bind_blob(stmt, 50, content_hash.constData(), static_cast<int>(content_hash.size()), SQLITE_TRANSIENT);
+
+			const int sqlite_result = sqlite3_step(stmt);
+			if (sqlite_result == SQLITE_ROW)
+			{
+				result = sqlite3_column_int64(stmt, 0) > 0;
+			}
+
+			release_cached_statement(stmt);
+		}
+	}
+
+	return result;
+}
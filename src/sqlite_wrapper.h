@@ -1,52 +1,153 @@
 #pragma once
 
+#include <cstddef>
+
+#include <chrono>
+#include <map>
 #include <memory>
 #include <optional>
 #include <string>
 #include <vector>
 
+#include "util_enum.h"
+
 struct sqlite3;
+struct sqlite3_stmt;
 
 class StandardDatastoreEntryFull;
 class StandardDatastoreEntryName;
+class StandardDatastoreEntryNameList;
+
+// Position of a paged read through the pending table
+// Rows are read in id order up to the last row when the reader was created or extended
+class SqlitePendingEntryReader
+{
+public:
+	SqlitePendingEntryReader() = default;
+	SqlitePendingEntryReader(long long universe_id, long long last_id);
+
+	bool is_done() const { return after_id >= last_id; }
+
+private:
+	friend class SqliteDatastoreWrapper;
+
+	long long universe_id = 0;
+	long long after_id = 0;
+	long long last_id = 0;
+};
+
+// Position of a paged read through downloaded entries, in the order they were written
+class SqliteStoredEntryReader
+{
+public:
+	SqliteStoredEntryReader() = default;
+	SqliteStoredEntryReader(long long after_row_id, long long last_row_id);
+
+	bool is_done() const { return after_row_id >= last_row_id; }
+	// Every entry up to and including this row has been read
+	long long get_row_id() const { return after_row_id; }
+	// Rows passed so far that were left out because they could not be decoded
+	size_t get_unreadable_count() const { return unreadable_count; }
+
+private:
+	friend class SqliteDatastoreWrapper;
+
+	long long after_row_id = 0;
+	long long last_row_id = 0;
+	size_t unreadable_count = 0;
+};
 
 class SqliteDatastoreWrapper
 {
 public:
-	static std::unique_ptr<SqliteDatastoreWrapper> new_from_path(const std::string& file_path);
+	// Values are stored compressed unless the codec is None, readers find the codec in the file's settings
+	static std::unique_ptr<SqliteDatastoreWrapper> new_from_path(const std::string& file_path, SqliteDurability durability = SqliteDurability::Safe, SqliteValueCodec value_codec = SqliteValueCodec::None);
+	// Reapplies the durability the file was created with, since most pragmas only last as long as the connection
 	static std::unique_ptr<SqliteDatastoreWrapper> open_from_path(const std::string& file_path);
 
-	SqliteDatastoreWrapper(sqlite3* db_handle);
+	SqliteDatastoreWrapper(sqlite3* db_handle, SqliteValueCodec value_codec = SqliteValueCodec::None);
 	~SqliteDatastoreWrapper();
 
 	bool is_correct_schema();
+	// Adds tables introduced after the file was created, call once the schema has been checked
+	void upgrade_schema();
 	bool is_resumable(long long universe_id);
+	// Only set for files that journal a delete or undelete instead of holding downloaded entries
+	std::optional<SqliteJournalOperation> get_journal_operation();
+	std::optional<std::string> get_journal_option(const std::string& key);
+
+	// Writes are grouped into one transaction, which is committed at a resume point once it holds enough rows or is old enough
+	void set_group_commit_limits(size_t max_rows, std::chrono::milliseconds max_age);
+	// Statements are compiled for every call while disabled, only used to measure what the cache saves
+	void set_statement_cache_enabled(bool enabled);
+	// Call whenever the database describes a state a download can be resumed from
+	void resume_point();
+	// Commits the current group immediately, the caller must be at a resume point
+	void flush();
+	// Commits and moves everything in the write-ahead log into the database file, does nothing outside WAL mode
+	void checkpoint();
 
 	void write_deleted(const StandardDatastoreEntryName& entry);
 	void write_details(const StandardDatastoreEntryFull& details);
 	void write_enumeration(long long universe_id, const std::string& datastore_name, const std::optional<std::string>& cursor = std::nullopt);
 	void write_enumeration_metadata(long long universe_id, const std::string& scope, const std::string& key_prefix);
+	void write_journal_operation(SqliteJournalOperation operation);
+	void write_journal_option(const std::string& key, const std::string& value);
+	// Replaces any earlier outcome, so an entry that failed and was retried keeps only its latest one
+	void write_outcome(const StandardDatastoreEntryName& entry, const std::string& outcome);
 	void write_pending(const StandardDatastoreEntryName& entry);
+	// Remembers the entry's content for is_in_upload_manifest(), the manifest only lasts as long as the connection
+	void write_upload_manifest(const StandardDatastoreEntryFull& details);
+	// Every entry up to and including this row has been uploaded
+	void write_upload_checkpoint(long long row_id);
 
 	void delete_enumeration(long long universe_id, const std::string& datastore_name);
 	void delete_pending(const StandardDatastoreEntryFull& entry);
 	void delete_pending(const StandardDatastoreEntryName& entry);
+	void delete_upload_checkpoint();
+	// Creates the manifest if needed and empties it
+	void delete_upload_manifest();
 
-	std::optional<std::string> get_enumerating_cursor(long long universe_id);
-	std::optional<std::string> get_enumerating_datastore(long long universe_id);
+	// Every datastore that was partway through enumeration, mapped to the cursor for its next page
+	std::map<std::string, std::string> get_enumerating_cursors(long long universe_id);
+	// Number of entries with each outcome
+	std::map<std::string, size_t> get_outcome_counts(long long universe_id);
 
 	std::optional<std::string> get_enumeration_search_key_prefix(long long universe_id);
 	std::optional<std::string> get_enumeration_search_scope(long long universe_id);
 
 	std::vector<std::string> get_pending_datastores(long long universe_id);
-	std::vector<StandardDatastoreEntryName> get_pending_entries(long long universe_id);
+	size_t get_pending_count(long long universe_id);
+	SqlitePendingEntryReader get_pending_reader(long long universe_id);
+	// Lets the reader also cover rows written since it was created
+	void extend_pending_reader(SqlitePendingEntryReader& reader);
+	// Reads up to page_size entries and moves the reader past them, an empty result means the reader is done
+	StandardDatastoreEntryNameList get_pending_entries(SqlitePendingEntryReader& reader, size_t page_size);
+
+	std::optional<long long> get_upload_checkpoint();
+	SqliteStoredEntryReader get_entry_reader(long long after_row_id);
+	size_t get_entry_count(const SqliteStoredEntryReader& reader);
+	// Reads up to page_size entries and moves the reader past them, an empty result means the reader is done
+	std::vector<StandardDatastoreEntryFull> get_entries(SqliteStoredEntryReader& reader, size_t page_size);
+	// True when the manifest holds the same key with the same content
+	bool is_in_upload_manifest(const StandardDatastoreEntryFull& details);
 
 private:
+	void begin_group();
+	void commit_group();
+
+	// Statements are compiled once per connection, release resets them so they can be reused by the next call
+	sqlite3_stmt* get_cached_statement(const std::string& sql);
+	void release_cached_statement(sqlite3_stmt* stmt);
+
 	sqlite3* db_handle = nullptr;
-};
+	SqliteValueCodec value_codec;
+	std::map<std::string, sqlite3_stmt*> statement_cache;
+	bool statement_cache_enabled = true;
 
-class SqliteDatastoreReader
-{
-public:
-	static std::optional<std::vector<StandardDatastoreEntryFull>> read_all(const std::string& file_path);
+	size_t group_max_rows;
+	std::chrono::milliseconds group_max_age;
+	bool group_open = false;
+	size_t group_rows = 0;
+	std::chrono::steady_clock::time_point group_started;
 };
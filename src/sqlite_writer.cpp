@@ -0,0 +1,147 @@
+#include "sqlite_writer.h"
+
+#include <chrono>
+#include <optional>
+#include <utility>
+
+#include "assert.h"
+#include "sqlite_wrapper.h"
+
+// How long the queue must sit idle before a group that is old enough gets committed
+static constexpr std::chrono::milliseconds IDLE_COMMIT_INTERVAL{ 250 };
+
+SqliteDatastoreWriter::SqliteDatastoreWriter(std::unique_ptr<SqliteDatastoreWrapper> db_wrapper, const size_t capacity) :
+	db_wrapper{ std::move(db_wrapper) },
+	capacity{ capacity }
+{
+	OCTASSERT(this->db_wrapper);
+	OCTASSERT(capacity > 0);
+	writer_thread = std::thread{ &SqliteDatastoreWriter::run, this };
+}
+
+SqliteDatastoreWriter::~SqliteDatastoreWriter()
+{
+	// Anything already queued is still written so the file stays resumable
+	close();
+	if (writer_thread.joinable())
+	{
+		writer_thread.join();
+	}
+}
+
+void SqliteDatastoreWriter::push(Command command)
+{
+	push_command(std::move(command), CommandType::Write);
+}
+
+void SqliteDatastoreWriter::push_resume_point(Command command)
+{
+	push_command(std::move(command), CommandType::ResumePoint);
+}
+
+void SqliteDatastoreWriter::push_read(Command command)
+{
+	push_command(std::move(command), CommandType::Read);
+}
+
+void SqliteDatastoreWriter::flush()
+{
+	push_command([this](SqliteDatastoreWrapper& db) {
+		db.flush();
+		emit flushed();
+	}, CommandType::ResumePoint);
+}
+
+void SqliteDatastoreWriter::close()
+{
+	{
+		const std::lock_guard<std::mutex> lock{ queue_mutex };
+		stop_requested = true;
+	}
+	queue_condition.notify_one();
+}
+
+bool SqliteDatastoreWriter::is_full() const
+{
+	const std::lock_guard<std::mutex> lock{ queue_mutex };
+	return queue.size() >= capacity;
+}
+
+size_t SqliteDatastoreWriter::get_queued_count() const
+{
+	const std::lock_guard<std::mutex> lock{ queue_mutex };
+	return queue.size();
+}
+
+void SqliteDatastoreWriter::push_command(Command command, const CommandType type)
+{
+	{
+		const std::lock_guard<std::mutex> lock{ queue_mutex };
+		OCTASSERT(stop_requested == false);
+		if (stop_requested)
+		{
+			return;
+		}
+		queue.push_back(QueuedCommand{ std::move(command), type });
+		if (queue.size() >= capacity)
+		{
+			was_full = true;
+		}
+	}
+	queue_condition.notify_one();
+}
+
+void SqliteDatastoreWriter::run()
+{
+	// Nothing has been written by this thread yet, so the database starts at a resume point
+	bool at_resume_point = true;
+	while (true)
+	{
+		std::optional<QueuedCommand> next_command;
+		bool became_available = false;
+		{
+			std::unique_lock<std::mutex> lock{ queue_mutex };
+			if (queue.size() == 0 && stop_requested == false)
+			{
+				queue_condition.wait_for(lock, IDLE_COMMIT_INTERVAL);
+			}
+
+			if (queue.size() > 0)
+			{
+				next_command = std::move(queue.front());
+				queue.pop_front();
+				// Wait for half the queue to drain so producers resume in bursts rather than one command at a time
+				if (was_full && queue.size() <= capacity / 2)
+				{
+					was_full = false;
+					became_available = true;
+				}
+			}
+			else if (stop_requested)
+			{
+				break;
+			}
+		}
+
+		if (next_command)
+		{
+			next_command->command(*db_wrapper);
+			if (next_command->type != CommandType::Read)
+			{
+				at_resume_point = next_command->type == CommandType::ResumePoint;
+			}
+		}
+		if (at_resume_point)
+		{
+			db_wrapper->resume_point();
+		}
+		if (became_available)
+		{
+			emit queue_available();
+		}
+	}
+
+	db_wrapper->checkpoint();
+	db_wrapper.reset();
+	emit closed();
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <QObject>
+
+class SqliteDatastoreWrapper;
+
+// Owns a database connection and runs every write on a dedicated thread so disk stalls do not block the GUI
+class SqliteDatastoreWriter : public QObject
+{
+	Q_OBJECT
+public:
+	using Command = std::function<void(SqliteDatastoreWrapper&)>;
+
+	SqliteDatastoreWriter(std::unique_ptr<SqliteDatastoreWrapper> db_wrapper, size_t capacity);
+	virtual ~SqliteDatastoreWriter() override;
+
+	// Commands run in the order they are pushed
+	// Pushing never blocks, callers should stop producing work while is_full() returns true and continue on queue_available()
+	void push(Command command);
+	// The command must leave the database at a point a download can be resumed from, the group is committed when it is old enough
+	void push_resume_point(Command command);
+	// The command must only read, whether the database is at a resume point is left as it was
+	void push_read(Command command);
+
+	// Commits everything pushed so far, emits flushed() once it is on disk
+	void flush();
+	// Commits, checkpoints and closes the database, emits closed() once the file is complete
+	void close();
+
+	bool is_full() const;
+	size_t get_queued_count() const;
+
+signals:
+	void flushed();
+	void closed();
+	void queue_available();
+
+private:
+	enum class CommandType : std::uint8_t
+	{
+		Write,
+		ResumePoint,
+		Read,
+	};
+
+	class QueuedCommand
+	{
+	public:
+		Command command;
+		CommandType type = CommandType::Write;
+	};
+
+	void push_command(Command command, CommandType type);
+	void run();
+
+	std::unique_ptr<SqliteDatastoreWrapper> db_wrapper;
+	size_t capacity;
+
+	mutable std::mutex queue_mutex;
+	std::condition_variable queue_condition;
+	std::deque<QueuedCommand> queue;
+	bool was_full = false;
+	bool stop_requested = false;
+
+	std::thread writer_thread;
+};
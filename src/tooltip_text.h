@@ -20,6 +20,7 @@ namespace ToolTip
 		"This data can later be uploaded through the 'Bulk upload...' button."
 	};
 	static const QString BulkDataPanel_Delete{ "Delete all of the entries in one or more datastores." };
+	static const QString BulkDataPanel_Resume{ "Resume a bulk delete or undelete that was saving its progress to a file." };
 	static const QString BulkDataPanel_ResumeDownload{ "Resume a previous bulk download from an existing sqlite database." };
 	static const QString BulkDataPanel_Snapshot{ "Make a snapshot of the current state of all datastores in this universe. After modifying an entry, you will be able to restore it to the state from this snapshot for 30 days." };
 	static const QString BulkDataPanel_Undelete{ "Scan one or more datastores for deleted entries and restore their previous version." };
@@ -0,0 +1,46 @@
+#include "upload_checkpoint.h"
+
+void UploadCheckpointTracker::add_page(const long long last_row_id, const size_t entry_count)
+{
+	if (held == false)
+	{
+		Page this_page;
+		this_page.last_row_id = last_row_id;
+		this_page.remaining = entry_count;
+		pages.push_back(this_page);
+	}
+}
+
+void UploadCheckpointTracker::finish_entry(const long long page_row_id, const bool succeeded)
+{
+	for (Page& this_page : pages)
+	{
+		if (this_page.last_row_id == page_row_id && this_page.remaining > 0)
+		{
+			this_page.remaining--;
+			if (succeeded == false)
+			{
+				this_page.failed = true;
+			}
+			return;
+		}
+	}
+}
+
+std::optional<long long> UploadCheckpointTracker::advance()
+{
+	std::optional<long long> result;
+	while (pages.size() > 0 && pages.front().remaining == 0)
+	{
+		if (pages.front().failed)
+		{
+			// Later pages can never move the checkpoint again, there is no need to keep following them
+			held = true;
+			pages.clear();
+			break;
+		}
+		result = pages.front().last_row_id;
+		pages.pop_front();
+	}
+	return result;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+
+#include <deque>
+#include <optional>
+
+// Follows which pages of an upload are done, so the stored checkpoint only ever covers rows that were uploaded
+// Pages are added in row order and finish out of order, the checkpoint moves past a page once it and every page before it succeeded
+// A page with a failed entry holds the checkpoint before it for the rest of the upload, so a resumed upload tries the page again
+class UploadCheckpointTracker
+{
+public:
+	void add_page(long long last_row_id, size_t entry_count);
+	void finish_entry(long long page_row_id, bool succeeded);
+
+	// Returns the row id the checkpoint can move to, or nullopt if it did not move since the last call
+	std::optional<long long> advance();
+
+	bool is_held() const { return held; }
+
+private:
+	class Page
+	{
+	public:
+		long long last_row_id = 0;
+		size_t remaining = 0;
+		bool failed = false;
+	};
+
+	std::deque<Page> pages;
+	bool held = false;
+};
@@ -2,6 +2,52 @@
 
 #include <QString>
 
+QString get_enum_string(const HttpCircuitState enum_in)
+{
+	switch (enum_in)
+	{
+	case HttpCircuitState::Closed:
+		return "Closed";
+	case HttpCircuitState::Open:
+		return "Open";
+	case HttpCircuitState::HalfOpen:
+		return "Half-open";
+	}
+	return "Big Error";
+}
+
+QString get_enum_string(const HttpEndpointFamily enum_in)
+{
+	switch (enum_in)
+	{
+	case HttpEndpointFamily::Other:
+		return "Other";
+	case HttpEndpointFamily::MemoryStoreSortedMap:
+		return "Memory Store Sorted Map";
+	case HttpEndpointFamily::MessagingService:
+		return "Messaging Service";
+	case HttpEndpointFamily::OrderedDatastore:
+		return "Ordered Datastore";
+	case HttpEndpointFamily::StandardDatastoreList:
+		return "Standard Datastore List";
+	case HttpEndpointFamily::StandardDatastoreEntryList:
+		return "Standard Datastore Entry List";
+	case HttpEndpointFamily::StandardDatastoreEntryRead:
+		return "Standard Datastore Entry Read";
+	case HttpEndpointFamily::StandardDatastoreEntryWrite:
+		return "Standard Datastore Entry Write";
+	case HttpEndpointFamily::StandardDatastoreVersionList:
+		return "Standard Datastore Version List";
+	case HttpEndpointFamily::StandardDatastoreSnapshot:
+		return "Standard Datastore Snapshot";
+	case HttpEndpointFamily::Universe:
+		return "Universe";
+	case HttpEndpointFamily::UserRestriction:
+		return "User Restriction";
+	}
+	return "Big Error";
+}
+
 QString get_enum_string(const HttpRequestType enum_in)
 {
 	switch (enum_in)
@@ -18,6 +64,32 @@ QString get_enum_string(const HttpRequestType enum_in)
 	return "Big Error";
 }
 
+QString get_enum_string(const SqliteDurability enum_in)
+{
+	switch (enum_in)
+	{
+	case SqliteDurability::Safe:
+		return "Safe";
+	case SqliteDurability::Fast:
+		return "Fast";
+	case SqliteDurability::Bulk:
+		return "Bulk";
+	}
+	return "Big Error";
+}
+
+QString get_enum_string(const SqliteValueCodec enum_in)
+{
+	switch (enum_in)
+	{
+	case SqliteValueCodec::None:
+		return "None";
+	case SqliteValueCodec::QCompress:
+		return "qCompress";
+	}
+	return "Big Error";
+}
+
 QString get_enum_string(const DatastoreEntryType enum_in)
 {
 	switch (enum_in)
@@ -13,6 +13,29 @@ enum class DatastoreEntryType : std::uint8_t
 	Json,
 };
 
+enum class HttpCircuitState : std::uint8_t
+{
+	Closed,
+	Open,
+	HalfOpen,
+};
+
+enum class HttpEndpointFamily : std::uint8_t
+{
+	Other,
+	MemoryStoreSortedMap,
+	MessagingService,
+	OrderedDatastore,
+	StandardDatastoreList,
+	StandardDatastoreEntryList,
+	StandardDatastoreEntryRead,
+	StandardDatastoreEntryWrite,
+	StandardDatastoreVersionList,
+	StandardDatastoreSnapshot,
+	Universe,
+	UserRestriction,
+};
+
 enum class HttpRequestType : std::uint8_t
 {
 	Get,
@@ -21,6 +44,13 @@ enum class HttpRequestType : std::uint8_t
 	Delete,
 };
 
+enum class HttpResponseSource : std::uint8_t
+{
+	Network,
+	Shared,
+	Cache,
+};
+
 enum class JsonDataType : std::uint8_t
 {
 	Bool,
@@ -30,6 +60,26 @@ enum class JsonDataType : std::uint8_t
 	Object,
 };
 
+enum class SqliteDurability : std::uint8_t
+{
+	Safe,
+	Fast,
+	Bulk,
+};
+
+enum class SqliteJournalOperation : std::uint8_t
+{
+	Delete,
+	Undelete,
+};
+
+enum class SqliteValueCodec : std::uint8_t
+{
+	None,
+	// Qt's qCompress() format, a zlib stream after the uncompressed size as a 4-byte big-endian length
+	QCompress,
+};
+
 enum class ViewEditMode : std::uint8_t
 {
 	View,
@@ -37,4 +87,8 @@ enum class ViewEditMode : std::uint8_t
 };
 
 QString get_enum_string(DatastoreEntryType enum_in);
+QString get_enum_string(HttpCircuitState enum_in);
+QString get_enum_string(HttpEndpointFamily enum_in);
 QString get_enum_string(HttpRequestType enum_in);
+QString get_enum_string(SqliteDurability enum_in);
+QString get_enum_string(SqliteValueCodec enum_in);
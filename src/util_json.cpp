@@ -124,13 +124,22 @@ std::optional<QString> condense_json(const QString& json_string)
 
 std::optional<QString> decode_json_string(const QString& json_string)
 {
-	if (json_string.size() < 2 || json_string[0] != '"' || json_string[json_string.size() - 1] != '"')
+	return decode_json_string(json_string.toUtf8());
+}
+
+std::optional<QString> decode_json_string(const QByteArray& json_bytes)
+{
+	if (json_bytes.size() < 2 || json_bytes.front() != '"' || json_bytes.back() != '"')
 	{
 		return std::nullopt;
 	}
 
-	QString possibly_json = QString{ "{\"the_string\":%1}" }.arg(json_string);
-	QJsonDocument doc = QJsonDocument::fromJson(possibly_json.toUtf8());
+	QByteArray possibly_json;
+	possibly_json.reserve(json_bytes.size() + 16);
+	possibly_json.append("{\"the_string\":");
+	possibly_json.append(json_bytes);
+	possibly_json.append('}');
+	QJsonDocument doc = QJsonDocument::fromJson(possibly_json);
 	if (doc.isObject() == false)
 	{
 		return std::nullopt;
@@ -2,6 +2,7 @@
 
 #include <optional>
 
+#include <QByteArray>
 #include <QString>
 
 #include "util_enum.h"
@@ -31,4 +32,5 @@ private:
 
 std::optional<QString> condense_json(const QString& json_string);
 std::optional<QString> decode_json_string(const QString& json_string);
+std::optional<QString> decode_json_string(const QByteArray& json_bytes);
 QString encode_json_string(const QString& string);
@@ -1,5 +1,6 @@
 #include "util_validator.h"
 
+#include <QByteArray>
 #include <QJsonDocument>
 #include <QString>
 
@@ -17,7 +18,12 @@ bool DataValidator::is_number(const QString& string)
 
 bool DataValidator::is_json(const QString& string)
 {
-	QJsonDocument doc = QJsonDocument::fromJson(string.toUtf8());
+	return is_json(string.toUtf8());
+}
+
+bool DataValidator::is_json(const QByteArray& bytes)
+{
+	QJsonDocument doc = QJsonDocument::fromJson(bytes);
 	return doc.isObject() || doc.isArray();
 }
 
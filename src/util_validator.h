@@ -1,5 +1,6 @@
 #pragma once
 
+class QByteArray;
 class QString;
 
 class DataValidator
@@ -8,5 +9,6 @@ public:
 	static bool is_bool(const QString& string);
 	static bool is_number(const QString& string);
 	static bool is_json(const QString& string);
+	static bool is_json(const QByteArray& bytes);
 	static bool is_json_array(const QString& string);
 };
@@ -9,6 +9,7 @@
 #include <Qt>
 #include <QtGlobal>
 #include <QCheckBox>
+#include <QComboBox>
 #include <QDateTime>
 #include <QFile>
 #include <QFileDialog>
@@ -24,6 +25,7 @@
 #include <QMargins>
 #include <QMessageBox>
 #include <QPushButton>
+#include <QVariant>
 #include <QVBoxLayout>
 
 #include "assert.h"
@@ -32,6 +34,7 @@
 #include "roblox_time.h"
 #include "sqlite_wrapper.h"
 #include "util_alert.h"
+#include "util_enum.h"
 #include "window_datastore_bulk_op_progress.h"
 
 DatastoreBulkOperationWindow::DatastoreBulkOperationWindow(QWidget* parent, const QString& api_key, const std::shared_ptr<UniverseProfile>& universe, const std::vector<QString>& datastore_names) :
@@ -156,6 +159,57 @@ std::vector<QString> DatastoreBulkOperationWindow::get_selected_datastores() con
 	return result;
 }
 
+QString DatastoreBulkOperationWindow::choose_new_database_path(const QString& default_file_name)
+{
+	QString file_name = QFileDialog::getSaveFileName(this, "Save as...", default_file_name, "sqlite3 databases (*.sqlite3)");
+	if (file_name.trimmed().length() == 0)
+	{
+		return "";
+	}
+
+	QFile existing_file{ file_name };
+	if (existing_file.exists())
+	{
+		const QMessageBox::StandardButton response =
+			QMessageBox::warning(nullptr, "File already exists", "The existing sqlite database will be deleted, proceed?", QMessageBox::StandardButton::Yes | QMessageBox::StandardButton::No);
+
+		if (response != QMessageBox::StandardButton::Yes)
+		{
+			return "";
+		}
+
+		if (existing_file.remove() == false)
+		{
+			QMessageBox* msg_box = new QMessageBox{ this };
+			msg_box->setWindowTitle("Error");
+			msg_box->setText("Failed to delete existing file.");
+			msg_box->exec();
+			return "";
+		}
+	}
+
+	return file_name;
+}
+
+std::unique_ptr<SqliteDatastoreWrapper> DatastoreBulkOperationWindow::create_journal(const QString& default_file_name)
+{
+	const QString file_name = choose_new_database_path(default_file_name);
+	if (file_name.size() == 0)
+	{
+		return nullptr;
+	}
+
+	std::unique_ptr<SqliteDatastoreWrapper> journal = SqliteDatastoreWrapper::new_from_path(file_name.toStdString());
+	if (!journal)
+	{
+		QMessageBox* msg_box = new QMessageBox{ this };
+		msg_box->setWindowTitle("Error");
+		msg_box->setText("Failed to open file for writing.");
+		msg_box->exec();
+	}
+	return journal;
+}
+
 void DatastoreBulkOperationWindow::handle_show_hidden_toggled()
 {
 	const std::shared_ptr<const UniverseProfile> universe = attached_universe.lock();
@@ -222,10 +276,14 @@ DatastoreBulkDeleteWindow::DatastoreBulkDeleteWindow(QWidget* parent, const QStr
 
 		hide_after_delete_check = new QCheckBox{ "Hide datastore after deletion", options_box };
 
+		journal_check = new QCheckBox{ "Save progress to a file", options_box };
+		journal_check->setToolTip("Keeps track of enumerated and deleted entries in a file, so an interrupted delete can be resumed from the bulk data panel");
+
 		QVBoxLayout* options_layout = new QVBoxLayout{ options_box };
 		options_layout->addWidget(confirm_count_before_delete_check);
 		options_layout->addWidget(rewrite_before_delete_check);
 		options_layout->addWidget(hide_after_delete_check);
+		options_layout->addWidget(journal_check);
 	}
 
 	right_bar_layout->addWidget(options_box);
@@ -256,6 +314,15 @@ void DatastoreBulkDeleteWindow::pressed_submit()
 			const bool confirm_count_before_delete = confirm_count_before_delete_check->isChecked();
 			const bool rewrite_before_delete = rewrite_before_delete_check->isChecked();
 			const bool hide_datastores_after = hide_after_delete_check->isChecked();
+			std::unique_ptr<SqliteDatastoreWrapper> journal;
+			if (journal_check->isChecked())
+			{
+				journal = create_journal("delete.sqlite3");
+				if (!journal)
+				{
+					return;
+				}
+			}
 			DatastoreBulkDeleteProgressWindow* progress_window = new DatastoreBulkDeleteProgressWindow{
 				dynamic_cast<QWidget*>(parent()),
 				api_key,
@@ -265,7 +332,8 @@ void DatastoreBulkDeleteWindow::pressed_submit()
 				selected_datastores,
 				confirm_count_before_delete,
 				rewrite_before_delete,
-				hide_datastores_after
+				hide_datastores_after,
+				std::move(journal)
 			};
 			close();
 			progress_window->show();
@@ -287,6 +355,35 @@ DatastoreBulkDownloadWindow::DatastoreBulkDownloadWindow(QWidget* parent, const
 	setWindowTitle("Download Datastores");
 
 	submit_button->setText("Save as...");
+
+	QGroupBox* options_box = new QGroupBox{ "Download Options", right_bar };
+	{
+		QLabel* durability_label = new QLabel{ "Database durability", options_box };
+
+		durability_combo = new QComboBox{ options_box };
+		durability_combo->addItem(get_enum_string(SqliteDurability::Safe), static_cast<int>(SqliteDurability::Safe));
+		durability_combo->setItemData(0, "Default sqlite settings, the file is fully synced after every commit", Qt::ToolTipRole);
+		durability_combo->addItem(get_enum_string(SqliteDurability::Fast), static_cast<int>(SqliteDurability::Fast));
+		durability_combo->setItemData(1, "Write-ahead log with fewer syncs and a larger cache, a power loss may lose the last few commits", Qt::ToolTipRole);
+		durability_combo->addItem(get_enum_string(SqliteDurability::Bulk), static_cast<int>(SqliteDurability::Bulk));
+		durability_combo->setItemData(2, "Same as Fast, also memory-maps the file and only folds the log into it at the end", Qt::ToolTipRole);
+
+		QLabel* value_codec_label = new QLabel{ "Value compression", options_box };
+
+		value_codec_combo = new QComboBox{ options_box };
+		value_codec_combo->addItem(get_enum_string(SqliteValueCodec::None), static_cast<int>(SqliteValueCodec::None));
+		value_codec_combo->setItemData(0, "Values are stored as plain text and can be read by any sqlite tool", Qt::ToolTipRole);
+		value_codec_combo->addItem(get_enum_string(SqliteValueCodec::QCompress), static_cast<int>(SqliteValueCodec::QCompress));
+		value_codec_combo->setItemData(1, "Values are stored as zlib blobs with Qt's 4-byte length prefix, much smaller for repetitive JSON but other tools have to strip the prefix", Qt::ToolTipRole);
+
+		QVBoxLayout* options_layout = new QVBoxLayout{ options_box };
+		options_layout->addWidget(durability_label);
+		options_layout->addWidget(durability_combo);
+		options_layout->addWidget(value_codec_label);
+		options_layout->addWidget(value_codec_combo);
+	}
+
+	right_bar_layout->addWidget(options_box);
 	right_bar_layout->addStretch();
 }
 
@@ -303,33 +400,12 @@ void DatastoreBulkDownloadWindow::pressed_submit()
 	const std::vector<QString> selected_datastores = get_selected_datastores();
 	if (selected_datastores.size() > 0)
 	{
-		QString file_name = QFileDialog::getSaveFileName(this, "Save as...", "datastore.sqlite3", "sqlite3 databases (*.sqlite3)");
-		if (file_name.trimmed().length() > 0)
+		const QString file_name = choose_new_database_path("datastore.sqlite3");
+		if (file_name.length() > 0)
 		{
-			{
-				QFile existing_file{ file_name };
-				if (existing_file.exists())
-				{
-					const QMessageBox::StandardButton response =
-						QMessageBox::warning(nullptr, "File already exists", "The existing sqlite database will be deleted prior to download, proceed?", QMessageBox::StandardButton::Yes | QMessageBox::StandardButton::No);
-
-					if (response != QMessageBox::StandardButton::Yes)
-					{
-						return;
-					}
-
-					if (existing_file.remove() == false)
-					{
-						QMessageBox* msg_box = new QMessageBox{ this };
-						msg_box->setWindowTitle("Error");
-						msg_box->setText("Failed to delete existing file.");
-						msg_box->exec();
-						return;
-					}
-				}
-			}
-
-			std::unique_ptr<SqliteDatastoreWrapper> writer = SqliteDatastoreWrapper::new_from_path(file_name.toStdString());
+			const SqliteDurability durability = static_cast<SqliteDurability>(durability_combo->currentData().toInt());
+			const SqliteValueCodec value_codec = static_cast<SqliteValueCodec>(value_codec_combo->currentData().toInt());
+			std::unique_ptr<SqliteDatastoreWrapper> writer = SqliteDatastoreWrapper::new_from_path(file_name.toStdString(), durability, value_codec);
 			if (writer)
 			{
 				const QString scope = filter_enabled_check->isChecked() ? filter_scope_edit->text().trimmed() : "";
@@ -420,9 +496,13 @@ DatastoreBulkUndeleteWindow::DatastoreBulkUndeleteWindow(QWidget* parent, const
 			time_filter_layout->addWidget(min_label);
 		}
 
+		journal_check = new QCheckBox{ "Save progress to a file", options_box };
+		journal_check->setToolTip("Keeps track of enumerated and restored entries in a file, so an interrupted undelete can be resumed from the bulk data panel");
+
 		QVBoxLayout* options_layout = new QVBoxLayout{ options_box };
 		options_layout->addWidget(time_filter_check);
 		options_layout->addWidget(time_filter_bar);
+		options_layout->addWidget(journal_check);
 	}
 
 	right_bar_layout->addWidget(options_box);
@@ -451,6 +531,15 @@ void DatastoreBulkUndeleteWindow::pressed_submit()
 		{
 			const QString scope = filter_enabled_check->isChecked() ? filter_scope_edit->text().trimmed() : "";
 			const QString key_prefix = filter_enabled_check->isChecked() ? filter_key_prefix_edit->text().trimmed() : "";
+			std::unique_ptr<SqliteDatastoreWrapper> journal;
+			if (journal_check->isChecked())
+			{
+				journal = create_journal("undelete.sqlite3");
+				if (!journal)
+				{
+					return;
+				}
+			}
 			DatastoreBulkUndeleteProgressWindow* progress_window = nullptr;
 			if (time_filter_check->isChecked())
 			{
@@ -460,11 +549,11 @@ void DatastoreBulkUndeleteWindow::pressed_submit()
 					alert_error_blocking("Failed to Get Time", "Unable to determine Roblox Server time, aborting.");
 					close();
 				}
-				progress_window = new DatastoreBulkUndeleteProgressWindow{ dynamic_cast<QWidget*>(parent()), api_key, universe->get_universe_id(), scope, key_prefix, selected_datastores, get_undelete_after_time() };
+				progress_window = new DatastoreBulkUndeleteProgressWindow{ dynamic_cast<QWidget*>(parent()), api_key, universe->get_universe_id(), scope, key_prefix, selected_datastores, get_undelete_after_time(), std::move(journal) };
 			}
 			else
 			{
-				progress_window = new DatastoreBulkUndeleteProgressWindow{ dynamic_cast<QWidget*>(parent()), api_key, universe->get_universe_id(), scope, key_prefix, selected_datastores, std::nullopt };
+				progress_window = new DatastoreBulkUndeleteProgressWindow{ dynamic_cast<QWidget*>(parent()), api_key, universe->get_universe_id(), scope, key_prefix, selected_datastores, std::nullopt, std::move(journal) };
 			}
 			close();
 			progress_window->show();
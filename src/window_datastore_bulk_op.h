@@ -9,12 +9,14 @@
 #include <QWidget>
 
 class QCheckBox;
+class QComboBox;
 class QDateTime;
 class QLineEdit;
 class QListWidget;
 class QPushButton;
 class QVBoxLayout;
 
+class SqliteDatastoreWrapper;
 class UniverseProfile;
 
 class DatastoreBulkOperationWindow : public QWidget
@@ -26,6 +28,10 @@ protected:
 	virtual void pressed_submit() = 0;
 
 	std::vector<QString> get_selected_datastores() const;
+	// Asks where to save a new database, replacing any existing file, returns an empty string if the user gave up
+	QString choose_new_database_path(const QString& default_file_name);
+	// Returns null if the user gave up or the file could not be created
+	std::unique_ptr<SqliteDatastoreWrapper> create_journal(const QString& default_file_name);
 
 	void handle_show_hidden_toggled();
 
@@ -62,6 +68,7 @@ private:
 	QCheckBox* confirm_count_before_delete_check = nullptr;
 	QCheckBox* rewrite_before_delete_check = nullptr;
 	QCheckBox* hide_after_delete_check = nullptr;
+	QCheckBox* journal_check = nullptr;
 };
 
 class DatastoreBulkDownloadWindow : public DatastoreBulkOperationWindow
@@ -72,6 +79,9 @@ public:
 
 private:
 	virtual void pressed_submit() override;
+
+	QComboBox* durability_combo = nullptr;
+	QComboBox* value_codec_combo = nullptr;
 };
 
 class DatastoreBulkUndeleteWindow : public DatastoreBulkOperationWindow
@@ -88,6 +98,7 @@ private:
 	std::optional<QDateTime> get_undelete_after_time() const;
 
 	QCheckBox* time_filter_check = nullptr;
+	QCheckBox* journal_check = nullptr;
 	QLineEdit* day_edit = nullptr;
 	QLineEdit* hour_edit = nullptr;
 	QLineEdit* min_edit = nullptr;
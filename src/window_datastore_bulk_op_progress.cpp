@@ -1,14 +1,21 @@
 #include "window_datastore_bulk_op_progress.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cstdlib>
+#include <iterator>
+#include <map>
+#include <string>
 #include <utility>
 
 #include <Qt>
 #include <QLabel>
 #include <QMessageBox>
+#include <QMetaObject>
 #include <QProgressBar>
 #include <QPushButton>
+#include <QStringList>
+#include <QTimer>
 #include <QVBoxLayout>
 
 #include "assert.h"
@@ -17,9 +24,86 @@
 #include "roblox_time.h"
 #include "widget_text_log.h"
 
+// Datastores listed at the same time, also limited by the bulk operation concurrency preference
+static constexpr size_t MAX_CONCURRENT_ENUMERATIONS = 8;
+
+// Roughly how many responses may be waiting for the disk before no more entries are requested
+static constexpr size_t WRITER_QUEUE_CAPACITY = 4096;
+
+// Entries read from the pending table at once when resuming
+static constexpr size_t PENDING_PAGE_SIZE = 2048;
+// Entries read from a dump at once when uploading, smaller since each one holds its full value
+static constexpr size_t UPLOAD_PAGE_SIZE = 512;
+// The next page is requested once fewer entries than this are left, so it arrives before the slots run dry
+static constexpr size_t PENDING_REFILL_THRESHOLD = 512;
+// A rewritten delete gets, posts and then deletes each key
+static constexpr size_t REWRITE_STAGE_COUNT = 3;
+// An undelete lists the versions of each key, then fetches and posts the one to restore
+static constexpr size_t UNDELETE_STAGE_COUNT = 3;
+
+// Outcomes journaled for each entry of a delete or undelete
+static constexpr const char* OUTCOME_ALREADY_DELETED = "already_deleted";
+static constexpr const char* OUTCOME_DELETED = "deleted";
+static constexpr const char* OUTCOME_FAILED = "failed";
+static constexpr const char* OUTCOME_NO_OLD_VERSION = "no_old_version";
+static constexpr const char* OUTCOME_NOT_DELETED = "not_deleted";
+static constexpr const char* OUTCOME_NOT_IN_TIME_RANGE = "not_in_time_range";
+static constexpr const char* OUTCOME_RESTORED = "restored";
+
+// Options a journaled delete or undelete is resumed with
+static constexpr const char* JOURNAL_OPTION_CONFIRM_COUNT = "confirm_count";
+static constexpr const char* JOURNAL_OPTION_HIDE_DATASTORES = "hide_datastores";
+static constexpr const char* JOURNAL_OPTION_REWRITE = "rewrite";
+static constexpr const char* JOURNAL_OPTION_UNDELETE_AFTER = "undelete_after";
+
+static std::string join_datastore_names(const std::vector<QString>& datastore_names)
+{
+	// Datastore names cannot contain line breaks
+	QString result;
+	for (const QString& this_name : datastore_names)
+	{
+		if (result.size() > 0)
+		{
+			result.append('\n');
+		}
+		result.append(this_name);
+	}
+	return result.toStdString();
+}
+
+static std::vector<QString> split_datastore_names(const std::string& joined_names)
+{
+	std::vector<QString> result;
+	for (const QString& this_name : QString::fromStdString(joined_names).split('\n'))
+	{
+		if (this_name.size() > 0)
+		{
+			result.push_back(this_name);
+		}
+	}
+	return result;
+}
+
 void DatastoreBulkOperationProgressWindow::start()
 {
-	send_next_enumerate_keys_request();
+	for (const QString& this_datastore_name : datastore_names)
+	{
+		EnumerationCursor this_enumeration;
+		this_enumeration.datastore_name = this_datastore_name;
+		const auto cursor_it = initial_cursors.find(this_datastore_name);
+		if (cursor_it != initial_cursors.end())
+		{
+			this_enumeration.cursor = cursor_it->second;
+		}
+		pending_enumerations.push_back(this_enumeration);
+	}
+
+	send_enumerate_keys_requests();
+	if (pipelined && progress.is_enumerating())
+	{
+		// Entries left over from a resumed operation can start right away
+		fill_entry_slots();
+	}
 }
 
 DatastoreBulkOperationProgressWindow::DatastoreBulkOperationProgressWindow(
@@ -36,7 +120,8 @@ DatastoreBulkOperationProgressWindow::DatastoreBulkOperationProgressWindow(
 	find_scope{ find_scope },
 	find_key_prefix{ find_key_prefix },
 	progress{ datastore_names.size() },
-	datastore_names{ datastore_names }
+	datastore_names{ datastore_names },
+	concurrency{ std::min<size_t>(2, UserProfile::get().get_bulk_operation_concurrency()), UserProfile::get().get_bulk_operation_concurrency() }
 {
 	setAttribute(Qt::WA_DeleteOnClose);
 	setMinimumHeight(380);
@@ -54,6 +139,13 @@ DatastoreBulkOperationProgressWindow::DatastoreBulkOperationProgressWindow(
 	progress_bar->setTextVisible(false);
 	progress_bar->setMaximum(DownloadProgress::MAXIMUM);
 
+	concurrency_label = new QLabel{ "", this };
+
+	// Rates are measured over a trailing interval so they need to be redrawn even when no replies arrive
+	concurrency_ui_timer = new QTimer{ this };
+	connect(concurrency_ui_timer, &QTimer::timeout, this, &DatastoreBulkOperationProgressWindow::update_concurrency_ui);
+	concurrency_ui_timer->start(1000);
+
 	text_log = new TextLogWidget{ this };
 
 	retry_button = new QPushButton{ "Retry", this };
@@ -66,28 +158,66 @@ DatastoreBulkOperationProgressWindow::DatastoreBulkOperationProgressWindow(
 	QVBoxLayout* const layout = new QVBoxLayout{ this };
 	layout->addWidget(progress_label);
 	layout->addWidget(progress_bar);
+	layout->addWidget(concurrency_label);
 	layout->addWidget(text_log);
 	layout->addWidget(retry_button);
 	layout->addWidget(close_button);
 
 	progress_label->setText("Initializing...");
+	update_concurrency_ui();
+}
+
+bool DatastoreBulkOperationProgressWindow::confirm_entry_requests()
+{
+	return true;
+}
+
+size_t DatastoreBulkOperationProgressWindow::get_entry_slot_count() const
+{
+	return concurrency.get_window();
+}
+
+bool DatastoreBulkOperationProgressWindow::can_send_entry_request() const
+{
+	return true;
 }
 
 bool DatastoreBulkOperationProgressWindow::is_retryable() const
 {
-	return enumerate_entries_request && enumerate_entries_request->req_status() == DataRequestStatus::Error;
+	for (const ActiveEnumeration& this_enumeration : enumerate_requests)
+	{
+		if (this_enumeration.request->req_status() == DataRequestStatus::Error)
+		{
+			return true;
+		}
+	}
+	for (const std::shared_ptr<DataRequest>& this_request : entry_requests)
+	{
+		if (this_request->req_status() == DataRequestStatus::Error)
+		{
+			return true;
+		}
+	}
+	return false;
 }
 
-bool DatastoreBulkOperationProgressWindow::do_retry()
+void DatastoreBulkOperationProgressWindow::do_retry()
 {
-	if (DatastoreBulkOperationProgressWindow::is_retryable())
+	for (const ActiveEnumeration& this_enumeration : enumerate_requests)
 	{
-		enumerate_entries_request->force_retry();
-		return true;
+		if (this_enumeration.request->req_status() == DataRequestStatus::Error)
+		{
+			this_enumeration.request->force_retry();
+		}
 	}
-	else
+	// Each slot retries independently, iterate over a copy since a retried request may be released immediately
+	const std::vector<std::shared_ptr<DataRequest>> requests_to_check = entry_requests;
+	for (const std::shared_ptr<DataRequest>& this_request : requests_to_check)
 	{
-		return false;
+		if (this_request->req_status() == DataRequestStatus::Error)
+		{
+			this_request->force_retry();
+		}
 	}
 }
 
@@ -100,8 +230,21 @@ void DatastoreBulkOperationProgressWindow::update_ui()
 	}
 	else if (progress.is_enumerating())
 	{
-		const size_t total_found = enumerate_entries_request ? enumerate_entries_request->get_datastore_entries().size() + pending_entries.size() : pending_entries.size();
-		progress_label->setText(QString{ "Enumerating entries, found %1..." }.arg(total_found));
+		if (pipelined)
+		{
+			const size_t entry_done = progress.get_current_entry_index();
+			const size_t total_found = entry_done + entries_in_flight + pending_entries.size() + get_unloaded_entry_count();
+			progress_label->setText(QString{ "Enumerating entries, found %1, %2 done..." }.arg(total_found).arg(entry_done));
+		}
+		else
+		{
+			size_t total_found = pending_entries.size() + get_unloaded_entry_count();
+			for (const ActiveEnumeration& this_enumeration : enumerate_requests)
+			{
+				total_found += this_enumeration.request->get_datastore_entries().size();
+			}
+			progress_label->setText(QString{ "Enumerating entries, found %1..." }.arg(total_found));
+		}
 		progress_bar->setMaximum(0);
 		progress_bar->setValue(0);
 	}
@@ -119,38 +262,166 @@ void DatastoreBulkOperationProgressWindow::update_ui()
 			progress_label->setText("Error");
 		}
 	}
+	update_concurrency_ui();
 }
 
-void DatastoreBulkOperationProgressWindow::send_next_enumerate_keys_request()
+void DatastoreBulkOperationProgressWindow::update_concurrency_ui()
 {
-	const size_t current_index = progress.get_current_datastore_index();
-	if (current_index < datastore_names.size())
+	const QString in_flight_text = QString{ "In flight: %1/%2 (max %3)" }.arg(entries_in_flight).arg(concurrency.get_window()).arg(concurrency.get_max_window());
+	const QString http_429_text = QString{ "HTTP 429: %1%" }.arg(concurrency.get_http_429_rate() * 100.0, 0, 'f', 1);
+	const QString rate_text = QString{ "%1 req/s" }.arg(concurrency.get_requests_per_second(), 0, 'f', 1);
+	const QString detail_text = get_concurrency_detail();
+	if (detail_text.isEmpty())
+	{
+		concurrency_label->setText(QString{ "%1, %2, %3" }.arg(in_flight_text, http_429_text, rate_text));
+	}
+	else
 	{
-		const QString this_datastore_name = datastore_names[current_index];
+		concurrency_label->setText(QString{ "%1, %2, %3, %4" }.arg(in_flight_text, http_429_text, rate_text, detail_text));
+	}
+}
 
-		enumerate_entries_request = std::make_shared<StandardDatastoreEntryGetListRequest>(api_key, universe_id, this_datastore_name, find_scope, find_key_prefix, initial_cursor);
-		initial_cursor = std::nullopt;
-		enumerate_entries_request->set_http_429_count(http_429_count);
-		connect(enumerate_entries_request.get(), &StandardDatastoreEntryGetListRequest::entry_found, this, &DatastoreBulkOperationProgressWindow::handle_entry_found);
-		connect(enumerate_entries_request.get(), &StandardDatastoreEntryGetListRequest::enumerate_done, this, &DatastoreBulkOperationProgressWindow::handle_enumerate_done);
-		connect(enumerate_entries_request.get(), &StandardDatastoreEntryGetListRequest::enumerate_step, this, &DatastoreBulkOperationProgressWindow::handle_enumerate_step);
-		connect(enumerate_entries_request.get(), &StandardDatastoreEntryGetListRequest::enumerate_step, this, &DatastoreBulkOperationProgressWindow::update_ui);
-		connect(enumerate_entries_request.get(), &StandardDatastoreEntryGetListRequest::received_http_429, this, &DatastoreBulkOperationProgressWindow::handle_received_http_429);
-		connect(enumerate_entries_request.get(), &StandardDatastoreEntryGetListRequest::status_error, this, &DatastoreBulkOperationProgressWindow::handle_error_message);
-		connect(enumerate_entries_request.get(), &StandardDatastoreEntryGetListRequest::status_error, this, &DatastoreBulkOperationProgressWindow::handle_error_message);
-		if (UserProfile::get().get_less_verbose_bulk_operations() == false)
-		{
-			connect(enumerate_entries_request.get(), &StandardDatastoreEntryGetListRequest::status_info, this, &DatastoreBulkOperationProgressWindow::handle_status_message);
-		}
-		connect(enumerate_entries_request.get(), &StandardDatastoreEntryGetListRequest::success, this, &DatastoreBulkOperationProgressWindow::handle_enumerate_keys_success);
-		enumerate_entries_request->send_request();
+void DatastoreBulkOperationProgressWindow::send_enumerate_keys_requests()
+{
+	// Each datastore has its own cursor, so several can be listed at once
+	const size_t max_enumerations = std::min(MAX_CONCURRENT_ENUMERATIONS, UserProfile::get().get_bulk_operation_concurrency());
+	while (enumerate_requests.size() < max_enumerations && pending_enumerations.size() > 0)
+	{
+		const EnumerationCursor next_enumeration = pending_enumerations.front();
+		pending_enumerations.pop_front();
+		send_enumerate_keys_request(next_enumeration);
+	}
 
-		handle_status_message(QString{ "Enumerating entries for '%1'..." }.arg(this_datastore_name));
+	if (enumerate_requests.size() == 0)
+	{
+		begin_entry_requests();
 	}
-	else
+}
+
+void DatastoreBulkOperationProgressWindow::send_enumerate_keys_request(const EnumerationCursor& enumeration)
+{
+	const auto enumerate_request = std::make_shared<StandardDatastoreEntryGetListRequest>(api_key, universe_id, enumeration.datastore_name, find_scope, find_key_prefix, enumeration.cursor);
+	StandardDatastoreEntryGetListRequest* const raw_request = enumerate_request.get();
+	enumerate_request->set_allow_http2(UserProfile::get().get_bulk_operation_http2());
+	enumerate_request->set_use_response_cache(false);
+	enumerate_request->set_operation(windowTitle());
+	// Pipelined or stored entries do not need to be collected in the request as well
+	enumerate_request->set_keep_entries(pipelined == false && stores_found_entries() == false);
+	connect(raw_request, &StandardDatastoreEntryGetListRequest::entry_found, this, &DatastoreBulkOperationProgressWindow::handle_entry_enumerated);
+	connect(raw_request, &StandardDatastoreEntryGetListRequest::enumerate_step, this, [this, raw_request](long long, const std::string&, const std::string& cursor) { handle_enumerate_keys_step(raw_request, cursor); });
+	connect(raw_request, &StandardDatastoreEntryGetListRequest::enumerate_step, this, &DatastoreBulkOperationProgressWindow::update_ui);
+	// List requests are paced by their own rate limit lane, a throttled list page says nothing about how many entries can be fetched at once
+	// List pages are also much slower than entry requests, mixing them into the latency samples would look like a latency spike
+	connect(raw_request, &StandardDatastoreEntryGetListRequest::received_reply, this, &DatastoreBulkOperationProgressWindow::handle_received_enumerate_reply);
+	connect(raw_request, &StandardDatastoreEntryGetListRequest::status_error, this, &DatastoreBulkOperationProgressWindow::handle_error_message);
+	if (UserProfile::get().get_less_verbose_bulk_operations() == false)
+	{
+		connect(raw_request, &StandardDatastoreEntryGetListRequest::status_info, this, &DatastoreBulkOperationProgressWindow::handle_status_message);
+	}
+	connect(raw_request, &StandardDatastoreEntryGetListRequest::success, this, [this, raw_request]() { handle_enumerate_keys_success(raw_request); });
+
+	ActiveEnumeration this_enumeration;
+	this_enumeration.request = enumerate_request;
+	this_enumeration.enumeration = enumeration;
+	enumerate_requests.push_back(this_enumeration);
+	enumerate_request->send_request();
+
+	handle_status_message(QString{ "Enumerating entries for '%1'..." }.arg(enumeration.datastore_name));
+}
+
+void DatastoreBulkOperationProgressWindow::begin_entry_requests()
+{
+	if (confirm_entry_requests())
+	{
+		entry_requests_started = true;
+		fill_entry_slots();
+	}
+}
+
+void DatastoreBulkOperationProgressWindow::fill_entry_slots()
+{
+	if (pending_entries.size() < PENDING_REFILL_THRESHOLD && get_unloaded_entry_count() > 0)
+	{
+		load_more_entries();
+	}
+
+	// List requests do not take entry slots, otherwise a small window would be used up by listing and no entry would be fetched until it is done
+	while (entries_in_flight < get_entry_slot_count() && pending_entries.size() > 0 && can_send_entry_request())
+	{
+		const StandardDatastoreEntryName entry = pending_entries.back();
+		pending_entries.pop_back();
+
+		entries_in_flight++;
+		send_entry_request(entry);
+	}
+
+	if (entries_in_flight == 0 && pending_entries.size() == 0 && get_unloaded_entry_count() == 0 && progress.is_enumerating() == false)
+	{
+		handle_entry_requests_done();
+	}
+}
+
+void DatastoreBulkOperationProgressWindow::finish_entry()
+{
+	OCTASSERT(entries_in_flight > 0);
+	entries_in_flight--;
+	progress.advance_entry_done();
+	fill_entry_slots();
+}
+
+void DatastoreBulkOperationProgressWindow::send_tracked_request(const std::shared_ptr<DataRequest>& request)
+{
+	request->set_allow_http2(UserProfile::get().get_bulk_operation_http2());
+	// Bulk jobs touch each entry once, caching them would only push out responses from interactive browsing
+	request->set_use_response_cache(false);
+	// Lets the HTTP log tell apart requests from several bulk jobs running at once
+	request->set_operation(windowTitle());
+	// Each request backs off on its own, a throttled reply should not make every other slot wait longer
+	connect(request.get(), &DataRequest::received_http_429, this, &DatastoreBulkOperationProgressWindow::handle_received_http_429);
+	connect(request.get(), &DataRequest::received_reply, this, &DatastoreBulkOperationProgressWindow::handle_received_reply);
+	connect(request.get(), &DataRequest::status_error, this, &DatastoreBulkOperationProgressWindow::handle_error_message);
+	if (UserProfile::get().get_less_verbose_bulk_operations() == false)
+	{
+		connect(request.get(), &DataRequest::status_info, this, &DatastoreBulkOperationProgressWindow::handle_status_message);
+	}
+	entry_requests.push_back(request);
+	request->send_request();
+}
+
+void DatastoreBulkOperationProgressWindow::release_tracked_request(const DataRequest* const request)
+{
+	const auto matches_request = [request](const std::shared_ptr<DataRequest>& this_request) { return this_request.get() == request; };
+	entry_requests.erase(std::remove_if(entry_requests.begin(), entry_requests.end(), matches_request), entry_requests.end());
+}
+
+void DatastoreBulkOperationProgressWindow::begin_stage_request(EntryStage& stage)
+{
+	if (stages_started.has_value() == false)
+	{
+		stages_started = std::chrono::steady_clock::now();
+	}
+	stage.in_flight++;
+}
+
+void DatastoreBulkOperationProgressWindow::end_stage_request(EntryStage& stage)
+{
+	OCTASSERT(stage.in_flight > 0);
+	stage.in_flight--;
+	stage.done++;
+}
+
+double DatastoreBulkOperationProgressWindow::get_stage_rate(const EntryStage& stage) const
+{
+	if (stages_started.has_value() == false)
 	{
-		send_next_entry_request();
+		return 0.0;
 	}
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - *stages_started;
+	if (elapsed.count() <= 0.0)
+	{
+		return 0.0;
+	}
+	return static_cast<double>(stage.done) / elapsed.count();
 }
 
 void DatastoreBulkOperationProgressWindow::handle_clicked_retry()
@@ -164,7 +435,12 @@ void DatastoreBulkOperationProgressWindow::handle_error_message(const QString me
 {
 	handle_status_message(message);
 	update_ui();
-	retry_button->setEnabled(is_retryable());
+	const bool retryable = is_retryable();
+	retry_button->setEnabled(retryable);
+	if (retryable)
+	{
+		handle_paused();
+	}
 }
 
 // NOLINTNEXTLINE(*-unnecessary-value-param)
@@ -174,32 +450,93 @@ void DatastoreBulkOperationProgressWindow::handle_status_message(const QString m
 	update_ui();
 }
 
-void DatastoreBulkOperationProgressWindow::handle_enumerate_keys_success()
+void DatastoreBulkOperationProgressWindow::handle_enumerate_keys_step(StandardDatastoreEntryGetListRequest* const request, const std::string& cursor)
 {
-	if (enumerate_entries_request)
+	const auto matches_request = [request](const ActiveEnumeration& this_enumeration) { return this_enumeration.request.get() == request; };
+	const auto enumeration_it = std::find_if(enumerate_requests.begin(), enumerate_requests.end(), matches_request);
+	if (enumeration_it == enumerate_requests.end())
+	{
+		OCTASSERT(false);
+		return;
+	}
+
+	enumeration_it->enumeration.cursor = QString::fromStdString(cursor);
+	handle_enumerate_step(enumeration_it->enumeration);
+}
+
+void DatastoreBulkOperationProgressWindow::handle_enumerate_keys_success(StandardDatastoreEntryGetListRequest* const request)
+{
+	const auto matches_request = [request](const ActiveEnumeration& this_enumeration) { return this_enumeration.request.get() == request; };
+	const auto enumeration_it = std::find_if(enumerate_requests.begin(), enumerate_requests.end(), matches_request);
+	if (enumeration_it == enumerate_requests.end())
+	{
+		OCTASSERT(false);
+		return;
+	}
+
+	if (pipelined == false && stores_found_entries() == false)
 	{
 		if (pending_entries.size() == 0)
 		{
 			// When no entries exist yet, move instead of appending
-			pending_entries = std::move(enumerate_entries_request->get_datastore_entries_rvalue());
+			pending_entries = std::move(request->get_datastore_entries_rvalue());
 		}
 		else
 		{
-			const std::vector<StandardDatastoreEntryName>& new_entries = enumerate_entries_request->get_datastore_entries();
-			pending_entries.insert(pending_entries.end(), new_entries.begin(), new_entries.end());
+			pending_entries.append(request->get_datastore_entries());
 		}
-		progress.advance_datastore_done();
-		progress.set_entry_total(pending_entries.size());
+	}
 
-		enumerate_entries_request.reset();
+	const QString datastore_name = enumeration_it->enumeration.datastore_name;
+	enumerate_requests.erase(enumeration_it);
 
-		send_next_enumerate_keys_request();
+	handle_enumerate_done(universe_id, datastore_name.toStdString());
+	progress.advance_datastore_done();
+	// The total is only known once every datastore has been listed
+	if (progress.is_enumerating() == false)
+	{
+		progress.set_entry_total(progress.get_current_entry_index() + entries_in_flight + pending_entries.size() + get_unloaded_entry_count());
 	}
+
+	send_enumerate_keys_requests();
 }
 
 void DatastoreBulkOperationProgressWindow::handle_received_http_429()
 {
-	http_429_count++;
+	concurrency.record_http_429();
+	update_concurrency_ui();
+}
+
+void DatastoreBulkOperationProgressWindow::handle_received_reply(const qint64 latency_msecs)
+{
+	concurrency.record_reply(std::chrono::milliseconds{ latency_msecs });
+	// The window may have grown, use any new slots right away
+	if (entries_in_flight > 0)
+	{
+		fill_entry_slots();
+	}
+}
+
+void DatastoreBulkOperationProgressWindow::handle_received_enumerate_reply()
+{
+	concurrency.record_reply();
+	if (entries_in_flight > 0)
+	{
+		fill_entry_slots();
+	}
+}
+
+void DatastoreBulkOperationProgressWindow::handle_entry_enumerated(const StandardDatastoreEntryName& entry)
+{
+	handle_entry_found(entry);
+	if (pipelined)
+	{
+		if (stores_found_entries() == false)
+		{
+			pending_entries.push_back(entry);
+		}
+		fill_entry_slots();
+	}
 }
 
 DatastoreBulkOperationProgressWindow::DownloadProgress::DownloadProgress(const size_t datastore_total) : datastore_total{ datastore_total }
@@ -217,11 +554,6 @@ bool DatastoreBulkOperationProgressWindow::DownloadProgress::is_done() const
 	return entry_total.has_value() && entry_done >= *entry_total;
 }
 
-size_t DatastoreBulkOperationProgressWindow::DownloadProgress::get_current_datastore_index() const
-{
-	return datastore_done;
-}
-
 size_t DatastoreBulkOperationProgressWindow::DownloadProgress::get_current_entry_index() const
 {
 	return entry_done;
@@ -260,365 +592,598 @@ std::optional<size_t> DatastoreBulkOperationProgressWindow::DownloadProgress::ge
 	return entry_total;
 }
 
-DatastoreBulkDeleteProgressWindow::DatastoreBulkDeleteProgressWindow(
+DatastoreBulkJournaledProgressWindow::DatastoreBulkJournaledProgressWindow(
 	QWidget* const parent,
 	const QString& api_key,
-	const std::shared_ptr<UniverseProfile>& universe,
+	const long long universe_id,
 	const QString& scope,
 	const QString& key_prefix,
 	const std::vector<QString>& datastore_names,
-	const bool confirm_count_before_delete ,
-	const bool rewrite_before_delete,
-	const bool hide_datastores_when_done) :
-	DatastoreBulkOperationProgressWindow{ parent, api_key, universe->get_universe_id(), scope, key_prefix, datastore_names},
-	attached_universe{ universe },
-	confirm_count_before_delete{ confirm_count_before_delete },
-	rewrite_before_delete{ rewrite_before_delete },
-	hide_datastores_when_done{ hide_datastores_when_done }
+	SqliteDatastoreWrapper* const db_wrapper) :
+	DatastoreBulkOperationProgressWindow{ parent, api_key, universe_id, scope, key_prefix, datastore_names }
 {
-	setWindowTitle("Delete Progress");
+	if (db_wrapper)
+	{
+		pending_reader = db_wrapper->get_pending_reader(universe_id);
+		db_wrapper->write_enumeration_metadata(universe_id, scope.toStdString(), key_prefix.toStdString());
+		// Initialize all targeted datastore names in the sqlite db
+		for (const QString& this_datastore : this->datastore_names)
+		{
+			db_wrapper->write_enumeration(universe_id, this_datastore.toStdString());
+		}
+	}
 }
 
-QString DatastoreBulkDeleteProgressWindow::progress_label_done() const
+DatastoreBulkJournaledProgressWindow::DatastoreBulkJournaledProgressWindow(QWidget* const parent, const QString& api_key, const long long universe_id, SqliteDatastoreWrapper& db_wrapper) :
+	DatastoreBulkOperationProgressWindow{ parent, api_key, universe_id, "", "", std::vector<QString>{} }
 {
-	return "Delete complete";
+	// Only the first page is read up front, the rest is loaded by the writer thread as requests go out
+	const size_t pending_count = db_wrapper.get_pending_count(universe_id);
+	pending_reader = db_wrapper.get_pending_reader(universe_id);
+	pending_entries = db_wrapper.get_pending_entries(pending_reader, PENDING_PAGE_SIZE);
+	unloaded_entry_count = pending_reader.is_done() ? 0 : pending_count - std::min(pending_count, pending_entries.size());
+
+	if (const std::optional<std::string> opt_key_prefix = db_wrapper.get_enumeration_search_key_prefix(universe_id))
+	{
+		this->find_key_prefix = QString::fromStdString(*opt_key_prefix);
+	}
+	if (const std::optional<std::string> opt_scope = db_wrapper.get_enumeration_search_scope(universe_id))
+	{
+		this->find_scope = QString::fromStdString(*opt_scope);
+	}
+
+	// Files from older versions are missing tables that are written while the operation runs
+	db_wrapper.upgrade_schema();
+
+	datastore_names.clear();
+	// Datastores that were partway through are continued first, each from its own cursor
+	for (const auto& [this_datastore_name, this_cursor] : db_wrapper.get_enumerating_cursors(universe_id))
+	{
+		datastore_names.push_back(QString::fromStdString(this_datastore_name));
+		initial_cursors[QString::fromStdString(this_datastore_name)] = QString::fromStdString(this_cursor);
+	}
+	for (const std::string& this_datastore_name : db_wrapper.get_pending_datastores(universe_id))
+	{
+		datastore_names.push_back(QString::fromStdString(this_datastore_name));
+	}
+	progress = DownloadProgress{ datastore_names.size() };
+
+	if (datastore_names.size() == 0)
+	{
+		progress.set_entry_total(pending_count);
+	}
 }
 
-QString DatastoreBulkDeleteProgressWindow::progress_label_working(const size_t total) const
+bool DatastoreBulkJournaledProgressWindow::can_send_entry_request() const
 {
-	return QString{ "Deleting entry %1/%2..." }.arg(progress.get_current_entry_index() + 1).arg(total);
+	// Responses arrive faster than the disk can take them, stop asking for more until the writer catches up
+	return db_writer == nullptr || db_writer->is_full() == false;
 }
 
-void DatastoreBulkDeleteProgressWindow::send_next_entry_request()
+void DatastoreBulkJournaledProgressWindow::handle_paused()
 {
-	if (confirm_count_before_delete && first_delete_request_sent == false)
+	if (db_writer)
 	{
-		QString message = QString{ "This operation will delete %1 entries. Are you sure you want to proceed?" }.arg(pending_entries.size());
-
-		QMessageBox* msg_box = new QMessageBox{ this };
-		msg_box->setWindowTitle("Confirm deletion");
-		msg_box->setText(message);
-		msg_box->setStandardButtons(QMessageBox::Yes | QMessageBox::No);
-		if (msg_box->exec() == QMessageBox::No)
-		{
-			handle_status_message("Bulk delete aborted");
-			close_button->setText("Close");
-			return;
-		}
+		db_writer->flush();
 	}
+}
 
-	if (pending_entries.size() > 0)
-	{
-		StandardDatastoreEntryName entry = pending_entries.back();
-		pending_entries.pop_back();
+size_t DatastoreBulkJournaledProgressWindow::get_unloaded_entry_count() const
+{
+	return unloaded_entry_count;
+}
 
-		if (rewrite_before_delete)
-		{
-			get_entry_request = std::make_shared<StandardDatastoreEntryGetDetailsRequest>(api_key, universe_id, entry.get_datastore_name(), entry.get_scope(), entry.get_key());
-			get_entry_request->set_http_429_count(http_429_count);
-			connect(get_entry_request.get(), &StandardDatastoreEntryGetDetailsRequest::received_http_429, this, &DatastoreBulkDeleteProgressWindow::handle_received_http_429);
-			connect(get_entry_request.get(), &StandardDatastoreEntryGetDetailsRequest::status_error, this, &DatastoreBulkDeleteProgressWindow::handle_error_message);
-			if (UserProfile::get().get_less_verbose_bulk_operations() == false)
-			{
-				connect(get_entry_request.get(), &StandardDatastoreEntryGetDetailsRequest::status_info, this, &DatastoreBulkDeleteProgressWindow::handle_status_message);
-			}
-			connect(get_entry_request.get(), &StandardDatastoreEntryGetDetailsRequest::success, this, &DatastoreBulkDeleteProgressWindow::handle_get_entry_response);
-			get_entry_request->send_request();
+void DatastoreBulkJournaledProgressWindow::load_more_entries()
+{
+	if (loading_entries || db_writer == nullptr)
+	{
+		return;
+	}
+	loading_entries = true;
+	entries_found_at_load = entries_found;
+
+	// Queued behind earlier writes, so entries that were finished in the meantime are already gone from the table and entries found so far are in it
+	db_writer->push_read([this, reader = pending_reader](SqliteDatastoreWrapper& db) mutable {
+		db.extend_pending_reader(reader);
+		StandardDatastoreEntryNameList entries = db.get_pending_entries(reader, PENDING_PAGE_SIZE);
+		QMetaObject::invokeMethod(this, [this, reader, entries = std::move(entries)]() mutable {
+			handle_entries_loaded(reader, std::move(entries));
+		}, Qt::QueuedConnection);
+	});
+}
 
-			handle_status_message( QString{ "Rewriting and deleting '%1'..." }.arg( entry.get_key() ) );
-		}
-		else
-		{
-			delete_entry_request = std::make_shared<StandardDatastoreEntryDeleteRequest>(api_key, universe_id, entry.get_datastore_name(), entry.get_scope(), entry.get_key());
-			delete_entry_request->set_http_429_count(http_429_count);
-			connect(delete_entry_request.get(), &StandardDatastoreEntryDeleteRequest::received_http_429, this, &DatastoreBulkDeleteProgressWindow::handle_received_http_429);
-			connect(delete_entry_request.get(), &StandardDatastoreEntryDeleteRequest::status_error, this, &DatastoreBulkDeleteProgressWindow::handle_error_message);
-			if (UserProfile::get().get_less_verbose_bulk_operations() == false)
-			{
-				connect(delete_entry_request.get(), &StandardDatastoreEntryDeleteRequest::status_info, this, &DatastoreBulkDeleteProgressWindow::handle_status_message);
-			}
-			connect(delete_entry_request.get(), &StandardDatastoreEntryDeleteRequest::success, this, &DatastoreBulkDeleteProgressWindow::handle_delete_entry_response);
-			delete_entry_request->send_request();
+bool DatastoreBulkJournaledProgressWindow::stores_found_entries() const
+{
+	return db_writer != nullptr;
+}
 
-			handle_status_message(QString{ "Deleting '%1'..." }.arg(entry.get_key()));
-		}
-		first_delete_request_sent = true;
-	}
-	else
+void DatastoreBulkJournaledProgressWindow::handle_entry_found(const StandardDatastoreEntryName& name)
+{
+	if (db_writer)
 	{
-		if (const std::shared_ptr<UniverseProfile> universe = attached_universe.lock())
-		{
-			if (hide_datastores_when_done)
-			{
-				for (const QString& this_name : datastore_names)
-				{
-					universe->add_hidden_datastore(this_name);
-					handle_status_message(QString{ "Hid datastore: '%1'" }.arg(this_name));
-				}
-			}
-		}
-		close_button->setText("Close");
-		handle_status_message("Bulk delete complete");
-		handle_status_message(get_summary());
+		db_writer->push([name](SqliteDatastoreWrapper& db) {
+			db.write_pending(name);
+		});
+		entries_found++;
+		unloaded_entry_count++;
 	}
 }
 
-void DatastoreBulkDeleteProgressWindow::handle_get_entry_response()
+void DatastoreBulkJournaledProgressWindow::handle_enumerate_done(const long long universe_id_in, const std::string& datastore_name)
 {
-	if (get_entry_request)
+	if (db_writer)
 	{
-		const std::optional<StandardDatastoreEntryFull> opt_details = get_entry_request->get_details();
-
-		get_entry_request.reset();
-
-		if (opt_details)
-		{
-			const QString datastore_name = opt_details->get_datastore_name();
-			const QString scope = opt_details->get_scope();
-			const QString key_name = opt_details->get_key_name();
-			const std::optional<QString> userids = opt_details->get_userids();
-			const std::optional<QString> attributes = opt_details->get_attributes();
-			const QString body = opt_details->get_data_raw();
-
-			post_entry_request = std::make_shared<StandardDatastoreEntryPostSetRequest>(api_key, universe_id, datastore_name, scope, key_name, userids, attributes, body);
-			post_entry_request->set_http_429_count(http_429_count);
-			connect(post_entry_request.get(), &StandardDatastoreEntryPostSetRequest::received_http_429, this, &DatastoreBulkDeleteProgressWindow::handle_received_http_429);
-			connect(post_entry_request.get(), &StandardDatastoreEntryPostSetRequest::status_error, this, &DatastoreBulkDeleteProgressWindow::handle_error_message);
-			if (UserProfile::get().get_less_verbose_bulk_operations() == false)
-			{
-				connect(post_entry_request.get(), &StandardDatastoreEntryPostSetRequest::status_info, this, &DatastoreBulkDeleteProgressWindow::handle_status_message);
-			}
-			connect(post_entry_request.get(), &StandardDatastoreEntryPostSetRequest::success, this, &DatastoreBulkDeleteProgressWindow::handle_post_entry_response);
-			post_entry_request->send_request();
-		}
-		else
-		{
-			entries_already_deleted++;
-			handle_status_message("Entry was already deleted");
-			progress.advance_entry_done();
-			send_next_entry_request();
-		}
+		db_writer->push_resume_point([universe_id_in, datastore_name](SqliteDatastoreWrapper& db) {
+			db.delete_enumeration(universe_id_in, datastore_name);
+		});
 	}
 }
 
-void DatastoreBulkDeleteProgressWindow::handle_post_entry_response()
+void DatastoreBulkJournaledProgressWindow::handle_enumerate_step(const EnumerationCursor& enumeration)
 {
-	if (post_entry_request)
+	if (db_writer)
 	{
-		const QString datastore_name = post_entry_request->get_datastore_name();
-		const QString scope = post_entry_request->get_scope();
-		const QString key_name = post_entry_request->get_key_name();
-
-		post_entry_request.reset();
-
-		delete_entry_request = std::make_shared<StandardDatastoreEntryDeleteRequest>(api_key, universe_id, datastore_name, scope, key_name);
-		delete_entry_request->set_http_429_count(http_429_count);
-		connect(delete_entry_request.get(), &StandardDatastoreEntryDeleteRequest::received_http_429, this, &DatastoreBulkDeleteProgressWindow::handle_received_http_429);
-		connect(delete_entry_request.get(), &StandardDatastoreEntryDeleteRequest::status_error, this, &DatastoreBulkDeleteProgressWindow::handle_error_message);
-		if (UserProfile::get().get_less_verbose_bulk_operations() == false)
-		{
-			connect(delete_entry_request.get(), &StandardDatastoreEntryDeleteRequest::status_info, this, &DatastoreBulkDeleteProgressWindow::handle_status_message);
-		}
-		connect(delete_entry_request.get(), &StandardDatastoreEntryDeleteRequest::success, this, &DatastoreBulkDeleteProgressWindow::handle_delete_entry_response);
-		delete_entry_request->send_request();
+		// Entries found on this page are queued before the cursor moves past them
+		db_writer->push_resume_point([universe_id_in = universe_id, datastore_name = enumeration.datastore_name.toStdString(), cursor = enumeration.cursor.value_or("").toStdString()](SqliteDatastoreWrapper& db) {
+			db.write_enumeration(universe_id_in, datastore_name, cursor);
+		});
 	}
 }
 
-void DatastoreBulkDeleteProgressWindow::handle_delete_entry_response()
+void DatastoreBulkJournaledProgressWindow::journal_outcome(const StandardDatastoreEntryName& entry, const std::string& outcome, const bool failed)
 {
-	if (delete_entry_request)
+	if (db_writer)
 	{
-		const std::optional<bool> success = delete_entry_request->is_delete_success();
-
-		delete_entry_request.reset();
-
-		if (success)
-		{
-			if (*success)
-			{
-				entries_deleted++;
-				handle_status_message("Entry deleted");
-			}
-			else
+		db_writer->push_resume_point([entry, outcome, failed](SqliteDatastoreWrapper& db) {
+			db.write_outcome(entry, outcome);
+			if (failed == false)
 			{
-				entries_already_deleted++;
-				handle_status_message("Entry was already deleted");
+				db.delete_pending(entry);
 			}
-		}
-
-		progress.advance_entry_done();
-		send_next_entry_request();
+		});
 	}
 }
 
-QString DatastoreBulkDeleteProgressWindow::get_summary() const
+void DatastoreBulkJournaledProgressWindow::close_journal()
 {
-	QString result = QString{ "%1 entries deleted" }.arg(entries_deleted);
-	if (entries_already_deleted > 0)
+	if (db_writer)
 	{
-		result = result + QString{ ", %1 entries already deleted" }.arg(entries_already_deleted);
+		handle_status_message("Saving progress...");
+		db_writer->close();
+	}
+	else
+	{
+		close_button->setText("Close");
 	}
-	return result;
 }
 
-DatastoreBulkDownloadProgressWindow::DatastoreBulkDownloadProgressWindow(
-	QWidget* parent,
+void DatastoreBulkJournaledProgressWindow::start_writer(std::unique_ptr<SqliteDatastoreWrapper> db_wrapper)
+{
+	// Whatever the constructors wrote is committed before the first request goes out
+	db_wrapper->flush();
+	db_writer = std::make_unique<SqliteDatastoreWriter>(std::move(db_wrapper), WRITER_QUEUE_CAPACITY);
+	// Signals arrive from the writer thread and are queued to this window
+	connect(db_writer.get(), &SqliteDatastoreWriter::closed, this, &DatastoreBulkJournaledProgressWindow::handle_writer_closed);
+	connect(db_writer.get(), &SqliteDatastoreWriter::flushed, this, &DatastoreBulkJournaledProgressWindow::handle_writer_flushed);
+	connect(db_writer.get(), &SqliteDatastoreWriter::queue_available, this, &DatastoreBulkJournaledProgressWindow::handle_writer_available);
+}
+
+void DatastoreBulkJournaledProgressWindow::handle_entries_loaded(const SqlitePendingEntryReader& reader, StandardDatastoreEntryNameList entries)
+{
+	loading_entries = false;
+	pending_reader = reader;
+	if (pending_reader.is_done())
+	{
+		// Every entry found before the load was queued has been read, only later ones are still in the table
+		unloaded_entry_count = entries_found - entries_found_at_load;
+	}
+	else
+	{
+		// Keys listed twice only leave one row behind, so the count is kept above zero until the reader says it is done
+		unloaded_entry_count = std::max<size_t>(unloaded_entry_count - std::min(unloaded_entry_count, entries.size()), 1);
+	}
+	pending_entries.append(entries);
+
+	// Unless pipelined, nothing is requested until enumeration is done and the requests were confirmed
+	if (pipelined || entry_requests_started)
+	{
+		fill_entry_slots();
+	}
+}
+
+void DatastoreBulkJournaledProgressWindow::handle_writer_available()
+{
+	// Unless pipelined, entries loaded for a resumed operation wait until enumeration is done and the requests were confirmed
+	if ((pipelined || entry_requests_started) && pending_entries.size() > 0)
+	{
+		fill_entry_slots();
+	}
+}
+
+void DatastoreBulkJournaledProgressWindow::handle_writer_closed()
+{
+	close_button->setText("Close");
+	if (progress.is_done())
+	{
+		handle_status_message(progress_label_done());
+	}
+	else
+	{
+		// Stopped before every entry was done, the file still holds what is left
+		handle_status_message("Progress saved, the operation can be resumed from this point");
+	}
+}
+
+void DatastoreBulkJournaledProgressWindow::handle_writer_flushed()
+{
+	handle_status_message("Progress saved, the operation can be resumed from this point");
+}
+
+DatastoreBulkDeleteProgressWindow::DatastoreBulkDeleteProgressWindow(
+	QWidget* const parent,
 	const QString& api_key,
-	long long universe_id,
+	const std::shared_ptr<UniverseProfile>& universe,
 	const QString& scope,
 	const QString& key_prefix,
 	const std::vector<QString>& datastore_names,
-	std::unique_ptr<SqliteDatastoreWrapper> db_wrapper) :
-	DatastoreBulkOperationProgressWindow{ parent, api_key, universe_id, scope, key_prefix, datastore_names },
-	db_wrapper{ std::move(db_wrapper) }
+	const bool confirm_count_before_delete ,
+	const bool rewrite_before_delete,
+	const bool hide_datastores_when_done,
+	std::unique_ptr<SqliteDatastoreWrapper> journal) :
+	DatastoreBulkJournaledProgressWindow{ parent, api_key, universe->get_universe_id(), scope, key_prefix, datastore_names, journal.get() },
+	attached_universe{ universe },
+	confirm_count_before_delete{ confirm_count_before_delete },
+	rewrite_before_delete{ rewrite_before_delete }
 {
-	setWindowTitle("Download Progress");
+	setWindowTitle("Delete Progress");
+
+	if (hide_datastores_when_done)
+	{
+		datastores_to_hide = datastore_names;
+	}
 
-	this->db_wrapper->write_enumeration_metadata(universe_id, scope.toStdString(), key_prefix.toStdString());
-	// Initialize all targeted datastore names in the sqlite db
-	for (const QString& this_datastore : this->datastore_names)
+	if (journal)
 	{
-		this->db_wrapper->write_enumeration(universe_id, this_datastore.toStdString());
+		journal->write_journal_operation(SqliteJournalOperation::Delete);
+		journal->write_journal_option(JOURNAL_OPTION_CONFIRM_COUNT, confirm_count_before_delete ? "1" : "0");
+		journal->write_journal_option(JOURNAL_OPTION_REWRITE, rewrite_before_delete ? "1" : "0");
+		journal->write_journal_option(JOURNAL_OPTION_HIDE_DATASTORES, join_datastore_names(datastores_to_hide));
+		start_writer(std::move(journal));
 	}
 }
 
-DatastoreBulkDownloadProgressWindow::DatastoreBulkDownloadProgressWindow(
-	QWidget* parent,
-	const QString& api_key,
-	long long universe_id,
-	std::unique_ptr<SqliteDatastoreWrapper> db_wrapper) :
-	DatastoreBulkOperationProgressWindow{ parent, api_key, universe_id, "", "", std::vector<QString>{} },
-	db_wrapper{ std::move(db_wrapper) }
+DatastoreBulkDeleteProgressWindow::DatastoreBulkDeleteProgressWindow(QWidget* const parent, const QString& api_key, const std::shared_ptr<UniverseProfile>& universe, std::unique_ptr<SqliteDatastoreWrapper> journal) :
+	DatastoreBulkJournaledProgressWindow{ parent, api_key, universe->get_universe_id(), *journal },
+	attached_universe{ universe }
 {
-	setWindowTitle("Download Progress");
+	setWindowTitle("Delete Progress");
+
+	confirm_count_before_delete = journal->get_journal_option(JOURNAL_OPTION_CONFIRM_COUNT).value_or("1") == "1";
+	rewrite_before_delete = journal->get_journal_option(JOURNAL_OPTION_REWRITE).value_or("0") == "1";
+	datastores_to_hide = split_datastore_names(journal->get_journal_option(JOURNAL_OPTION_HIDE_DATASTORES).value_or(""));
 
-	pending_entries = this->db_wrapper->get_pending_entries(universe_id);
+	// The summary covers the whole delete, not only the part done after resuming
+	std::map<std::string, size_t> outcome_counts = journal->get_outcome_counts(universe_id);
+	entries_deleted = outcome_counts[OUTCOME_DELETED];
+	entries_already_deleted = outcome_counts[OUTCOME_ALREADY_DELETED];
+	handle_status_message(QString{ "Continuing previous delete, %1 entries were already done" }.arg(entries_deleted + entries_already_deleted));
+
+	start_writer(std::move(journal));
+}
+
+QString DatastoreBulkDeleteProgressWindow::progress_label_done() const
+{
+	return "Delete complete";
+}
 
-	if (const std::optional<std::string> opt_key_prefix = this->db_wrapper->get_enumeration_search_key_prefix(universe_id))
+QString DatastoreBulkDeleteProgressWindow::progress_label_working(const size_t total) const
+{
+	return QString{ "Deleting entry %1/%2..." }.arg(progress.get_current_entry_index() + 1).arg(total);
+}
+
+bool DatastoreBulkDeleteProgressWindow::confirm_entry_requests()
+{
+	if (confirm_count_before_delete)
 	{
-		this->find_key_prefix = QString::fromStdString(*opt_key_prefix);
+		// A resumed delete still has entries in the file that are not loaded yet
+		QString message = QString{ "This operation will delete %1 entries. Are you sure you want to proceed?" }.arg(pending_entries.size() + get_unloaded_entry_count());
+
+		QMessageBox* msg_box = new QMessageBox{ this };
+		msg_box->setWindowTitle("Confirm deletion");
+		msg_box->setText(message);
+		msg_box->setStandardButtons(QMessageBox::Yes | QMessageBox::No);
+		if (msg_box->exec() == QMessageBox::No)
+		{
+			handle_status_message("Bulk delete aborted");
+			close_journal();
+			return false;
+		}
 	}
-	if (const std::optional<std::string> opt_scope = this->db_wrapper->get_enumeration_search_scope(universe_id))
+	return true;
+}
+
+size_t DatastoreBulkDeleteProgressWindow::get_entry_slot_count() const
+{
+	if (rewrite_before_delete)
 	{
-		this->find_scope = QString::fromStdString(*opt_scope);
+		// Each stage gets the whole window, an entry keeps its slot while it waits for the next stage
+		return concurrency.get_window() * REWRITE_STAGE_COUNT;
 	}
+	return DatastoreBulkJournaledProgressWindow::get_entry_slot_count();
+}
 
-	datastore_names.clear();
-	if (const std::optional<std::string> opt_name = this->db_wrapper->get_enumerating_datastore(universe_id))
+bool DatastoreBulkDeleteProgressWindow::can_send_entry_request() const
+{
+	if (DatastoreBulkJournaledProgressWindow::can_send_entry_request() == false)
 	{
-		datastore_names.push_back(QString::fromStdString(*opt_name));
+		return false;
 	}
-	if (const std::optional<std::string> opt_cursor = this->db_wrapper->get_enumerating_cursor(universe_id))
+	if (rewrite_before_delete)
 	{
-		initial_cursor = QString::fromStdString(*opt_cursor);
+		// Stop reading ahead once the posts fall behind so fetched values do not pile up in memory
+		const size_t window = concurrency.get_window();
+		return get_stage.in_flight < window && entries_awaiting_post.size() < window;
 	}
-	for (const std::string& this_datastore_name : this->db_wrapper->get_pending_datastores(universe_id))
+	return true;
+}
+
+void DatastoreBulkDeleteProgressWindow::send_entry_request(const StandardDatastoreEntryName& entry)
+{
+	if (rewrite_before_delete)
 	{
-		datastore_names.push_back(QString::fromStdString(this_datastore_name));
+		begin_stage_request(get_stage);
+
+		const auto get_entry_request = std::make_shared<StandardDatastoreEntryGetDetailsRequest>(api_key, universe_id, entry.get_datastore_name(), entry.get_scope(), entry.get_key());
+		StandardDatastoreEntryGetDetailsRequest* const raw_request = get_entry_request.get();
+		connect(raw_request, &StandardDatastoreEntryGetDetailsRequest::success, this, [this, raw_request]() { handle_get_entry_response(raw_request); });
+		send_tracked_request(get_entry_request);
+
+		handle_status_message( QString{ "Rewriting and deleting '%1'..." }.arg( entry.get_key() ) );
 	}
-	progress = DownloadProgress{ datastore_names.size() };
+	else
+	{
+		send_delete_request(entry.get_datastore_name(), entry.get_scope(), entry.get_key());
 
-	if (datastore_names.size() == 0)
+		handle_status_message(QString{ "Deleting '%1'..." }.arg(entry.get_key()));
+	}
+}
+
+void DatastoreBulkDeleteProgressWindow::handle_entry_requests_done()
+{
+	if (const std::shared_ptr<UniverseProfile> universe = attached_universe.lock())
+	{
+		for (const QString& this_name : datastores_to_hide)
+		{
+			universe->add_hidden_datastore(this_name);
+			handle_status_message(QString{ "Hid datastore: '%1'" }.arg(this_name));
+		}
+	}
+	handle_status_message("Bulk delete complete");
+	handle_status_message(get_summary());
+	close_journal();
+}
+
+QString DatastoreBulkDeleteProgressWindow::get_concurrency_detail() const
+{
+	if (rewrite_before_delete == false)
 	{
-		progress.set_entry_total(pending_entries.size());
+		return "";
 	}
+	return QString{ "get %1/s, post %2/s, delete %3/s" }
+		.arg(get_stage_rate(get_stage), 0, 'f', 1)
+		.arg(get_stage_rate(post_stage), 0, 'f', 1)
+		.arg(get_stage_rate(delete_stage), 0, 'f', 1);
 }
 
-QString DatastoreBulkDownloadProgressWindow::progress_label_done() const
+void DatastoreBulkDeleteProgressWindow::send_post_request(const StandardDatastoreEntryFull& details)
 {
-	return "Download complete";
+	begin_stage_request(post_stage);
+
+	const auto post_entry_request = std::make_shared<StandardDatastoreEntryPostSetRequest>(api_key, universe_id, details.get_datastore_name(), details.get_scope(), details.get_key_name(), details.get_userids(), details.get_attributes(), details.get_data_raw());
+	StandardDatastoreEntryPostSetRequest* const raw_request = post_entry_request.get();
+	connect(raw_request, &StandardDatastoreEntryPostSetRequest::success, this, [this, raw_request]() { handle_post_entry_response(raw_request); });
+	send_tracked_request(post_entry_request);
 }
 
-QString DatastoreBulkDownloadProgressWindow::progress_label_working(const size_t total) const
+void DatastoreBulkDeleteProgressWindow::send_delete_request(const QString& datastore_name, const QString& scope, const QString& key_name)
 {
-	return QString{ "Downloading entry %1/%2..." }.arg(progress.get_current_entry_index() + 1).arg(total);
+	if (rewrite_before_delete)
+	{
+		begin_stage_request(delete_stage);
+	}
+
+	const auto delete_entry_request = std::make_shared<StandardDatastoreEntryDeleteRequest>(api_key, universe_id, datastore_name, scope, key_name);
+	StandardDatastoreEntryDeleteRequest* const raw_request = delete_entry_request.get();
+	connect(raw_request, &StandardDatastoreEntryDeleteRequest::success, this, [this, raw_request]() { handle_delete_entry_response(raw_request); });
+	send_tracked_request(delete_entry_request);
 }
 
-void DatastoreBulkDownloadProgressWindow::send_next_entry_request()
+void DatastoreBulkDeleteProgressWindow::advance_rewrite_stages()
 {
-	if (pending_entries.size() > 0)
+	// Later stages go first so keys that are nearly done finish before more are started
+	const size_t window = concurrency.get_window();
+	while (delete_stage.in_flight < window && entries_awaiting_delete.size() > 0)
 	{
-		StandardDatastoreEntryName entry = pending_entries.back();
-		pending_entries.pop_back();
+		const StandardDatastoreEntryName entry = entries_awaiting_delete.front();
+		entries_awaiting_delete.pop_front();
+		send_delete_request(entry.get_datastore_name(), entry.get_scope(), entry.get_key());
+	}
+	while (post_stage.in_flight < window && entries_awaiting_post.size() > 0 && entries_awaiting_delete.size() < window)
+	{
+		const StandardDatastoreEntryFull details = entries_awaiting_post.front();
+		entries_awaiting_post.pop_front();
+		send_post_request(details);
+	}
+}
 
-		get_entry_details_request = std::make_shared<StandardDatastoreEntryGetDetailsRequest>(api_key, universe_id, entry.get_datastore_name(), entry.get_scope(), entry.get_key());
-		get_entry_details_request->set_http_429_count(http_429_count);
-		connect(get_entry_details_request.get(), &StandardDatastoreEntryGetDetailsRequest::received_http_429, this, &DatastoreBulkDownloadProgressWindow::handle_received_http_429);
-		connect(get_entry_details_request.get(), &StandardDatastoreEntryGetDetailsRequest::status_error, this, &DatastoreBulkDownloadProgressWindow::handle_error_message);
-		if (UserProfile::get().get_less_verbose_bulk_operations() == false)
-		{
-			connect(get_entry_details_request.get(), &StandardDatastoreEntryGetDetailsRequest::status_info, this, &DatastoreBulkDownloadProgressWindow::handle_status_message);
-		}
-		connect(get_entry_details_request.get(), &StandardDatastoreEntryGetDetailsRequest::success, this, &DatastoreBulkDownloadProgressWindow::handle_entry_response);
-		get_entry_details_request->send_request();
+void DatastoreBulkDeleteProgressWindow::handle_get_entry_response(StandardDatastoreEntryGetDetailsRequest* const request)
+{
+	const std::optional<StandardDatastoreEntryFull> opt_details = request->get_details();
+	const StandardDatastoreEntryName entry{ universe_id, request->get_datastore_name(), request->get_key_name(), request->get_scope() };
 
-		handle_status_message(QString{ "Downloading '%1'..." }.arg(entry.get_key()));
+	release_tracked_request(request);
+
+	end_stage_request(get_stage);
+
+	if (opt_details)
+	{
+		entries_awaiting_post.push_back(*opt_details);
+		advance_rewrite_stages();
+		// The get slot is free again
+		fill_entry_slots();
 	}
 	else
 	{
-		close_button->setText("Close");
-		handle_status_message("Download complete");
+		entries_already_deleted++;
+		journal_outcome(entry, OUTCOME_ALREADY_DELETED);
+		handle_status_message("Entry was already deleted");
+		finish_entry();
 	}
 }
 
-bool DatastoreBulkDownloadProgressWindow::is_retryable() const
+void DatastoreBulkDeleteProgressWindow::handle_post_entry_response(StandardDatastoreEntryPostSetRequest* const request)
 {
-	return DatastoreBulkOperationProgressWindow::is_retryable() || (get_entry_details_request && get_entry_details_request->req_status() == DataRequestStatus::Error);
+	const StandardDatastoreEntryName entry{ universe_id, request->get_datastore_name(), request->get_key_name(), request->get_scope() };
+
+	release_tracked_request(request);
+
+	end_stage_request(post_stage);
+
+	entries_awaiting_delete.push_back(entry);
+	advance_rewrite_stages();
+	fill_entry_slots();
 }
 
-bool DatastoreBulkDownloadProgressWindow::do_retry()
+void DatastoreBulkDeleteProgressWindow::handle_delete_entry_response(StandardDatastoreEntryDeleteRequest* const request)
 {
-	if (is_retryable())
+	const std::optional<bool> success = request->is_delete_success();
+	const StandardDatastoreEntryName entry{ universe_id, request->get_datastore_name(), request->get_key_name(), request->get_scope() };
+
+	release_tracked_request(request);
+
+	if (rewrite_before_delete)
 	{
-		if (DatastoreBulkOperationProgressWindow::do_retry())
+		end_stage_request(delete_stage);
+	}
+
+	if (success)
+	{
+		if (*success)
 		{
-			return true;
+			entries_deleted++;
+			journal_outcome(entry, OUTCOME_DELETED);
+			handle_status_message("Entry deleted");
 		}
-		else if (get_entry_details_request && get_entry_details_request->req_status() == DataRequestStatus::Error)
+		else
 		{
-			get_entry_details_request->force_retry();
-			return true;
+			entries_already_deleted++;
+			journal_outcome(entry, OUTCOME_ALREADY_DELETED);
+			handle_status_message("Entry was already deleted");
 		}
 	}
-	return false;
+	else
+	{
+		journal_outcome(entry, OUTCOME_FAILED, true);
+	}
+
+	if (rewrite_before_delete)
+	{
+		advance_rewrite_stages();
+	}
+	finish_entry();
 }
 
-void DatastoreBulkDownloadProgressWindow::handle_entry_response()
+QString DatastoreBulkDeleteProgressWindow::get_summary() const
 {
-	if (get_entry_details_request)
+	QString result = QString{ "%1 entries deleted" }.arg(entries_deleted);
+	if (entries_already_deleted > 0)
 	{
-		const std::optional<StandardDatastoreEntryFull> opt_details = get_entry_details_request->get_details();
-		if (opt_details)
-		{
-			db_wrapper->write_details(*opt_details);
-			db_wrapper->delete_pending(*opt_details);
-		}
-		else
-		{
-			// Entry was deleted
-			const StandardDatastoreEntryName entry(get_entry_details_request->get_universe_id(), get_entry_details_request->get_datastore_name(), get_entry_details_request->get_key_name(), get_entry_details_request->get_scope());
-			db_wrapper->write_deleted(entry);
-			db_wrapper->delete_pending(entry);
-		}
-		progress.advance_entry_done();
-		get_entry_details_request.reset();
-		send_next_entry_request();
+		result = result + QString{ ", %1 entries already deleted" }.arg(entries_already_deleted);
+	}
+	if (rewrite_before_delete)
+	{
+		result = result + QString{ ", rewrite stages: %1 gets, %2 posts, %3 deletes (%4)" }.arg(get_stage.done).arg(post_stage.done).arg(delete_stage.done).arg(get_concurrency_detail());
 	}
+	return result;
+}
+
+DatastoreBulkDownloadProgressWindow::DatastoreBulkDownloadProgressWindow(
+	QWidget* parent,
+	const QString& api_key,
+	long long universe_id,
+	const QString& scope,
+	const QString& key_prefix,
+	const std::vector<QString>& datastore_names,
+	std::unique_ptr<SqliteDatastoreWrapper> db_wrapper) :
+	DatastoreBulkJournaledProgressWindow{ parent, api_key, universe_id, scope, key_prefix, datastore_names, db_wrapper.get() }
+{
+	setWindowTitle("Download Progress");
+	pipelined = UserProfile::get().get_bulk_download_pipelined();
+
+	start_writer(std::move(db_wrapper));
+}
+
+DatastoreBulkDownloadProgressWindow::DatastoreBulkDownloadProgressWindow(
+	QWidget* parent,
+	const QString& api_key,
+	long long universe_id,
+	std::unique_ptr<SqliteDatastoreWrapper> db_wrapper) :
+	DatastoreBulkJournaledProgressWindow{ parent, api_key, universe_id, *db_wrapper }
+{
+	setWindowTitle("Download Progress");
+	pipelined = UserProfile::get().get_bulk_download_pipelined();
+
+	start_writer(std::move(db_wrapper));
 }
 
-void DatastoreBulkDownloadProgressWindow::handle_entry_found(const StandardDatastoreEntryName& name)
+QString DatastoreBulkDownloadProgressWindow::progress_label_done() const
 {
-	this->db_wrapper->write_pending(name);
+	return "Download complete";
+}
+
+QString DatastoreBulkDownloadProgressWindow::progress_label_working(const size_t total) const
+{
+	return QString{ "Downloading entry %1/%2..." }.arg(progress.get_current_entry_index() + 1).arg(total);
 }
 
-void DatastoreBulkDownloadProgressWindow::handle_enumerate_done(const long long universe_id_in, const std::string& datastore_name)
+void DatastoreBulkDownloadProgressWindow::send_entry_request(const StandardDatastoreEntryName& entry)
 {
-	this->db_wrapper->delete_enumeration(universe_id_in, datastore_name);
+	const auto get_entry_details_request = std::make_shared<StandardDatastoreEntryGetDetailsRequest>(api_key, universe_id, entry.get_datastore_name(), entry.get_scope(), entry.get_key());
+	StandardDatastoreEntryGetDetailsRequest* const raw_request = get_entry_details_request.get();
+	connect(raw_request, &StandardDatastoreEntryGetDetailsRequest::success, this, [this, raw_request]() { handle_entry_response(raw_request); });
+	send_tracked_request(get_entry_details_request);
+
+	handle_status_message(QString{ "Downloading '%1'..." }.arg(entry.get_key()));
 }
 
-void DatastoreBulkDownloadProgressWindow::handle_enumerate_step(const long long universe_id_in, const std::string& datastore_name, const std::string& cursor)
+void DatastoreBulkDownloadProgressWindow::handle_entry_requests_done()
 {
-	this->db_wrapper->write_enumeration(universe_id_in, datastore_name, cursor);
+	// The download is only complete once everything queued is on disk
+	handle_status_message("Saving remaining entries...");
+	db_writer->close();
+}
+
+void DatastoreBulkDownloadProgressWindow::handle_entry_response(StandardDatastoreEntryGetDetailsRequest* const request)
+{
+	const std::optional<StandardDatastoreEntryFull> opt_details = request->get_details();
+	if (opt_details)
+	{
+		db_writer->push_resume_point([details = *opt_details](SqliteDatastoreWrapper& db) {
+			db.write_details(details);
+			db.delete_pending(details);
+		});
+	}
+	else
+	{
+		// Entry was deleted
+		const StandardDatastoreEntryName entry(request->get_universe_id(), request->get_datastore_name(), request->get_key_name(), request->get_scope());
+		db_writer->push_resume_point([entry](SqliteDatastoreWrapper& db) {
+			db.write_deleted(entry);
+			db.delete_pending(entry);
+		});
+	}
+	release_tracked_request(request);
+	finish_entry();
 }
 
 DatastoreBulkUndeleteProgressWindow::DatastoreBulkUndeleteProgressWindow(
@@ -628,12 +1193,51 @@ DatastoreBulkUndeleteProgressWindow::DatastoreBulkUndeleteProgressWindow(
 	const QString& scope,
 	const QString& key_prefix,
 	const std::vector<QString>& datastore_names,
-	const std::optional<QDateTime>& undelete_after
+	const std::optional<QDateTime>& undelete_after,
+	std::unique_ptr<SqliteDatastoreWrapper> journal
     ) :
-	DatastoreBulkOperationProgressWindow{ parent, api_key, universe_id, scope, key_prefix, datastore_names },
+	DatastoreBulkJournaledProgressWindow{ parent, api_key, universe_id, scope, key_prefix, datastore_names, journal.get() },
 	undelete_after{ undelete_after }
 {
 	setWindowTitle("Undelete Progress");
+
+	if (journal)
+	{
+		journal->write_journal_operation(SqliteJournalOperation::Undelete);
+		if (undelete_after)
+		{
+			// The cutoff is stored rather than the time range, so a resumed undelete restores the same entries
+			journal->write_journal_option(JOURNAL_OPTION_UNDELETE_AFTER, undelete_after->toString(Qt::ISODateWithMs).toStdString());
+		}
+		start_writer(std::move(journal));
+	}
+}
+
+DatastoreBulkUndeleteProgressWindow::DatastoreBulkUndeleteProgressWindow(QWidget* const parent, const QString& api_key, const long long universe_id, std::unique_ptr<SqliteDatastoreWrapper> journal) :
+	DatastoreBulkJournaledProgressWindow{ parent, api_key, universe_id, *journal }
+{
+	setWindowTitle("Undelete Progress");
+
+	if (const std::optional<std::string> opt_undelete_after = journal->get_journal_option(JOURNAL_OPTION_UNDELETE_AFTER))
+	{
+		const QDateTime parsed_undelete_after = QDateTime::fromString(QString::fromStdString(*opt_undelete_after), Qt::ISODateWithMs);
+		if (parsed_undelete_after.isValid())
+		{
+			undelete_after = parsed_undelete_after;
+		}
+	}
+
+	// The summary covers the whole undelete, not only the part done after resuming
+	std::map<std::string, size_t> outcome_counts = journal->get_outcome_counts(universe_id);
+	entries_restored = outcome_counts[OUTCOME_RESTORED];
+	entries_not_deleted = outcome_counts[OUTCOME_NOT_DELETED];
+	entries_no_old_version = outcome_counts[OUTCOME_NO_OLD_VERSION];
+	entries_not_in_time_range = outcome_counts[OUTCOME_NOT_IN_TIME_RANGE];
+	// Failed entries were left pending and are counted again when they are retried
+	const size_t entries_done = entries_restored + entries_not_deleted + entries_no_old_version + entries_not_in_time_range;
+	handle_status_message(QString{ "Continuing previous undelete, %1 entries were already done" }.arg(entries_done));
+
+	start_writer(std::move(journal));
 }
 
 QString DatastoreBulkUndeleteProgressWindow::progress_label_done() const
@@ -646,192 +1250,545 @@ QString DatastoreBulkUndeleteProgressWindow::progress_label_working(const size_t
 	return QString{ "Undeleting entry %1/%2..." }.arg(progress.get_current_entry_index() + 1).arg(total);
 }
 
-void DatastoreBulkUndeleteProgressWindow::send_next_entry_request()
+size_t DatastoreBulkUndeleteProgressWindow::get_entry_slot_count() const
+{
+	// Each stage gets the whole window, an entry keeps its slot while it waits for the next stage
+	return concurrency.get_window() * UNDELETE_STAGE_COUNT;
+}
+
+bool DatastoreBulkUndeleteProgressWindow::can_send_entry_request() const
 {
-	if (pending_entries.size() > 0)
+	if (DatastoreBulkJournaledProgressWindow::can_send_entry_request() == false)
 	{
-		StandardDatastoreEntryName entry = pending_entries.back();
-		pending_entries.pop_back();
+		return false;
+	}
+	// Stop scanning ahead once restores fall behind
+	const size_t window = concurrency.get_window();
+	return scan_stage.in_flight < window && entries_awaiting_fetch.size() < window;
+}
 
-		get_version_list_request = std::make_shared<StandardDatastoreEntryGetVersionListRequest>(api_key, universe_id, entry.get_datastore_name(), entry.get_scope(), entry.get_key());
-		get_version_list_request->set_http_429_count(http_429_count);
-		connect(get_version_list_request.get(), &StandardDatastoreEntryGetVersionListRequest::received_http_429, this, &DatastoreBulkUndeleteProgressWindow::handle_received_http_429);
-		connect(get_version_list_request.get(), &StandardDatastoreEntryGetVersionListRequest::status_error, this, &DatastoreBulkUndeleteProgressWindow::handle_error_message);
-		if (UserProfile::get().get_less_verbose_bulk_operations() == false)
-		{
-			connect(get_version_list_request.get(), &StandardDatastoreEntryGetVersionListRequest::status_info, this, &DatastoreBulkUndeleteProgressWindow::handle_status_message);
-		}
-		connect(get_version_list_request.get(), &StandardDatastoreEntryGetVersionListRequest::success, this, &DatastoreBulkUndeleteProgressWindow::handle_get_versions_response);
-		get_version_list_request->send_request();
+void DatastoreBulkUndeleteProgressWindow::send_entry_request(const StandardDatastoreEntryName& entry)
+{
+	begin_stage_request(scan_stage);
+
+	const auto get_version_list_request = std::make_shared<StandardDatastoreEntryGetVersionListRequest>(api_key, universe_id, entry.get_datastore_name(), entry.get_scope(), entry.get_key());
+	// Only the newest version and the newest one that is not deleted are needed, older pages are never used
+	get_version_list_request->set_stop_at_live_version(true);
+	StandardDatastoreEntryGetVersionListRequest* const raw_request = get_version_list_request.get();
+	connect(raw_request, &StandardDatastoreEntryGetVersionListRequest::success, this, [this, raw_request]() { handle_get_versions_response(raw_request); });
+	send_tracked_request(get_version_list_request);
+
+	handle_status_message(QString{ "Undeleting '%1'..." }.arg(entry.get_key()));
+}
 
-		handle_status_message(QString{ "Undeleting '%1'..." }.arg(entry.get_key()));
+void DatastoreBulkUndeleteProgressWindow::handle_entry_requests_done()
+{
+	handle_status_message("Undelete complete");
+	QString summary = QString{ "%1 entries restored, %2 already existed, %3 could not be restored" }.arg(entries_restored).arg(entries_not_deleted).arg(entries_no_old_version);
+	if (entries_not_in_time_range > 0)
+	{
+		summary = summary + QString{ ", %1 not in selected time range" }.arg(entries_not_in_time_range);
 	}
-	else
+	if (entries_errored > 0)
 	{
-		close_button->setText("Close");
-		handle_status_message("Undelete complete");
-		QString summary = QString{ "%1 entries restored, %2 already existed, %3 could not be restored" }.arg(entries_restored).arg(entries_not_deleted).arg(entries_no_old_version);
-		if (entries_not_in_time_range > 0)
-		{
-			summary = summary + QString{ ", %1 not in selected time range" }.arg(entries_not_in_time_range);
-		}
-		if (entries_errored > 0)
-		{
-			summary = summary + QString{ ", %1 errors" }.arg(entries_errored);
-		}
-		handle_status_message(summary);
+		summary = summary + QString{ ", %1 errors" }.arg(entries_errored);
 	}
+	handle_status_message(summary);
+	handle_status_message(QString{ "Undelete stages: %1 version lists, %2 version fetches, %3 posts (%4)" }.arg(scan_stage.done).arg(fetch_stage.done).arg(post_stage.done).arg(get_concurrency_detail()));
+	close_journal();
+}
+
+QString DatastoreBulkUndeleteProgressWindow::get_concurrency_detail() const
+{
+	return QString{ "scan %1/s, fetch %2/s, post %3/s" }
+		.arg(get_stage_rate(scan_stage), 0, 'f', 1)
+		.arg(get_stage_rate(fetch_stage), 0, 'f', 1)
+		.arg(get_stage_rate(post_stage), 0, 'f', 1);
+}
+
+void DatastoreBulkUndeleteProgressWindow::send_get_version_request(const RestorableEntry& restorable)
+{
+	begin_stage_request(fetch_stage);
+
+	const StandardDatastoreEntryName& entry = restorable.entry;
+	const auto get_version_request = std::make_shared<StandardDatastoreEntryGetVersionRequest>(api_key, universe_id, entry.get_datastore_name(), entry.get_scope(), entry.get_key(), restorable.version);
+	StandardDatastoreEntryGetVersionRequest* const raw_request = get_version_request.get();
+	connect(raw_request, &StandardDatastoreEntryGetVersionRequest::success, this, [this, raw_request]() { handle_get_entry_version_response(raw_request); });
+	send_tracked_request(get_version_request);
+}
+
+void DatastoreBulkUndeleteProgressWindow::send_post_request(const StandardDatastoreEntryFull& details)
+{
+	begin_stage_request(post_stage);
+
+	const auto post_entry_request = std::make_shared<StandardDatastoreEntryPostSetRequest>(api_key, universe_id, details.get_datastore_name(), details.get_scope(), details.get_key_name(), details.get_userids(), details.get_attributes(), details.get_data_raw());
+	StandardDatastoreEntryPostSetRequest* const raw_request = post_entry_request.get();
+	connect(raw_request, &StandardDatastoreEntryPostSetRequest::success, this, [this, raw_request]() { handle_post_entry_response(raw_request); });
+	send_tracked_request(post_entry_request);
 }
 
-void DatastoreBulkUndeleteProgressWindow::handle_get_versions_response()
+void DatastoreBulkUndeleteProgressWindow::advance_restore_stages()
 {
-	if (get_version_list_request)
+	// Later stages go first so entries that are nearly restored finish before more are started
+	const size_t window = concurrency.get_window();
+	while (post_stage.in_flight < window && entries_awaiting_post.size() > 0)
 	{
-		std::vector<StandardDatastoreEntryVersion> versions = get_version_list_request->get_versions();
-		const QString datastore_name = get_version_list_request->get_datastore_name();
-		const QString scope = get_version_list_request->get_scope();
-		const QString key_name = get_version_list_request->get_key_name();
-		get_version_list_request.reset();
+		const StandardDatastoreEntryFull details = entries_awaiting_post.front();
+		entries_awaiting_post.pop_front();
+		send_post_request(details);
+	}
+	while (fetch_stage.in_flight < window && entries_awaiting_fetch.size() > 0 && entries_awaiting_post.size() < window)
+	{
+		const RestorableEntry restorable = entries_awaiting_fetch.front();
+		entries_awaiting_fetch.pop_front();
+		send_get_version_request(restorable);
+	}
+}
 
-		std::sort(versions.begin(), versions.end(),
-			[](const StandardDatastoreEntryVersion& a, const StandardDatastoreEntryVersion& b)
-			{
-				return b.get_version() < a.get_version();
-			}
-		);
+void DatastoreBulkUndeleteProgressWindow::handle_get_versions_response(StandardDatastoreEntryGetVersionListRequest* const request)
+{
+	std::vector<StandardDatastoreEntryVersion> versions = request->get_versions();
+	const QString datastore_name = request->get_datastore_name();
+	const QString scope = request->get_scope();
+	const QString key_name = request->get_key_name();
+	const StandardDatastoreEntryName entry{ universe_id, datastore_name, key_name, scope };
+	release_tracked_request(request);
 
-		if (versions.size() == 0)
-		{
-			handle_status_message("No versions found, skipping");
-			entries_errored++;
-			progress.advance_entry_done();
-			send_next_entry_request();
-			return;
-		}
+	end_stage_request(scan_stage);
 
-		if (versions.front().get_deleted() == false)
+	std::sort(versions.begin(), versions.end(),
+		[](const StandardDatastoreEntryVersion& a, const StandardDatastoreEntryVersion& b)
 		{
-			handle_status_message("Not deleted, skipping");
-			entries_not_deleted++;
-			progress.advance_entry_done();
-			send_next_entry_request();
-			return;
+			return b.get_version() < a.get_version();
 		}
+	);
 
-		if (undelete_after)
+	if (versions.size() == 0)
+	{
+		handle_status_message("No versions found, skipping");
+		entries_errored++;
+		journal_outcome(entry, OUTCOME_FAILED, true);
+		finish_entry();
+		return;
+	}
+
+	if (versions.front().get_deleted() == false)
+	{
+		handle_status_message("Not deleted, skipping");
+		entries_not_deleted++;
+		journal_outcome(entry, OUTCOME_NOT_DELETED);
+		finish_entry();
+		return;
+	}
+
+	if (undelete_after)
+	{
+		const std::optional<QDateTime> opt_front_date = RobloxTime::parse_version_date(versions.front().get_created_time());
+		if (opt_front_date)
 		{
-			const std::optional<QDateTime> opt_front_date = RobloxTime::parse_version_date(versions.front().get_created_time());
-			if (opt_front_date)
+			if (*opt_front_date < *undelete_after)
 			{
-				if (*opt_front_date < *undelete_after)
-				{
-					handle_status_message("Deleted outside of selected time range, skipping");
-					entries_not_in_time_range++;
-					progress.advance_entry_done();
-					send_next_entry_request();
-					return;
-				}
-				else
-				{
-					// Advance
-				}
+				handle_status_message("Deleted outside of selected time range, skipping");
+				entries_not_in_time_range++;
+				journal_outcome(entry, OUTCOME_NOT_IN_TIME_RANGE);
+				finish_entry();
+				return;
 			}
 			else
 			{
-				handle_status_message("Failed to parse version timestamp, skipping");
-				entries_errored++;
-				progress.advance_entry_done();
-				send_next_entry_request();
-				return;
+				// Advance
 			}
 		}
+		else
+		{
+			handle_status_message("Failed to parse version timestamp, skipping");
+			entries_errored++;
+			journal_outcome(entry, OUTCOME_FAILED, true);
+			finish_entry();
+			return;
+		}
+	}
 
-		std::optional<StandardDatastoreEntryVersion> target_version;
-		for (const StandardDatastoreEntryVersion& this_version : versions)
+	std::optional<StandardDatastoreEntryVersion> target_version;
+	for (const StandardDatastoreEntryVersion& this_version : versions)
+	{
+		if (this_version.get_deleted() == false)
 		{
-			if (this_version.get_deleted() == false)
+			target_version = this_version;
+			break;
+		}
+	}
+
+	if (target_version.has_value() == false)
+	{
+		handle_status_message("No old version available, skipping");
+		entries_no_old_version++;
+		journal_outcome(entry, OUTCOME_NO_OLD_VERSION);
+		finish_entry();
+		return;
+	}
+
+	entries_awaiting_fetch.push_back(RestorableEntry{ entry, target_version->get_version() });
+	advance_restore_stages();
+	// The scan slot is free again
+	fill_entry_slots();
+}
+
+void DatastoreBulkUndeleteProgressWindow::handle_get_entry_version_response(StandardDatastoreEntryGetVersionRequest* const request)
+{
+	const std::optional<StandardDatastoreEntryFull> opt_details = request->get_details();
+	const StandardDatastoreEntryName entry{ universe_id, request->get_datastore_name(), request->get_key_name(), request->get_scope() };
+	release_tracked_request(request);
+
+	end_stage_request(fetch_stage);
+
+	if (opt_details.has_value() == false)
+	{
+		handle_status_message("Failed to fetch version, skipping");
+		entries_errored++;
+		journal_outcome(entry, OUTCOME_FAILED, true);
+		advance_restore_stages();
+		finish_entry();
+		return;
+	}
+
+	entries_awaiting_post.push_back(*opt_details);
+	advance_restore_stages();
+	fill_entry_slots();
+}
+
+void DatastoreBulkUndeleteProgressWindow::handle_post_entry_response(StandardDatastoreEntryPostSetRequest* const request)
+{
+	const bool success = request->req_success();
+	const StandardDatastoreEntryName entry{ universe_id, request->get_datastore_name(), request->get_key_name(), request->get_scope() };
+	release_tracked_request(request);
+
+	end_stage_request(post_stage);
+
+	if (success)
+	{
+		handle_status_message("Restore complete");
+		entries_restored++;
+		journal_outcome(entry, OUTCOME_RESTORED);
+	}
+	else
+	{
+		handle_status_message("Restore failed");
+		entries_errored++;
+		journal_outcome(entry, OUTCOME_FAILED, true);
+	}
+	advance_restore_stages();
+	finish_entry();
+}
+
+DatastoreBulkUploadProgressWindow::DatastoreBulkUploadProgressWindow(
+	QWidget* parent,
+	const QString& api_key,
+	long long universe_id,
+	std::unique_ptr<SqliteDatastoreWrapper> db_wrapper,
+	const bool resume,
+	std::unique_ptr<SqliteDatastoreWrapper> baseline_wrapper,
+	const bool dry_run) :
+	DatastoreBulkOperationProgressWindow{ parent, api_key, universe_id, "", "", std::vector<QString>{} },
+	skip_unchanged{ static_cast<bool>(baseline_wrapper) },
+	dry_run{ dry_run }
+{
+	setWindowTitle(dry_run ? "Upload Dry Run Progress" : "Upload Progress");
+
+	// Dumps from older versions have nowhere to store the checkpoint yet
+	db_wrapper->upgrade_schema();
+
+	long long after_row_id = 0;
+	if (resume)
+	{
+		after_row_id = db_wrapper->get_upload_checkpoint().value_or(0);
+	}
+	else if (dry_run == false)
+	{
+		db_wrapper->delete_upload_checkpoint();
+		db_wrapper->flush();
+	}
+
+	entry_reader = db_wrapper->get_entry_reader(after_row_id);
+	const size_t entry_count = db_wrapper->get_entry_count(entry_reader);
+	unloaded_entry_count = entry_count;
+	progress.set_entry_total(entry_count);
+	if (skip_unchanged == false)
+	{
+		// Only the first page is read up front, the rest is loaded by the writer thread as requests go out
+		const std::vector<StandardDatastoreEntryFull> first_page = db_wrapper->get_entries(entry_reader, UPLOAD_PAGE_SIZE);
+		add_loaded_entries(entry_reader.get_row_id(), first_page, 0, entry_reader.get_unreadable_count());
+	}
+
+	if (after_row_id > 0)
+	{
+		handle_status_message(QString{ "Continuing previous upload, %1 entries left" }.arg(entry_count));
+	}
+
+	db_writer = std::make_unique<SqliteDatastoreWriter>(std::move(db_wrapper), WRITER_QUEUE_CAPACITY);
+	// Signals arrive from the writer thread and are queued to this window
+	connect(db_writer.get(), &SqliteDatastoreWriter::closed, this, &DatastoreBulkUploadProgressWindow::handle_writer_closed);
+	connect(db_writer.get(), &SqliteDatastoreWriter::flushed, this, &DatastoreBulkUploadProgressWindow::handle_writer_flushed);
+
+	if (skip_unchanged)
+	{
+		// The baseline is hashed on the writer thread before any page is read, so every page can be checked against it
+		handle_status_message("Reading previous dump...");
+		db_writer->push_resume_point([this, baseline = std::shared_ptr<SqliteDatastoreWrapper>{ std::move(baseline_wrapper) }](SqliteDatastoreWrapper& db) {
+			db.delete_upload_manifest();
+			SqliteStoredEntryReader baseline_reader = baseline->get_entry_reader(0);
+			size_t baseline_count = 0;
+			while (baseline_reader.is_done() == false)
 			{
-				target_version = this_version;
-				break;
+				for (const StandardDatastoreEntryFull& this_entry : baseline->get_entries(baseline_reader, UPLOAD_PAGE_SIZE))
+				{
+					db.write_upload_manifest(this_entry);
+					baseline_count++;
+				}
+				db.resume_point();
 			}
-		}
+			QMetaObject::invokeMethod(this, [this, baseline_count]() {
+				handle_status_message(QString{ "Read %1 entries from previous dump" }.arg(baseline_count));
+			}, Qt::QueuedConnection);
+		});
+	}
+}
+
+DatastoreBulkUploadProgressWindow::UploadKey DatastoreBulkUploadProgressWindow::get_upload_key(const StandardDatastoreEntryName& entry)
+{
+	return UploadKey{ entry.get_universe_id(), entry.get_datastore_name(), entry.get_scope(), entry.get_key() };
+}
+
+QString DatastoreBulkUploadProgressWindow::progress_label_done() const
+{
+	return dry_run ? "Dry run complete" : "Upload complete";
+}
+
+QString DatastoreBulkUploadProgressWindow::progress_label_working(const size_t total) const
+{
+	if (dry_run)
+	{
+		return QString{ "Checking entry %1/%2..." }.arg(progress.get_current_entry_index() + 1).arg(total);
+	}
+	return QString{ "Uploading entry %1/%2..." }.arg(progress.get_current_entry_index() + 1).arg(total);
+}
+
+void DatastoreBulkUploadProgressWindow::send_entry_request(const StandardDatastoreEntryName& entry)
+{
+	const UploadKey upload_key = get_upload_key(entry);
+	const auto entry_it = loaded_entries.find(upload_key);
+	if (entry_it == loaded_entries.end())
+	{
+		OCTASSERT(false);
+		finish_entry();
+		return;
+	}
 
-		if (target_version.has_value() == false)
+	const StandardDatastoreEntryFull& details = entry_it->second.details;
+	const auto post_entry_request = std::make_shared<StandardDatastoreEntryPostSetRequest>(
+		api_key,
+		details.get_universe_id(),
+		details.get_datastore_name(),
+		details.get_scope(),
+		details.get_key_name(),
+		details.get_userids(),
+		details.get_attributes(),
+		details.get_data_raw()
+	);
+	StandardDatastoreEntryPostSetRequest* const raw_request = post_entry_request.get();
+	connect(raw_request, &StandardDatastoreEntryPostSetRequest::success, this, [this, raw_request, upload_key]() { handle_post_entry_response(raw_request, upload_key); });
+	send_tracked_request(post_entry_request);
+
+	handle_status_message(QString{ "Uploading '%1'..." }.arg(entry.get_key()));
+}
+
+void DatastoreBulkUploadProgressWindow::handle_entry_requests_done()
+{
+	QString summary;
+	if (dry_run)
+	{
+		// A dry run leaves the checkpoint of an earlier upload alone
+		summary = QString{ "Dry run complete: %1 entries would be written, %2 unchanged" }.arg(entries_would_upload).arg(entries_unchanged);
+	}
+	else
+	{
+		if (checkpoint.is_held() == false)
 		{
-			handle_status_message("No old version available, skipping");
-			entries_no_old_version++;
-			progress.advance_entry_done();
-			send_next_entry_request();
-			return;
+			// A finished upload starts over next time instead of offering to resume
+			db_writer->push_resume_point([](SqliteDatastoreWrapper& db) {
+				db.delete_upload_checkpoint();
+			});
 		}
-
-		get_version_request = std::make_shared<StandardDatastoreEntryGetVersionRequest>(api_key, universe_id, datastore_name, scope, key_name, target_version->get_version());
-		get_version_request->set_http_429_count(http_429_count);
-		connect(get_version_request.get(), &StandardDatastoreEntryGetVersionRequest::received_http_429, this, &DatastoreBulkUndeleteProgressWindow::handle_received_http_429);
-		connect(get_version_request.get(), &StandardDatastoreEntryGetVersionRequest::status_error, this, &DatastoreBulkUndeleteProgressWindow::handle_error_message);
-		if (UserProfile::get().get_less_verbose_bulk_operations() == false)
+		if (skip_unchanged)
 		{
-			connect(get_version_request.get(), &StandardDatastoreEntryGetVersionRequest::status_info, this, &DatastoreBulkUndeleteProgressWindow::handle_status_message);
+			summary = QString{ "%1 entries uploaded, %2 unchanged, %3 failed" }.arg(entries_uploaded).arg(entries_unchanged).arg(entries_errored);
 		}
-		connect(get_version_request.get(), &StandardDatastoreEntryGetVersionRequest::success, this, &DatastoreBulkUndeleteProgressWindow::handle_get_entry_version_response);
-		get_version_request->send_request();
+		else
+		{
+			summary = QString{ "%1 entries uploaded, %2 failed" }.arg(entries_uploaded).arg(entries_errored);
+		}
+	}
+	if (entries_unreadable > 0)
+	{
+		summary = summary + QString{ ", %1 could not be read from the file" }.arg(entries_unreadable);
 	}
+	handle_status_message(summary);
+	if (checkpoint.is_held())
+	{
+		handle_status_message("Resume the upload to try the failed entries again");
+	}
+	db_writer->close();
 }
 
-void DatastoreBulkUndeleteProgressWindow::handle_get_entry_version_response()
+void DatastoreBulkUploadProgressWindow::handle_paused()
 {
-	if (get_version_request)
+	db_writer->flush();
+}
+
+size_t DatastoreBulkUploadProgressWindow::get_unloaded_entry_count() const
+{
+	return unloaded_entry_count;
+}
+
+void DatastoreBulkUploadProgressWindow::load_more_entries()
+{
+	// Pending entries are taken from the back, so a new page is only added once the previous one is used up
+	// Otherwise the older page would wait until the end and hold the checkpoint back the whole time
+	if (pending_entries.size() == 0 && staged_page)
 	{
-		const std::optional<StandardDatastoreEntryFull> opt_details = get_version_request->get_details();
-		get_version_request.reset();
+		const StagedPage next_page = std::move(*staged_page);
+		staged_page.reset();
+		add_loaded_entries(next_page.last_row_id, next_page.entries, next_page.unchanged_count, next_page.unreadable_count);
+	}
 
-		if (opt_details.has_value() == false)
-		{
-			handle_status_message("Failed to fetch version, skipping");
-			entries_errored++;
-			progress.advance_entry_done();
-			send_next_entry_request();
-			return;
-		}
+	if (loading_entries || staged_page || entry_reader.is_done())
+	{
+		return;
+	}
+	loading_entries = true;
 
-		const QString datastore_name = opt_details->get_datastore_name();
-		const QString scope = opt_details->get_scope();
-		const QString key_name = opt_details->get_key_name();
-		const std::optional<QString> userids = opt_details->get_userids();
-		const std::optional<QString> attributes = opt_details->get_attributes();
-		const QString body = opt_details->get_data_raw();
-
-		post_entry_request = std::make_shared<StandardDatastoreEntryPostSetRequest>(api_key, universe_id, datastore_name, scope, key_name, userids, attributes, body);
-		post_entry_request->set_http_429_count(http_429_count);
-		connect(post_entry_request.get(), &StandardDatastoreEntryPostSetRequest::received_http_429, this, &DatastoreBulkUndeleteProgressWindow::handle_received_http_429);
-		connect(post_entry_request.get(), &StandardDatastoreEntryPostSetRequest::status_error, this, &DatastoreBulkUndeleteProgressWindow::handle_error_message);
-		if (UserProfile::get().get_less_verbose_bulk_operations() == false)
+	db_writer->push_read([this, reader = entry_reader, skip_unchanged = skip_unchanged](SqliteDatastoreWrapper& db) mutable {
+		std::vector<StandardDatastoreEntryFull> entries = db.get_entries(reader, UPLOAD_PAGE_SIZE);
+		size_t unchanged_count = 0;
+		if (skip_unchanged)
 		{
-			connect(post_entry_request.get(), &StandardDatastoreEntryPostSetRequest::status_info, this, &DatastoreBulkUndeleteProgressWindow::handle_status_message);
+			const auto is_unchanged = [&db](const StandardDatastoreEntryFull& entry) { return db.is_in_upload_manifest(entry); };
+			const auto unchanged_begin = std::remove_if(entries.begin(), entries.end(), is_unchanged);
+			unchanged_count = static_cast<size_t>(std::distance(unchanged_begin, entries.end()));
+			entries.erase(unchanged_begin, entries.end());
 		}
-		connect(post_entry_request.get(), &StandardDatastoreEntryPostSetRequest::success, this, &DatastoreBulkUndeleteProgressWindow::handle_post_entry_response);
-		post_entry_request->send_request();
-	}
+		QMetaObject::invokeMethod(this, [this, reader, entries = std::move(entries), unchanged_count]() {
+			handle_entries_loaded(reader, entries, unchanged_count);
+		}, Qt::QueuedConnection);
+	});
 }
 
-void DatastoreBulkUndeleteProgressWindow::handle_post_entry_response()
+void DatastoreBulkUploadProgressWindow::add_loaded_entries(const long long last_row_id, const std::vector<StandardDatastoreEntryFull>& entries, const size_t unchanged_count, const size_t unreadable_count)
 {
-	if (post_entry_request)
+	unloaded_entry_count = unloaded_entry_count - std::min(unloaded_entry_count, entries.size() + unchanged_count + unreadable_count);
+	if (entry_reader.is_done() && staged_page.has_value() == false)
 	{
-		const bool success = post_entry_request->req_success();
-		post_entry_request.reset();
+		// Nothing is left once the reader is done
+		unloaded_entry_count = 0;
+	}
 
-		if (success)
+	// Skipped entries are done as soon as they are read
+	entries_unchanged += unchanged_count;
+	entries_unreadable += unreadable_count;
+	for (size_t i = 0; i < unchanged_count + unreadable_count; i++)
+	{
+		progress.advance_entry_done();
+	}
+	if (unreadable_count > 0)
+	{
+		// The checkpoint still moves past these rows, a resumed upload would not try them again either
+		handle_error_message(QString{ "%1 entries could not be read from the file and were skipped" }.arg(unreadable_count));
+	}
+
+	if (dry_run)
+	{
+		// Nothing is sent, so the entries are counted here instead of going through pending_entries
+		entries_would_upload += entries.size();
+		for (size_t i = 0; i < entries.size(); i++)
 		{
-			handle_status_message("Restore complete");
-			entries_restored++;
+			progress.advance_entry_done();
 		}
-		else
+		update_ui();
+		return;
+	}
+
+	size_t page_entry_count = 0;
+	for (const StandardDatastoreEntryFull& this_entry : entries)
+	{
+		const StandardDatastoreEntryName this_name{ this_entry.get_universe_id(), this_entry.get_datastore_name(), this_entry.get_key_name(), this_entry.get_scope() };
+		if (loaded_entries.emplace(get_upload_key(this_name), UploadEntry{ this_entry, last_row_id }).second)
 		{
-			handle_status_message("Restore failed");
-			entries_errored++;
+			pending_entries.push_back(this_name);
+			page_entry_count++;
 		}
-		progress.advance_entry_done();
-		send_next_entry_request();
 	}
+	// Pages are always added, an empty one still moves the checkpoint past rows that could not be read or were unchanged
+	checkpoint.add_page(last_row_id, page_entry_count);
+	if (db_writer)
+	{
+		advance_checkpoint();
+	}
+}
+
+void DatastoreBulkUploadProgressWindow::advance_checkpoint()
+{
+	if (const std::optional<long long> checkpoint_row_id = checkpoint.advance())
+	{
+		db_writer->push_resume_point([row_id = *checkpoint_row_id](SqliteDatastoreWrapper& db) {
+			db.write_upload_checkpoint(row_id);
+		});
+	}
+}
+
+void DatastoreBulkUploadProgressWindow::handle_entries_loaded(const SqliteStoredEntryReader& reader, const std::vector<StandardDatastoreEntryFull>& entries, const size_t unchanged_count)
+{
+	loading_entries = false;
+	const size_t unreadable_count = reader.get_unreadable_count() - entry_reader.get_unreadable_count();
+	entry_reader = reader;
+	staged_page = StagedPage{ reader.get_row_id(), entries, unchanged_count, unreadable_count };
+	fill_entry_slots();
+}
+
+void DatastoreBulkUploadProgressWindow::handle_post_entry_response(StandardDatastoreEntryPostSetRequest* const request, const UploadKey& upload_key)
+{
+	const bool succeeded = request->req_success();
+	if (succeeded)
+	{
+		entries_uploaded++;
+	}
+	else
+	{
+		entries_errored++;
+	}
+	release_tracked_request(request);
+
+	const auto entry_it = loaded_entries.find(upload_key);
+	OCTASSERT(entry_it != loaded_entries.end());
+	if (entry_it != loaded_entries.end())
+	{
+		checkpoint.finish_entry(entry_it->second.page_row_id, succeeded);
+		loaded_entries.erase(entry_it);
+	}
+
+	advance_checkpoint();
+	finish_entry();
+}
+
+void DatastoreBulkUploadProgressWindow::handle_writer_closed()
+{
+	close_button->setText("Close");
+	if (dry_run == false)
+	{
+		handle_status_message("Upload complete");
+	}
+}
+
+void DatastoreBulkUploadProgressWindow::handle_writer_flushed()
+{
+	handle_status_message("Progress saved, the upload can be resumed from this point");
 }
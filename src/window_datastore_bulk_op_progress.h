@@ -2,9 +2,13 @@
 
 #include <cstddef>
 
+#include <chrono>
+#include <deque>
+#include <map>
 #include <memory>
 #include <optional>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include <QDateTime>
@@ -12,14 +16,18 @@
 #include <QString>
 #include <QWidget>
 
+#include "http_adaptive_concurrency.h"
 #include "model_common.h"
 #include "sqlite_wrapper.h"
+#include "sqlite_writer.h"
+#include "upload_checkpoint.h"
 
 class QLabel;
 class QProgressBar;
 class QPushButton;
+class QTimer;
 
-
+class DataRequest;
 class StandardDatastoreEntryDeleteRequest;
 class StandardDatastoreEntryGetDetailsRequest;
 class StandardDatastoreEntryGetListRequest;
@@ -38,30 +46,89 @@ public:
 	void start();
 
 protected:
+	// Datastore that is listed by one chain of cursors
+	class EnumerationCursor
+	{
+	public:
+		QString datastore_name;
+		// Empty until the first page has been read
+		std::optional<QString> cursor;
+	};
+
+	// One request of an operation that needs several in a row for each entry, different entries can be at different stages
+	class EntryStage
+	{
+	public:
+		size_t in_flight = 0;
+		size_t done = 0;
+	};
+
 	DatastoreBulkOperationProgressWindow(QWidget* parent, const QString& api_key, long long universe_id, const QString& find_scope, const QString& find_key_prefix, const std::vector<QString>& datastore_names);
 
 	virtual QString progress_label_done() const = 0;
 	virtual QString progress_label_working(size_t total) const = 0;
 
-	virtual void send_next_entry_request() = 0;
-
-	virtual bool is_retryable() const;
-	virtual bool do_retry();
+	virtual bool confirm_entry_requests();
+	// Entries that may be in progress at once, an entry that needs several requests in a row may hold a slot for each of them
+	virtual size_t get_entry_slot_count() const;
+	// Lets a subclass hold back new requests while it is still busy with earlier responses
+	virtual bool can_send_entry_request() const;
+	virtual void send_entry_request(const StandardDatastoreEntryName& entry) = 0;
+	virtual void handle_entry_requests_done() = 0;
+	// Called when every remaining request has failed and the operation waits for the user to retry
+	virtual void handle_paused() {}
+	// Entries that still wait to be loaded into pending_entries
+	virtual size_t get_unloaded_entry_count() const { return 0; }
+	// Called when pending_entries runs low, the subclass appends more and calls fill_entry_slots() once they are loaded
+	virtual void load_more_entries() {}
+	// When true, enumerated entries are only passed to handle_entry_found() and come back through load_more_entries()
+	virtual bool stores_found_entries() const { return false; }
+	// Appended to the concurrency line of the window
+	virtual QString get_concurrency_detail() const { return ""; }
+
+	bool is_retryable() const;
+	void do_retry();
 
 	void update_ui();
+	void update_concurrency_ui();
+
+	void send_enumerate_keys_requests();
+	void send_enumerate_keys_request(const EnumerationCursor& enumeration);
 
-	void send_next_enumerate_keys_request();
+	void begin_entry_requests();
+	void fill_entry_slots();
+	void finish_entry();
+
+	void send_tracked_request(const std::shared_ptr<DataRequest>& request);
+	void release_tracked_request(const DataRequest* request);
+
+	void begin_stage_request(EntryStage& stage);
+	void end_stage_request(EntryStage& stage);
+	// Completed requests per second since the first stage request was sent
+	double get_stage_rate(const EntryStage& stage) const;
 
 	void handle_clicked_retry();
 	void handle_error_message(QString message);
 	void handle_status_message(QString message);
-	void handle_enumerate_keys_success();
+	void handle_enumerate_keys_step(StandardDatastoreEntryGetListRequest* request, const std::string& cursor);
+	void handle_enumerate_keys_success(StandardDatastoreEntryGetListRequest* request);
 	void handle_received_http_429();
+	void handle_received_reply(qint64 latency_msecs);
+	void handle_received_enumerate_reply();
+	void handle_entry_enumerated(const StandardDatastoreEntryName& entry);
 
 	virtual void handle_entry_found(const StandardDatastoreEntryName&) {}
-	virtual void handle_enumerate_step(long long, const std::string&, const std::string&) {}
+	// Called with the cursor updated to the next page
+	virtual void handle_enumerate_step(const EnumerationCursor&) {}
 	virtual void handle_enumerate_done(long long, const std::string&) {}
 
+	class ActiveEnumeration
+	{
+	public:
+		std::shared_ptr<StandardDatastoreEntryGetListRequest> request;
+		EnumerationCursor enumeration;
+	};
+
 	class DownloadProgress
 	{
 	public:
@@ -70,7 +137,6 @@ protected:
 		bool is_enumerating() const;
 		bool is_done() const;
 
-		size_t get_current_datastore_index() const;
 		size_t get_current_entry_index() const;
 		size_t get_progress() const;
 
@@ -94,19 +160,34 @@ protected:
 	QString find_scope;
 	QString find_key_prefix;
 
-	std::optional<QString> initial_cursor;
+	// Cursors to continue from when a datastore is listed, only set when resuming
+	std::map<QString, QString> initial_cursors;
 
-	size_t http_429_count = 0;
+	// Entries are requested as soon as they are enumerated instead of after every datastore has been listed
+	bool pipelined = false;
+	// Set once confirm_entry_requests() has allowed the entries to be requested
+	bool entry_requests_started = false;
 
 	DownloadProgress progress;
 	std::vector<QString> datastore_names;
 
-	std::vector<StandardDatastoreEntryName> pending_entries;
+	// Datastores that wait for a free enumeration slot
+	std::deque<EnumerationCursor> pending_enumerations;
 
-	std::shared_ptr<StandardDatastoreEntryGetListRequest> enumerate_entries_request;
+	// Can hold millions of entries for a large datastore unless the subclass stores them, so names are kept in compact form
+	StandardDatastoreEntryNameList pending_entries;
+
+	AdaptiveConcurrencyController concurrency;
+	size_t entries_in_flight = 0;
+	std::optional<std::chrono::steady_clock::time_point> stages_started;
+
+	std::vector<ActiveEnumeration> enumerate_requests;
+	std::vector<std::shared_ptr<DataRequest>> entry_requests;
 
 	QLabel* progress_label = nullptr;
 	QProgressBar* progress_bar = nullptr;
+	QLabel* concurrency_label = nullptr;
+	QTimer* concurrency_ui_timer = nullptr;
 
 	TextLogWidget* text_log = nullptr;
 
@@ -114,7 +195,55 @@ protected:
 	QPushButton* close_button = nullptr;
 };
 
-class DatastoreBulkDeleteProgressWindow: public DatastoreBulkOperationProgressWindow
+// Keeps enumeration cursors, pending entries and outcomes in a database file so the operation can be resumed after it stops
+// Operations that are not journaled pass no database and keep all of their state in memory
+class DatastoreBulkJournaledProgressWindow : public DatastoreBulkOperationProgressWindow
+{
+	Q_OBJECT
+protected:
+	// Records the datastores to enumerate, the subclass calls start_writer() once it has written its own options
+	DatastoreBulkJournaledProgressWindow(QWidget* parent, const QString& api_key, long long universe_id, const QString& scope, const QString& key_prefix, const std::vector<QString>& datastore_names, SqliteDatastoreWrapper* db_wrapper);
+	// Restores the cursors and pending entries stored in the file, the subclass calls start_writer() once it has read its own options
+	DatastoreBulkJournaledProgressWindow(QWidget* parent, const QString& api_key, long long universe_id, SqliteDatastoreWrapper& db_wrapper);
+
+	virtual bool can_send_entry_request() const override;
+
+	virtual void handle_paused() override;
+	virtual size_t get_unloaded_entry_count() const override;
+	virtual void load_more_entries() override;
+	virtual bool stores_found_entries() const override;
+
+	virtual void handle_entry_found(const StandardDatastoreEntryName& name) override;
+	virtual void handle_enumerate_done(long long universe_id, const std::string& datastore_name) override;
+	virtual void handle_enumerate_step(const EnumerationCursor& enumeration) override;
+
+	// Entries that failed are left pending so a resumed operation tries them again
+	void journal_outcome(const StandardDatastoreEntryName& entry, const std::string& outcome, bool failed = false);
+	// Lets the user close the window once everything journaled is on disk
+	void close_journal();
+
+	void start_writer(std::unique_ptr<SqliteDatastoreWrapper> db_wrapper);
+
+	// Null when the operation is not journaled
+	std::unique_ptr<SqliteDatastoreWriter> db_writer;
+
+private:
+	void handle_entries_loaded(const SqlitePendingEntryReader& reader, StandardDatastoreEntryNameList entries);
+
+	void handle_writer_available();
+	void handle_writer_closed();
+	void handle_writer_flushed();
+
+	// Entries left over from a previous run and entries found while enumerating are loaded a page at a time
+	SqlitePendingEntryReader pending_reader;
+	size_t unloaded_entry_count = 0;
+	bool loading_entries = false;
+	// Entries found so far and when the last load was queued, later ones were not written yet when the load read the table
+	size_t entries_found = 0;
+	size_t entries_found_at_load = 0;
+};
+
+class DatastoreBulkDeleteProgressWindow : public DatastoreBulkJournaledProgressWindow
 {
 	Q_OBJECT
 public:
@@ -127,17 +256,30 @@ public:
 		const std::vector<QString>& datastore_names,
 		bool confirm_count_before_delete,
 		bool rewrite_before_delete,
-		bool hide_datastores_when_done
+		bool hide_datastores_when_done,
+		std::unique_ptr<SqliteDatastoreWrapper> journal
 	);
+	// Continues the delete journaled in the file with the options it was started with
+	DatastoreBulkDeleteProgressWindow(QWidget* parent, const QString& api_key, const std::shared_ptr<UniverseProfile>& universe, std::unique_ptr<SqliteDatastoreWrapper> journal);
 
 private:
 	virtual QString progress_label_done() const override;
 	virtual QString progress_label_working(size_t total) const override;
 
-	virtual void send_next_entry_request() override;
-	void handle_get_entry_response();
-	void handle_post_entry_response();
-	void handle_delete_entry_response();
+	virtual bool confirm_entry_requests() override;
+	virtual size_t get_entry_slot_count() const override;
+	virtual bool can_send_entry_request() const override;
+	virtual void send_entry_request(const StandardDatastoreEntryName& entry) override;
+	virtual void handle_entry_requests_done() override;
+	virtual QString get_concurrency_detail() const override;
+
+	void send_post_request(const StandardDatastoreEntryFull& details);
+	void send_delete_request(const QString& datastore_name, const QString& scope, const QString& key_name);
+	void advance_rewrite_stages();
+
+	void handle_get_entry_response(StandardDatastoreEntryGetDetailsRequest* request);
+	void handle_post_entry_response(StandardDatastoreEntryPostSetRequest* request);
+	void handle_delete_entry_response(StandardDatastoreEntryDeleteRequest* request);
 
 	QString get_summary() const;
 
@@ -145,18 +287,22 @@ private:
 
 	bool confirm_count_before_delete = true;
 	bool rewrite_before_delete = false;
-	bool hide_datastores_when_done = false;
-	bool first_delete_request_sent = false;
+	// Every datastore the delete was started with, a resumed delete only enumerates the ones that were not finished
+	std::vector<QString> datastores_to_hide;
+
+	// Gets are read requests and have their own rate limit, so they run ahead while earlier keys are posted and deleted
+	EntryStage get_stage;
+	EntryStage post_stage;
+	EntryStage delete_stage;
+	// Keys whose previous stage is done but whose next stage has no free slot yet
+	std::deque<StandardDatastoreEntryFull> entries_awaiting_post;
+	std::deque<StandardDatastoreEntryName> entries_awaiting_delete;
 
 	size_t entries_deleted = 0;
 	size_t entries_already_deleted = 0;
-
-	std::shared_ptr<StandardDatastoreEntryGetDetailsRequest> get_entry_request;
-	std::shared_ptr<StandardDatastoreEntryPostSetRequest> post_entry_request;
-	std::shared_ptr<StandardDatastoreEntryDeleteRequest> delete_entry_request;
 };
 
-class DatastoreBulkDownloadProgressWindow : public DatastoreBulkOperationProgressWindow
+class DatastoreBulkDownloadProgressWindow : public DatastoreBulkJournaledProgressWindow
 {
 	Q_OBJECT
 public:
@@ -167,42 +313,64 @@ private:
 	virtual QString progress_label_done() const override;
 	virtual QString progress_label_working(size_t total) const override;
 
-	virtual void send_next_entry_request() override;
-
-	virtual bool is_retryable() const override;
-	virtual bool do_retry() override;
-
-	void handle_entry_response();
-
-	virtual void handle_entry_found(const StandardDatastoreEntryName& name) override;
-	virtual void handle_enumerate_done(long long universe_id, const std::string& datastore_name) override;
-	virtual void handle_enumerate_step(long long universe_id, const std::string& datastore_name, const std::string& cursor) override;
-
-	std::unique_ptr<SqliteDatastoreWrapper> db_wrapper;
+	virtual void send_entry_request(const StandardDatastoreEntryName& entry) override;
+	virtual void handle_entry_requests_done() override;
 
-	std::shared_ptr<StandardDatastoreEntryGetDetailsRequest> get_entry_details_request;
+	void handle_entry_response(StandardDatastoreEntryGetDetailsRequest* request);
 };
 
-class DatastoreBulkUndeleteProgressWindow : public DatastoreBulkOperationProgressWindow
+class DatastoreBulkUndeleteProgressWindow : public DatastoreBulkJournaledProgressWindow
 {
 	Q_OBJECT
 public:
-	DatastoreBulkUndeleteProgressWindow(QWidget* parent, const QString& api_key, long long universe_id, const QString& scope, const QString& key_prefix, const std::vector<QString>& datastore_names, const std::optional<QDateTime>& undelete_after);
+	DatastoreBulkUndeleteProgressWindow(
+		QWidget* parent,
+		const QString& api_key,
+		long long universe_id,
+		const QString& scope,
+		const QString& key_prefix,
+		const std::vector<QString>& datastore_names,
+		const std::optional<QDateTime>& undelete_after,
+		std::unique_ptr<SqliteDatastoreWrapper> journal
+	);
+	// Continues the undelete journaled in the file with the options it was started with
+	DatastoreBulkUndeleteProgressWindow(QWidget* parent, const QString& api_key, long long universe_id, std::unique_ptr<SqliteDatastoreWrapper> journal);
 
 private:
+	// A deleted entry with an old version to restore
+	class RestorableEntry
+	{
+	public:
+		StandardDatastoreEntryName entry;
+		QString version;
+	};
+
 	virtual QString progress_label_done() const override;
 	virtual QString progress_label_working(size_t total) const override;
 
-	virtual void send_next_entry_request() override;
-	void handle_get_versions_response();
-	void handle_get_entry_version_response();
-	void handle_post_entry_response();
+	virtual size_t get_entry_slot_count() const override;
+	virtual bool can_send_entry_request() const override;
+	virtual void send_entry_request(const StandardDatastoreEntryName& entry) override;
+	virtual void handle_entry_requests_done() override;
+	virtual QString get_concurrency_detail() const override;
+
+	void send_get_version_request(const RestorableEntry& restorable);
+	void send_post_request(const StandardDatastoreEntryFull& details);
+	void advance_restore_stages();
+
+	void handle_get_versions_response(StandardDatastoreEntryGetVersionListRequest* request);
+	void handle_get_entry_version_response(StandardDatastoreEntryGetVersionRequest* request);
+	void handle_post_entry_response(StandardDatastoreEntryPostSetRequest* request);
 
 	std::optional<QDateTime> undelete_after;
 
-	std::shared_ptr<StandardDatastoreEntryGetVersionListRequest> get_version_list_request;
-	std::shared_ptr<StandardDatastoreEntryGetVersionRequest> get_version_request;
-	std::shared_ptr<StandardDatastoreEntryPostSetRequest> post_entry_request;
+	// Version lists, version fetches and posts each count against a different rate limit, so the stages run side by side
+	EntryStage scan_stage;
+	EntryStage fetch_stage;
+	EntryStage post_stage;
+	// Entries whose previous stage is done but whose next stage has no free slot yet
+	std::deque<RestorableEntry> entries_awaiting_fetch;
+	std::deque<StandardDatastoreEntryFull> entries_awaiting_post;
 
 	size_t entries_restored = 0;
 	size_t entries_not_deleted = 0;
@@ -210,3 +378,83 @@ private:
 	size_t entries_not_in_time_range = 0;
 	size_t entries_errored = 0;
 };
+
+class DatastoreBulkUploadProgressWindow : public DatastoreBulkOperationProgressWindow
+{
+	Q_OBJECT
+public:
+	// Continues after the checkpoint stored in the file when resume is set, otherwise uploads every entry
+	// Entries that match the baseline dump are skipped, a dry run only counts the entries that would be written
+	DatastoreBulkUploadProgressWindow(
+		QWidget* parent,
+		const QString& api_key,
+		long long universe_id,
+		std::unique_ptr<SqliteDatastoreWrapper> db_wrapper,
+		bool resume,
+		std::unique_ptr<SqliteDatastoreWrapper> baseline_wrapper,
+		bool dry_run
+	);
+
+private:
+	using UploadKey = std::tuple<long long, QString, QString, QString>;
+
+	class UploadEntry
+	{
+	public:
+		StandardDatastoreEntryFull details;
+		long long page_row_id;
+	};
+
+	// Read ahead of time, waits here until the entries before it have all been sent
+	class StagedPage
+	{
+	public:
+		long long last_row_id;
+		std::vector<StandardDatastoreEntryFull> entries;
+		// Read from the file but left out of entries because they match the baseline
+		size_t unchanged_count;
+		// Left out of entries because their row could not be decoded
+		size_t unreadable_count;
+	};
+
+	static UploadKey get_upload_key(const StandardDatastoreEntryName& entry);
+
+	virtual QString progress_label_done() const override;
+	virtual QString progress_label_working(size_t total) const override;
+
+	virtual void send_entry_request(const StandardDatastoreEntryName& entry) override;
+	virtual void handle_entry_requests_done() override;
+
+	virtual void handle_paused() override;
+	virtual size_t get_unloaded_entry_count() const override;
+	virtual void load_more_entries() override;
+
+	void add_loaded_entries(long long last_row_id, const std::vector<StandardDatastoreEntryFull>& entries, size_t unchanged_count, size_t unreadable_count);
+	void advance_checkpoint();
+	void handle_entries_loaded(const SqliteStoredEntryReader& reader, const std::vector<StandardDatastoreEntryFull>& entries, size_t unchanged_count);
+	void handle_post_entry_response(StandardDatastoreEntryPostSetRequest* request, const UploadKey& upload_key);
+
+	void handle_writer_closed();
+	void handle_writer_flushed();
+
+	std::unique_ptr<SqliteDatastoreWriter> db_writer;
+
+	bool skip_unchanged = false;
+	bool dry_run = false;
+
+	SqliteStoredEntryReader entry_reader;
+	// Includes the staged page, entries only count as loaded once they are in pending_entries
+	size_t unloaded_entry_count = 0;
+	bool loading_entries = false;
+	std::optional<StagedPage> staged_page;
+
+	std::map<UploadKey, UploadEntry> loaded_entries;
+	UploadCheckpointTracker checkpoint;
+
+	size_t entries_uploaded = 0;
+	size_t entries_unchanged = 0;
+	size_t entries_errored = 0;
+	size_t entries_unreadable = 0;
+	// Only counted during a dry run, those entries are never sent
+	size_t entries_would_upload = 0;
+};
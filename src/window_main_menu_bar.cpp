@@ -1,5 +1,7 @@
 #include "window_main_menu_bar.h"
 
+#include <cstddef>
+
 #include <string>
 
 #include <QtGlobal>
@@ -11,6 +13,7 @@
 #include <QString>
 #include <QStyleFactory>
 #include <QUrl>
+#include <QVariant>
 #include <QWidget>
 
 #include <sqlite3.h>
@@ -24,6 +27,8 @@ MyMainWindowMenuBar::MyMainWindowMenuBar(QMainWindow* parent) : QMenuBar{ parent
 {
 	connect(&(UserProfile::get()), &UserProfile::qt_theme_changed, this, &MyMainWindowMenuBar::handle_qt_theme_changed);
 	connect(&(UserProfile::get()), &UserProfile::autoclose_changed, this, &MyMainWindowMenuBar::handle_autoclose_changed);
+	connect(&(UserProfile::get()), &UserProfile::bulk_operation_concurrency_changed, this, &MyMainWindowMenuBar::handle_bulk_operation_concurrency_changed);
+	connect(&(UserProfile::get()), &UserProfile::http_log_capacity_changed, this, &MyMainWindowMenuBar::handle_http_log_capacity_changed);
 
 	QMenu* const file_menu = new QMenu{ "&File", this };
 	{
@@ -72,6 +77,44 @@ MyMainWindowMenuBar::MyMainWindowMenuBar(QMainWindow* parent) : QMenuBar{ parent
 		action_toggle_less_verbose_bulk->setChecked(UserProfile::get().get_less_verbose_bulk_operations());
 		connect(action_toggle_less_verbose_bulk, &QAction::triggered, this, &MyMainWindowMenuBar::pressed_toggle_less_verbose_bulk);
 
+		QMenu* const concurrency_menu = new QMenu{ "Bulk operation max &concurrency", preferences_menu };
+		{
+			for (const size_t this_concurrency : { 1, 2, 4, 8, 16, 32 })
+			{
+				QAction* const this_action = new QAction{ QString::number(this_concurrency), concurrency_menu };
+				this_action->setData(static_cast<qulonglong>(this_concurrency));
+				connect(this_action, &QAction::triggered, [this_concurrency]() {
+					UserProfile::get().set_bulk_operation_concurrency(this_concurrency);
+				});
+				concurrency_actions.push_back(this_action);
+				concurrency_menu->addAction(this_action);
+			}
+		}
+
+		action_toggle_bulk_http2 = new QAction{ "Use &HTTP/2 for bulk data operations", preferences_menu };
+		action_toggle_bulk_http2->setCheckable(true);
+		action_toggle_bulk_http2->setChecked(UserProfile::get().get_bulk_operation_http2());
+		connect(action_toggle_bulk_http2, &QAction::triggered, this, &MyMainWindowMenuBar::pressed_toggle_bulk_http2);
+
+		action_toggle_bulk_download_pipelined = new QAction{ "Download entries &while enumerating", preferences_menu };
+		action_toggle_bulk_download_pipelined->setCheckable(true);
+		action_toggle_bulk_download_pipelined->setChecked(UserProfile::get().get_bulk_download_pipelined());
+		connect(action_toggle_bulk_download_pipelined, &QAction::triggered, this, &MyMainWindowMenuBar::pressed_toggle_bulk_download_pipelined);
+
+		QMenu* const http_log_capacity_menu = new QMenu{ "HTTP &log size", preferences_menu };
+		{
+			for (const size_t this_capacity : { 1000, 10000, 100000, 1000000 })
+			{
+				QAction* const this_action = new QAction{ QString{ "%1 requests" }.arg(this_capacity), http_log_capacity_menu };
+				this_action->setData(static_cast<qulonglong>(this_capacity));
+				connect(this_action, &QAction::triggered, [this_capacity]() {
+					UserProfile::get().set_http_log_capacity(this_capacity);
+				});
+				http_log_capacity_actions.push_back(this_action);
+				http_log_capacity_menu->addAction(this_action);
+			}
+		}
+
 		action_toggle_datastore_name_filter = new QAction{ "Show datastore name &filter text box", preferences_menu };
 		action_toggle_datastore_name_filter->setCheckable(true);
 		action_toggle_datastore_name_filter->setChecked(UserProfile::get().get_show_datastore_name_filter());
@@ -81,6 +124,10 @@ MyMainWindowMenuBar::MyMainWindowMenuBar(QMainWindow* parent) : QMenuBar{ parent
 		preferences_menu->addSeparator();
 		preferences_menu->addAction(action_toggle_autoclose);
 		preferences_menu->addAction(action_toggle_less_verbose_bulk);
+		preferences_menu->addMenu(concurrency_menu);
+		preferences_menu->addAction(action_toggle_bulk_http2);
+		preferences_menu->addAction(action_toggle_bulk_download_pipelined);
+		preferences_menu->addMenu(http_log_capacity_menu);
 		preferences_menu->addAction(action_toggle_datastore_name_filter);
 	}
 
@@ -146,6 +193,8 @@ MyMainWindowMenuBar::MyMainWindowMenuBar(QMainWindow* parent) : QMenuBar{ parent
 	addMenu(tools_menu);
 	addMenu(about_menu);
 
+	handle_bulk_operation_concurrency_changed();
+	handle_http_log_capacity_changed();
 	handle_qt_theme_changed();
 }
 
@@ -159,6 +208,28 @@ void MyMainWindowMenuBar::handle_autoclose_changed()
 	}
 }
 
+void MyMainWindowMenuBar::handle_bulk_operation_concurrency_changed()
+{
+	const size_t concurrency = UserProfile::get().get_bulk_operation_concurrency();
+	for (QAction* const this_action : concurrency_actions)
+	{
+		const bool selected = this_action->data().toULongLong() == concurrency;
+		this_action->setCheckable(selected);
+		this_action->setChecked(selected);
+	}
+}
+
+void MyMainWindowMenuBar::handle_http_log_capacity_changed()
+{
+	const size_t capacity = UserProfile::get().get_http_log_capacity();
+	for (QAction* const this_action : http_log_capacity_actions)
+	{
+		const bool selected = this_action->data().toULongLong() == capacity;
+		this_action->setCheckable(selected);
+		this_action->setChecked(selected);
+	}
+}
+
 void MyMainWindowMenuBar::handle_qt_theme_changed()
 {
 	const QString& selected_theme = UserProfile::get().get_qt_theme();
@@ -190,6 +261,16 @@ void MyMainWindowMenuBar::pressed_toggle_autoclose()
 	UserProfile::get().set_autoclose_progress_window(action_toggle_autoclose->isChecked());
 }
 
+void MyMainWindowMenuBar::pressed_toggle_bulk_download_pipelined()
+{
+	UserProfile::get().set_bulk_download_pipelined(action_toggle_bulk_download_pipelined->isChecked());
+}
+
+void MyMainWindowMenuBar::pressed_toggle_bulk_http2()
+{
+	UserProfile::get().set_bulk_operation_http2(action_toggle_bulk_http2->isChecked());
+}
+
 void MyMainWindowMenuBar::pressed_toggle_datastore_name_filter()
 {
 	UserProfile::get().set_show_datastore_name_filter(action_toggle_datastore_name_filter->isChecked());
@@ -21,16 +21,24 @@ signals:
 
 private:
 	void handle_autoclose_changed();
+	void handle_bulk_operation_concurrency_changed();
+	void handle_http_log_capacity_changed();
 	void handle_qt_theme_changed();
 
 	void pressed_change_api_key();
 	void pressed_toggle_autoclose();
+	void pressed_toggle_bulk_download_pipelined();
+	void pressed_toggle_bulk_http2();
 	void pressed_toggle_datastore_name_filter();
 	void pressed_toggle_less_verbose_bulk();
 
 	std::vector<QAction*> theme_actions;
+	std::vector<QAction*> concurrency_actions;
+	std::vector<QAction*> http_log_capacity_actions;
 
 	QAction* action_toggle_autoclose = nullptr;
+	QAction* action_toggle_bulk_download_pipelined = nullptr;
+	QAction* action_toggle_bulk_http2 = nullptr;
 	QAction* action_toggle_datastore_name_filter = nullptr;
 	QAction* action_toggle_less_verbose_bulk = nullptr;
 };
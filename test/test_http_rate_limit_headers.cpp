@@ -0,0 +1,147 @@
+#include <chrono>
+#include <optional>
+
+#include <QList>
+#include <QNetworkReply>
+#include <QObject>
+#include <QTest>
+
+#include "http_rate_limit_headers.h"
+
+using Headers = QList<QNetworkReply::RawHeaderPair>;
+
+// Server clock for every fixture below, 2022-07-01 21:34:54 UTC
+static constexpr const char* SERVER_DATE = "Fri, 01 Jul 2022 21:34:54 GMT";
+static constexpr long long SERVER_DATE_EPOCH = 1656711294;
+
+class TestHttpRateLimitHeaders : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void retry_after_seconds()
+	{
+		const HttpRateLimitHeaders result = HttpRateLimitHeaders::parse(Headers{ { "Retry-After", "5" } });
+		QCOMPARE(result.get_retry_after(), std::optional<std::chrono::milliseconds>{ std::chrono::milliseconds{ 5000 } });
+		QCOMPARE(result.get_wait_time(true), std::optional<std::chrono::milliseconds>{ std::chrono::milliseconds{ 5000 } });
+		// Retry-After applies even when the reply was not a 429
+		QCOMPARE(result.get_wait_time(false), std::optional<std::chrono::milliseconds>{ std::chrono::milliseconds{ 5000 } });
+	}
+
+	void retry_after_fractional_seconds()
+	{
+		const HttpRateLimitHeaders result = HttpRateLimitHeaders::parse(Headers{ { "retry-after", "1.5" } });
+		QCOMPARE(result.get_retry_after(), std::optional<std::chrono::milliseconds>{ std::chrono::milliseconds{ 1500 } });
+	}
+
+	void retry_after_http_date()
+	{
+		const HttpRateLimitHeaders result = HttpRateLimitHeaders::parse(Headers{
+			{ "Date", SERVER_DATE },
+			{ "Retry-After", "Fri, 01 Jul 2022 21:35:04 GMT" },
+		});
+		QCOMPARE(result.get_retry_after(), std::optional<std::chrono::milliseconds>{ std::chrono::milliseconds{ 10000 } });
+	}
+
+	void retry_after_http_date_before_date()
+	{
+		const HttpRateLimitHeaders result = HttpRateLimitHeaders::parse(Headers{
+			{ "Date", SERVER_DATE },
+			{ "Retry-After", "Fri, 01 Jul 2022 21:34:50 GMT" },
+		});
+		QCOMPARE(result.get_retry_after(), std::optional<std::chrono::milliseconds>{ std::chrono::milliseconds{ 0 } });
+	}
+
+	void retry_after_http_date_without_date()
+	{
+		// Our own clock may be skewed, so a date is only trusted relative to the server's Date header
+		const HttpRateLimitHeaders result = HttpRateLimitHeaders::parse(Headers{ { "Retry-After", "Fri, 01 Jul 2022 21:35:04 GMT" } });
+		QVERIFY(result.get_retry_after().has_value() == false);
+		QVERIFY(result.get_wait_time(true).has_value() == false);
+	}
+
+	void multi_policy_values()
+	{
+		const HttpRateLimitHeaders result = HttpRateLimitHeaders::parse(Headers{
+			{ "x-ratelimit-limit", "300, 300;w=60, 3000;w=3600" },
+			{ "x-ratelimit-remaining", "0, 250;w=60, 2900;w=3600" },
+			{ "x-ratelimit-reset", "12, 40;w=60, 1800;w=3600" },
+		});
+		QCOMPARE(result.get_remaining(), std::optional<long long>{ 0 });
+		QCOMPARE(result.get_reset_after(), std::optional<std::chrono::milliseconds>{ std::chrono::milliseconds{ 12000 } });
+	}
+
+	void header_names_are_case_insensitive()
+	{
+		const HttpRateLimitHeaders result = HttpRateLimitHeaders::parse(Headers{
+			{ "X-RateLimit-Remaining", "7" },
+			{ "X-RATELIMIT-RESET", "3" },
+		});
+		QCOMPARE(result.get_remaining(), std::optional<long long>{ 7 });
+		QCOMPARE(result.get_reset_after(), std::optional<std::chrono::milliseconds>{ std::chrono::milliseconds{ 3000 } });
+	}
+
+	void reset_relative_seconds()
+	{
+		const HttpRateLimitHeaders result = HttpRateLimitHeaders::parse(Headers{ { "x-ratelimit-reset", "7" } });
+		QCOMPARE(result.get_reset_after(), std::optional<std::chrono::milliseconds>{ std::chrono::milliseconds{ 7000 } });
+	}
+
+	void reset_epoch_seconds()
+	{
+		const QByteArray reset_epoch = QByteArray::number(SERVER_DATE_EPOCH + 30);
+		const HttpRateLimitHeaders result = HttpRateLimitHeaders::parse(Headers{
+			{ "Date", SERVER_DATE },
+			{ "x-ratelimit-reset", reset_epoch },
+		});
+		QCOMPARE(result.get_reset_after(), std::optional<std::chrono::milliseconds>{ std::chrono::milliseconds{ 30000 } });
+	}
+
+	void reset_epoch_in_the_past()
+	{
+		const QByteArray reset_epoch = QByteArray::number(SERVER_DATE_EPOCH - 5);
+		const HttpRateLimitHeaders result = HttpRateLimitHeaders::parse(Headers{
+			{ "Date", SERVER_DATE },
+			{ "x-ratelimit-reset", reset_epoch },
+		});
+		QCOMPARE(result.get_reset_after(), std::optional<std::chrono::milliseconds>{ std::chrono::milliseconds{ 0 } });
+	}
+
+	void reset_epoch_without_date()
+	{
+		const QByteArray reset_epoch = QByteArray::number(SERVER_DATE_EPOCH + 30);
+		const HttpRateLimitHeaders result = HttpRateLimitHeaders::parse(Headers{ { "x-ratelimit-reset", reset_epoch } });
+		QVERIFY(result.get_reset_after().has_value() == false);
+	}
+
+	void remaining_exhausted_without_429()
+	{
+		const HttpRateLimitHeaders result = HttpRateLimitHeaders::parse(Headers{
+			{ "x-ratelimit-remaining", "0" },
+			{ "x-ratelimit-reset", "3" },
+		});
+		QCOMPARE(result.get_wait_time(false), std::optional<std::chrono::milliseconds>{ std::chrono::milliseconds{ 3000 } });
+	}
+
+	void remaining_available_without_429()
+	{
+		const HttpRateLimitHeaders result = HttpRateLimitHeaders::parse(Headers{
+			{ "x-ratelimit-remaining", "12" },
+			{ "x-ratelimit-reset", "3" },
+		});
+		QVERIFY(result.get_wait_time(false).has_value() == false);
+		// A 429 means the budget is spent no matter what the remaining count said
+		QCOMPARE(result.get_wait_time(true), std::optional<std::chrono::milliseconds>{ std::chrono::milliseconds{ 3000 } });
+	}
+
+	void no_headers()
+	{
+		const HttpRateLimitHeaders result = HttpRateLimitHeaders::parse(Headers{});
+		QVERIFY(result.get_wait_time(true).has_value() == false);
+		QVERIFY(result.get_wait_time(false).has_value() == false);
+	}
+};
+
+QTEST_APPLESS_MAIN(TestHttpRateLimitHeaders)
+
+#include "test_http_rate_limit_headers.moc"
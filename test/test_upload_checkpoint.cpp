@@ -0,0 +1,101 @@
+#include <optional>
+
+#include <QObject>
+#include <QTest>
+
+#include "upload_checkpoint.h"
+
+class TestUploadCheckpoint : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void moves_past_finished_pages()
+	{
+		UploadCheckpointTracker tracker;
+		tracker.add_page(10, 2);
+		tracker.add_page(20, 1);
+		QCOMPARE(tracker.advance(), std::optional<long long>{});
+
+		tracker.finish_entry(10, true);
+		tracker.finish_entry(10, true);
+		QCOMPARE(tracker.advance(), std::optional<long long>{ 10 });
+
+		tracker.finish_entry(20, true);
+		QCOMPARE(tracker.advance(), std::optional<long long>{ 20 });
+		QCOMPARE(tracker.advance(), std::optional<long long>{});
+		QVERIFY(tracker.is_held() == false);
+	}
+
+	void waits_for_earlier_pages()
+	{
+		UploadCheckpointTracker tracker;
+		tracker.add_page(10, 1);
+		tracker.add_page(20, 1);
+
+		// Requests finish out of order, a later page that is done does not move the checkpoint on its own
+		tracker.finish_entry(20, true);
+		QCOMPARE(tracker.advance(), std::optional<long long>{});
+
+		tracker.finish_entry(10, true);
+		QCOMPARE(tracker.advance(), std::optional<long long>{ 20 });
+	}
+
+	void empty_page_moves_checkpoint()
+	{
+		UploadCheckpointTracker tracker;
+		tracker.add_page(10, 0);
+		QCOMPARE(tracker.advance(), std::optional<long long>{ 10 });
+	}
+
+	void failed_entry_holds_checkpoint()
+	{
+		UploadCheckpointTracker tracker;
+		tracker.add_page(10, 1);
+		tracker.add_page(20, 2);
+		tracker.add_page(30, 1);
+
+		tracker.finish_entry(10, true);
+		tracker.finish_entry(20, true);
+		tracker.finish_entry(20, false);
+		tracker.finish_entry(30, true);
+		// The checkpoint stops after the last page that fully succeeded
+		QCOMPARE(tracker.advance(), std::optional<long long>{ 10 });
+		QVERIFY(tracker.is_held());
+
+		// Pages after the failed one never move it again
+		tracker.add_page(40, 0);
+		QCOMPARE(tracker.advance(), std::optional<long long>{});
+	}
+
+	void failed_entry_in_first_page()
+	{
+		UploadCheckpointTracker tracker;
+		tracker.add_page(10, 1);
+		tracker.add_page(20, 1);
+
+		tracker.finish_entry(20, true);
+		tracker.finish_entry(10, false);
+		QCOMPARE(tracker.advance(), std::optional<long long>{});
+		QVERIFY(tracker.is_held());
+	}
+
+	void failed_page_waits_until_done()
+	{
+		UploadCheckpointTracker tracker;
+		tracker.add_page(10, 2);
+
+		// The checkpoint is only held once the failed page has no requests left
+		tracker.finish_entry(10, false);
+		QCOMPARE(tracker.advance(), std::optional<long long>{});
+		QVERIFY(tracker.is_held() == false);
+
+		tracker.finish_entry(10, true);
+		QCOMPARE(tracker.advance(), std::optional<long long>{});
+		QVERIFY(tracker.is_held());
+	}
+};
+
+QTEST_APPLESS_MAIN(TestUploadCheckpoint)
+
+#include "test_upload_checkpoint.moc"